@@ -1,17 +1,23 @@
 #pragma once
 
-#include <iostream>
-
 #include "instructions.hpp"
 #include "state.hpp"
 #include "lcd_ctrl.hpp"
 #include "config.hpp"
 #include "interrupts.hpp"
+#include "timer.hpp"
+
+#if !GB_FREESTANDING
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#endif
 
-static void execute() {
+static GB_DEVICE void execute() {
     
 }
 
+#if !GB_FREESTANDING
 static void do_debug_stuff(state_t &s) {
             // printf("pc: %04x, %02x(%02x%02x)\n", s.pc, read_u8(s, s.pc), read_u8(s, s.pc + 1), read_u8(s, s.pc + 2));
             printf("A: %02X F: %02X B: %02X C: %02X D: %02X E: %02X H: %02X L: %02X SP: %02X PC: 00:%04X (%02X %02X %02X %02X)\n", 
@@ -44,131 +50,214 @@ static void print_debug(state_t &s) {
     char half = (s.regs.half_carry) ? 'H' : '-';
     char carr = (s.regs.carry) ? 'C' : '-';
     printf("F: [%c%c%c%c]\n", zero, nega, half, carr);
-    printf("T-cycle: %d\n", s.cycles);
+    printf("T-cycle: %llu\n", (unsigned long long)s.cycles);
 }
 
-void timer_cycle(state_t &s) {
-    s.divider_counter += 1;
-    if (s.divider_counter >= 256) {
-        s.divider_counter -= 256;
-        uint8_t div = read_u8(s, DIV);
-        div += 1;
-        write_u8(s, DIV, div);
+static void print_fault(state_t &s) {
+    if (s.fault) {
+        printf("Error: Instruction not implemented: %02x at %04x\n", s.fault_opcode, s.fault_pc);
     }
+}
+#endif
 
-    if (s.timer_enable) {
-        s.timer_counter += 1;
-        if (s.timer_counter >= s.timer_tac)
-        {
-            s.timer_counter = 0;
-
-            uint8_t tima = read_u8(s, TIMA);
-            tima += 1;
-            // printf("tima: %d\n", tima);
-            if (tima == 0) {
-                tima = read_u8(s, TMA);
-                // printf("triggering timer interrupt\n");
-                interrupt_trigger(s, Int::TIMER);
-            }
-            write_u8(s, TIMA, tima);
-        }
+// Stops on an opcode the core doesn't implement. The host reads the
+// details from the state, e.g. with print_fault().
+static GB_DEVICE void cpu_fault(state_t &s, uint8_t opcode) {
+    s.fault = true;
+    s.fault_opcode = opcode;
+    s.fault_pc = s.pc;
+    s.stop = true;
+}
+
+template <typename ppu = ppu_fast>
+static GB_DEVICE void dispatch_event(state_t &s, uint8_t id, uint64_t at) {
+    switch (id)
+    {
+    case ev::LCD:
+        lcd_event<ppu>(s, at);
+        break;
+    case ev::TIMER:
+        timer_event(s, at);
+        break;
+    case ev::DMA:
+        dma_event(s, at);
+        break;
+    case ev::APU:
+        apu_event(s, at);
+        break;
+    case ev::JOYPAD:
+        joypad_event(s, at);
+        break;
+    case ev::SERIAL:
+        serial_event(s, at);
+        break;
     }
 }
 
-static void step(state_t &s) {
-    s.cycles += 1;
+template <typename ppu = ppu_fast>
+static GB_DEVICE void run_events(state_t &s) {
+    while (s.cycles >= s.sched.next) {
+        uint64_t at;
+        uint8_t id = sched_pop(s.sched, at);
 
-    lcd_cycle(s);
-    timer_cycle(s);
+        dispatch_event<ppu>(s, id, at);
+        sched_update(s.sched);
+    }
+}
+
+// Runs one instruction, interrupt dispatch or stretch of HALT and advances
+// the clock by its length. Events that fall inside it are handled at the
+// start of the next call, before the next instruction can observe them.
+// `ppu` selects the PPU accuracy policy (ppu_fast or ppu_fifo).
+template <typename ppu = ppu_fast>
+static GB_DEVICE void step(state_t &s) {
+    if (s.cycles >= s.sched.next) {
+        run_events<ppu>(s);
+    }
 
-    interrupts_handle(s);
+    // HDMA and the speed switch hold the CPU off the bus
+    if (s.cpu_stall) {
+        s.inst_cycles_wait = s.cpu_stall;
+        s.cycles += s.cpu_stall;
+        s.cpu_stall = 0;
+        return;
+    }
 
-    s.inst_cycles_wait -= 1;
-    if (s.inst_cycles_wait <= 0)
-    {
-        if (s.halt) {
-            s.inst_cycles_wait = 4;
-            return;
+    if (s.int_pending && interrupts_handle(s)) {
+        s.cycles += s.inst_cycles_wait;
+        return;
+    }
+
+    if (s.halt) {
+        // only an event can raise an interrupt, so sleep until the next one
+        // in whole M-cycles
+        uint64_t idle = 4;
+        if (s.sched.next != SCHED_NEVER && s.sched.next > s.cycles) {
+            idle = (s.sched.next - s.cycles + 3) & ~3ull;
         }
+        s.cycles += idle;
+        return;
+    }
 
-        _inst_t opcode = read_u8(s, s.pc);
-        auto inst = instructions[opcode];
+    _inst_t opcode = read_u8(s, s.pc);
+    auto inst = instructions[opcode];
 
-        if (inst.execute != nullptr) {
-            
-            if (inst.length == 2) {
-                s.operand = read_u8(s, s.pc + 1);
-            }
-            else if (inst.length == 3) {
-                s.operand = read_u16(s, s.pc + 1);
-            }
+    if (inst.execute != nullptr) {
+        
+        if (inst.length == 2) {
+            s.operand = read_u8(s, s.pc + 1);
+        }
+        else if (inst.length == 3) {
+            s.operand = read_u16(s, s.pc + 1);
+        }
 
-            // do_debug_stuff(s);
+        // do_debug_stuff(s);
 
-            s.pc += inst.length;
-            s.inst_cycles_wait = inst.cycles;
+        s.pc += inst.length;
+        s.branch_taken = false;
 
-            inst.execute(s);
+        inst.execute(s);
 
-            if (s.prefixed) {
-                opcode = read_u8(s, s.pc);
-                inst = bcinstructions[opcode];
-                inst.execute(s);
-                s.inst_cycles_wait += inst.cycles;
-                s.pc++;
-                s.prefixed = false;
-            }
-        }
-        else {
-            printf("Error: Instruction not implemented: %02x\n", opcode);
-            s.stop = true;
+        const inst_timing_t &timing = inst_timings[opcode];
+        s.inst_cycles_wait = s.branch_taken ? timing.cycles_branch : timing.cycles;
+
+        if (s.prefixed) {
+            opcode = read_u8(s, s.pc);
+            inst = bcinstructions[opcode];
+            inst.execute(s);
+            // CB timings already include the prefix fetch
+            s.inst_cycles_wait = cb_inst_timings[opcode].cycles;
+            s.pc++;
+            s.prefixed = false;
         }
+        s.cycles += s.inst_cycles_wait;
+        s.num_inst++;
+    }
+    else {
+        cpu_fault(s, opcode);
     }
 }
 
-static void initialize_state(state_t* &s, uint8_t *rom) {
-    s = (state_t*)malloc(sizeof(state_t));
+// Steps until `end` or until the CPU stops. This is the whole per-instance
+// body of a grid launch, see grid.hpp.
+template <typename ppu = ppu_fast>
+static GB_DEVICE void run_until(state_t &s, uint64_t end) {
+    while (s.cycles < end && !s.stop) {
+        step<ppu>(s);
+    }
+}
 
-    memset(&s->regs, 0, sizeof(registers_t));
+// Post-boot state for `rom`. `mem` is the 64KB address space, owned by the
+// caller like everything else the core touches.
+static GB_DEVICE void state_init(state_t &s, uint8_t *mem, const uint8_t *rom) {
+    memset(&s.regs, 0, sizeof(registers_t));
 
-    s->pc = 0x100;
+    s.pc = 0x100;
 #if USE_BOOTROM
-    s->pc = 0;
+    s.pc = 0;
+#endif
+    s.halt = false;
+    s.stop = false;
+    s.fault = false;
+    s.fault_opcode = 0;
+    s.fault_pc = 0;
+    s.cycles = 0;
+    s.clock_shift = 0;
+    s.cpu_stall = 0;
+    s.inst_cycles_wait = 0;
+    s.prefixed = false;
+    s.branch_taken = false;
+    s.bus_hook = nullptr;
+    s.bus_ctx = nullptr;
+    s.interrupts_enabled = false;
+    s.int_flag = 0;
+    s.int_enable = 0;
+    s.int_pending = 0;
+    s.rom_size = (1<<15) << rom[0x0148];
+    s.mem = mem;
+
+    // no MBC, only the first two banks are visible
+    memcpy(s.mem, rom, s.rom_size < 0x8000 ? s.rom_size : 0x8000);
+    cgb_init(s, rom);
+    mem_map_update(s);
+    sched_init(s.sched);
+    lcd_init(s);
+    timer_init(s);
+    dma_init(s);
+    apu_init(s);
+    joypad_init(s);
+    serial_init(s);
+
+    s.regs.af = 0x01b0;
+    if (s.cgb.enabled) {
+        s.regs.a = 0x11;
+    }
+    s.regs.bc = 0x0013;
+    s.regs.de = 0x00d8;
+    s.regs.hl = 0x014d;
+    s.regs.sp = 0xfffe;
+
+    write_u8(s, TIMA, 0x00);
+    write_u8(s, TMA,  0x00);
+    write_u8(s, TAC,  0x00);
+    write_u8(s, LCDC, 0x91);
+    write_u8(s, SCY,  0x00);
+    write_u8(s, SCX,  0x00);
+    write_u8(s, LYC,  0x00);
+    write_u8(s, BGP,  0xfc);
+    write_u8(s, OBP0, 0xff);
+    write_u8(s, OBP1, 0xff);
+    write_u8(s, WY,   0x00);
+    write_u8(s, WX,   0x00);
+    write_u8(s, IE,   0x00);
+
+    s.breakp = false;
+    s.num_inst = 0;
+}
+
+#if !GB_FREESTANDING
+static void initialize_state(state_t* &s, uint8_t *rom) {
+    s = (state_t*)malloc(sizeof(state_t));
+    state_init(*s, (uint8_t *)malloc(0x10000), rom);
+}
 #endif
-    s->halt = false;
-    s->stop = false;
-    s->cycles = 0;
-    s->inst_cycles_wait = 0;
-    s->prefixed = false;
-    s->rom_size = (1<<15) << rom[0x0148];
-    s->mem = (uint8_t *)malloc(0x10000);
-
-    s->timer_tac = 1024;
-    memcpy(s->mem, rom, s->rom_size);
-
-    memset(&s->regs, 0, sizeof(register_t));
-    lcd_init(*s);
-
-    s->regs.af = 0x01b0;
-    s->regs.bc = 0x0013;
-    s->regs.de = 0x00d8;
-    s->regs.hl = 0x014d;
-    s->regs.sp = 0xfffe;
-
-    write_u8(*s, TIMA, 0x00);
-    write_u8(*s, TMA,  0x00);
-    write_u8(*s, TAC,  0x00);
-    write_u8(*s, LCDC, 0x91);
-    write_u8(*s, SCY,  0x00);
-    write_u8(*s, SCX,  0x00);
-    write_u8(*s, LYC,  0x00);
-    write_u8(*s, BGP,  0xfc);
-    write_u8(*s, OBP0, 0xff);
-    write_u8(*s, OBP1, 0xff);
-    write_u8(*s, WY,   0x00);
-    write_u8(*s, WX,   0x00);
-    write_u8(*s, IE,   0x00);
-
-    s->breakp = false;
-    s->num_inst = 0;
-}
\ No newline at end of file
@@ -0,0 +1,622 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "state.hpp"
+#include "sched.hpp"
+#include "timer.hpp"
+
+// Four-channel APU. The frame sequencer (length, sweep, envelope) is the
+// only scheduled event, at 512 Hz on the falling edge of divider bit 12.
+// Waveforms are not sampled per output sample: apu_sync() walks each
+// channel from one waveform step to the next and, whenever its level
+// changes, adds a band-limited step (BLEP) into a delta buffer. Every 8
+// sequencer steps the buffer is integrated into int16 samples and pushed
+// into the host's ring in one go.
+
+#define APU_CLOCK       4194304
+#define APU_SEQ_CYCLES  8192
+#define APU_FLUSH_STEPS 8
+
+// bit 7 is the first step
+static GB_TABLE const uint8_t apu_duty[4] = {0x01, 0x81, 0x87, 0x7e};
+
+static GB_TABLE const uint8_t apu_noise_div[8] = {8, 16, 32, 48, 64, 80, 96, 112};
+
+// bits that read back as 1, NR10 to NR52
+static GB_TABLE const uint8_t apu_read_mask[NR52 - NR10 + 1] = {
+    0x80, 0x3f, 0x00, 0xff, 0xbf,
+    0xff, 0x3f, 0x00, 0xff, 0xbf,
+    0x7f, 0xff, 0x9f, 0xff, 0xbf,
+    0xff, 0xff, 0x00, 0x00, 0xbf,
+    0x00, 0x00, 0x70,
+};
+
+// NRx1 for the length counter, NRx2 for the envelope
+static GB_TABLE const uint16_t apu_nrx1[APU_CHANNELS] = {NR11, NR21, NR31, NR41};
+static GB_TABLE const uint16_t apu_nrx2[APU_CHANNELS] = {NR12, NR22, NR30, NR42};
+
+// Blackman-windowed sinc, one row per sub-sample phase, normalized so each
+// row sums to one. Integrating the deltas gives band-limited steps. Row p,
+// tap t is sinc(0.9 x) * window(x / 16) for x = t - 8 - p / 32, precomputed
+// so the core needs no libm and no mutable globals.
+static GB_TABLE const float apu_blep[APU_BLEP_PHASES][APU_BLEP_TAPS] = {
+    {3.24576082e-19f, 0.000538189488f, -0.00335270609f, 0.0109560136f, -0.0257331431f, 0.0476232953f, -0.0723680034f, 0.092318356f, 0.900036156f, 0.092318356f, -0.0723680034f, 0.0476232953f, -0.0257331431f, 0.0109560136f, -0.00335270609f, 0.000538189488f},
+    {-3.52905147e-07f, 0.000531477504f, -0.00329713942f, 0.0105777159f, -0.0242579486f, 0.0433682017f, -0.0618126169f, 0.0645976141f, 0.898810685f, 0.121279769f, -0.0828254595f, 0.0516715236f, -0.0270597581f, 0.0112570832f, -0.00337834633f, 0.00053750322f},
+    {-1.543346e-06f, 0.000518265238f, -0.00321442983f, 0.0101301474f, -0.0226541981f, 0.0389506333f, -0.0512466282f, 0.0382093936f, 0.895141363f, 0.151380941f, -0.0930945352f, 0.0554683432f, -0.0282181632f, 0.0114732683f, -0.00337140728f, 0.000528543838f},
+    {-3.74014712e-06f, 0.000499459158f, -0.00310744741f, 0.00962144975f, -0.0209420472f, 0.0344143473f, -0.0407535769f, 0.0132358763f, 0.889047146f, 0.182512179f, -0.103082016f, 0.0589693338f, -0.0291892551f, 0.0115972767f, -0.00332939671f, 0.000510472804f},
+    {-7.07062463e-06f, 0.000475960871f, -0.00297911302f, 0.00905986689f, -0.01914162f, 0.0298021808f, -0.0304127838f, -0.0102506839f, 0.880559742f, 0.214555591f, -0.112692587f, 0.0621306039f, -0.0299546868f, 0.0116222873f, -0.00325002591f, 0.000482503267f},
+    {-1.16172805e-05f, 0.000448655337f, -0.00283236569f, 0.00845366064f, -0.0172728281f, 0.0251557212f, -0.0202989504f, -0.032188192f, 0.869722784f, 0.247385666f, -0.121829391f, 0.064909175f, -0.0304970574f, 0.0115420381f, -0.0031312455f, 0.000443915225f},
+    {-1.74153156e-05f, 0.000418400043f, -0.00267013139f, 0.00781103829f, -0.0153552201f, 0.0205150265f, -0.0104818083f, -0.0525249168f, 0.856592596f, 0.28087002f, -0.130394757f, 0.0672634467f, -0.0308001451f, 0.0113509288f, -0.00297128852f, 0.000394071016f},
+    {-2.44509629e-05f, 0.000386014348f, -0.00249529025f, 0.00714007067f, -0.0134078041f, 0.0159183405f, -0.00102576974f, -0.0712196007f, 0.841236949f, 0.31487f, -0.138290778f, 0.0691535696f, -0.0308490898f, 0.0110441055f, -0.00276870537f, 0.0003324305f},
+    {-3.26606823e-05f, 0.000352270348f, -0.00231064809f, 0.00644861814f, -0.0114489021f, 0.0114018433f, 0.00801032688f, -0.0882414132f, 0.823734224f, 0.349241346f, -0.145419955f, 0.070541814f, -0.0306305848f, 0.0106175439f, -0.00252239895f, 0.000258565822f},
+    {-4.19312455e-05f, 0.000317885861f, -0.00211891346f, 0.00574427657f, -0.00949603505f, 0.00699945679f, 0.0165734328f, -0.103570007f, 0.804174125f, 0.383835077f, -0.151685998f, 0.0713930279f, -0.0301331021f, 0.0100681493f, -0.00223166496f, 0.000172176646f},
+    {-5.21006914e-05f, 0.000283517205f, -0.0019226732f, 0.005034314f, -0.0075657987f, 0.0027426444f, 0.0246164538f, -0.11719536f, 0.782656312f, 0.418498486f, -0.156994477f, 0.0716750771f, -0.0293470602f, 0.00939382613f, -0.00189622119f, 7.31039254e-05f},
+    {-6.296012e-05f, 0.000249754288f, -0.00172437285f, 0.00432562036f, -0.00567375263f, -0.00133974932f, 0.0320983864f, -0.129117593f, 0.759289801f, 0.453075677f, -0.161253527f, 0.0713591799f, -0.028265005f, 0.00859356299f, -0.00151623983f, -3.86569918e-05f},
+    {-7.42563716e-05f, 0.000217116234f, -0.00152629882f, 0.00362466089f, -0.00383433956f, -0.00522162579f, 0.0389843583f, -0.139346734f, 0.734192431f, 0.487408668f, -0.16437456f, 0.0704203025f, -0.0268817898f, 0.00766749028f, -0.00109237502f, -0.000162944081f},
+    {-8.56954866e-05f, 0.000186048899f, -0.00133056473f, 0.00293743983f, -0.00206080452f, -0.0088797342f, 0.0452456661f, -0.147902414f, 0.707490087f, 0.521338284f, -0.166272953f, 0.0688375309f, -0.025194712f, 0.0066169519f, -0.000625787303f, -0.000299417734f},
+    {-9.6947042e-05f, 0.000156923255f, -0.00113910006f, 0.00226947083f, -0.000365138956f, -0.0122937569f, 0.0508597866f, -0.154813617f, 0.679316342f, 0.554705322f, -0.16686897f, 0.0665945262f, -0.0232036952f, 0.00544455834f, -0.000118164353f, -0.000447551778f},
+    {-0.000107649015f, 0.000130034634f, -0.000953638868f, 0.00162574486f, 0.0012419722f, -0.0154463332f, 0.0558102168f, -0.160117999f, 0.649810553f, 0.587350905f, -0.166088015f, 0.0636796579f, -0.0209113434f, 0.00415421696f, 0.000428264786f, -0.000606625108f},
+    {-0.000117413583f, 0.000105603933f, -0.000775716559f, 0.00101071701f, 0.00275117904f, -0.0183231086f, 0.0600864552f, -0.163861737f, 0.619118154f, 0.619118154f, -0.163861737f, 0.0600864552f, -0.0183231086f, 0.00275117904f, 0.00101071701f, -0.000775716559f},
+    {-0.000125833234f, 8.3779094e-05f, -0.000606664224f, 0.000428292406f, 0.00415448472f, -0.020912692f, 0.0636837631f, -0.166098729f, 0.587388813f, 0.649852455f, -0.160128325f, 0.0558138192f, -0.0154473297f, 0.0012420523f, 0.00162584975f, -0.000953700393f},
+    {-0.000132487767f, 6.46381086e-05f, -0.000447608996f, -0.000118179458f, 0.00544525404f, -0.0232066605f, 0.0666030422f, -0.166890293f, 0.554776192f, 0.679403186f, -0.154833406f, 0.0508662872f, -0.0122953281f, -0.000365185639f, 0.00226976094f, -0.00113924569f},
+    {-0.000136951407f, 4.81926872e-05f, -0.000299474428f, -0.000625905814f, 0.00661820499f, -0.0251994822f, 0.0688505694f, -0.166304424f, 0.521436989f, 0.707624078f, -0.147930413f, 0.0452542305f, -0.00888141524f, -0.00206119474f, 0.00293799606f, -0.00133081665f},
+    {-0.000138800344f, 3.43928405e-05f, -0.000162984361f, -0.00109264511f, 0.00766938552f, -0.0268884357f, 0.070437707f, -0.164415196f, 0.487529159f, 0.734373927f, -0.139381185f, 0.0389939919f, -0.0052229166f, -0.00383528741f, 0.00362555683f, -0.00152667612f},
+    {-0.000137620838f, 2.31322501e-05f, -3.8668637e-05f, -0.00151669653f, 0.00859615114f, -0.0282735191f, 0.0713806748f, -0.16130209f, 0.453212172f, 0.759518504f, -0.129156485f, 0.0321080536f, -0.00134015281f, -0.00567546161f, 0.00432692328f, -0.00172489218f},
+    {-0.000133017063f, 1.42542012e-05f, 7.31295295e-05f, -0.00189688534f, 0.00939711649f, -0.0293573383f, 0.0717001855f, -0.157049462f, 0.418645054f, 0.782930434f, -0.117236406f, 0.024625076f, 0.00274360506f, -0.00756844878f, 0.00503607746f, -0.00192334666f},
+    {-0.000124619197f, 7.55813062e-06f, 0.000172244356f, -0.00223254249f, 0.0100721084f, -0.0301449504f, 0.0714211017f, -0.151745647f, 0.383986026f, 0.804490328f, -0.103610732f, 0.0165799484f, 0.00700220885f, -0.00949976873f, 0.00574653503f, -0.00211974652f},
+    {-0.00011209154f, 2.80656764e-06f, 0.000258676737f, -0.00252348115f, 0.010622099f, -0.0306437239f, 0.0705720708f, -0.145482332f, 0.349391133f, 0.82408756f, -0.0882792622f, 0.00801376346f, 0.0114067337f, -0.0114538129f, 0.00645138463f, -0.00231163949f},
+    {-9.51403999e-05f, -2.67575302e-07f, 0.000332582509f, -0.00276997103f, 0.0110491542f, -0.0308631938f, 0.0691851899f, -0.138354003f, 0.315013975f, 0.841621578f, -0.0712521598f, -0.00102623866f, 0.0159256179f, -0.013413934f, 0.00714333495f, -0.00249643112f},
+    {-7.35215217e-05f, -1.95351663e-06f, 0.000394258939f, -0.00297270529f, 0.0113563417f, -0.0308148302f, 0.0672955215f, -0.130456939f, 0.281003952f, 0.857001066f, -0.0525499657f, -0.0104868067f, 0.0205248091f, -0.0153625421f, 0.00781476311f, -0.00267140451f},
+    {-4.70475061e-05f, -2.55500004e-06f, 0.000444131379f, -0.00313277007f, 0.0115476586f, -0.0305119064f, 0.0649407804f, -0.121888712f, 0.247506127f, 0.870146275f, -0.0322038643f, -0.0203088336f, 0.02516797f, -0.0172812399f, 0.00845777709f, -0.00283374498f},
+    {-1.5594338e-05f, -2.38270468e-06f, 0.00048273828f, -0.00325160869f, 0.0116279479f, -0.0299692769f, 0.0621608645f, -0.112747468f, 0.214660093f, 0.880988598f, -0.0102556767f, -0.0304275975f, 0.0298166964f, -0.0191509426f, 0.0090642795f, -0.00298056379f},
+    {2.0892423e-05f, -1.74676222e-06f, 0.000510716171f, -0.00333098392f, 0.011602805f, -0.029203169f, 0.0589974448f, -0.103131153f, 0.182599187f, 0.889470994f, 0.013242186f, -0.040773008f, 0.0344307534f, -0.020952031f, 0.00962603651f, -0.00310892868f},
+    {6.2392297e-05f, -9.49497746e-07f, 0.000528784527f, -0.0033729428f, 0.0114784939f, -0.0282310154f, 0.0554936081f, -0.0931369364f, 0.151449889f, 0.895549059f, 0.0382267982f, -0.0512699708f, 0.0389683731f, -0.0226645172f, 0.0101347612f, -0.00321589387f},
+    {0.000108805318f, -2.78482048e-07f, 0.000537730521f, -0.00337977521f, 0.0112618441f, -0.0270712022f, 0.0516933762f, -0.0828604847f, 0.121331058f, 0.899190843f, 0.0646249354f, -0.0618387572f, 0.0433865413f, -0.0242682081f, 0.0105821891f, -0.00329853385f},
+};
+
+#if !GB_FREESTANDING
+static void apu_ring_init(apu_ring_t &r, int16_t *data, uint32_t frames) {
+    r.data = data;
+    r.mask = frames - 1;
+    r.head.store(0, std::memory_order_relaxed);
+    r.tail.store(0, std::memory_order_relaxed);
+}
+
+// Producer side; drops what doesn't fit. Returns the frames written.
+static uint32_t apu_ring_push(apu_ring_t &r, const int16_t *frames, uint32_t n) {
+    uint32_t head = r.head.load(std::memory_order_relaxed);
+    uint32_t tail = r.tail.load(std::memory_order_acquire);
+    uint32_t room = (r.mask + 1) - (head - tail);
+
+    if (n > room) {
+        n = room;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t at = (head + i) & r.mask;
+        r.data[at * 2] = frames[i * 2];
+        r.data[at * 2 + 1] = frames[i * 2 + 1];
+    }
+    r.head.store(head + n, std::memory_order_release);
+    return n;
+}
+
+// Consumer side. Returns the frames read.
+static uint32_t apu_ring_pop(apu_ring_t &r, int16_t *frames, uint32_t n) {
+    uint32_t tail = r.tail.load(std::memory_order_relaxed);
+    uint32_t head = r.head.load(std::memory_order_acquire);
+
+    if (n > head - tail) {
+        n = head - tail;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t at = (tail + i) & r.mask;
+        frames[i * 2] = r.data[at * 2];
+        frames[i * 2 + 1] = r.data[at * 2 + 1];
+    }
+    r.tail.store(tail + n, std::memory_order_release);
+    return n;
+}
+#endif
+
+static GB_DEVICE uint32_t apu_period(state_t &s, int i) {
+    apu_channel_t &c = s.apu.ch[i];
+
+    switch (i)
+    {
+    case 0:
+    case 1:
+        return ((2048 - c.freq) * 4) << s.clock_shift;
+    case 2:
+        return ((2048 - c.freq) * 2) << s.clock_shift;
+    default:
+        return (apu_noise_div[s.mem[NR43] & 7] << (s.mem[NR43] >> 4)) << s.clock_shift;
+    }
+}
+
+static GB_DEVICE uint8_t apu_level(state_t &s, int i) {
+    apu_channel_t &c = s.apu.ch[i];
+
+    if (!c.enabled || !c.dac) {
+        return 0;
+    }
+
+    switch (i)
+    {
+    case 0:
+    case 1: {
+        uint8_t duty = s.mem[apu_nrx1[i]] >> 6;
+        return ((apu_duty[duty] << c.pos) & 0x80) ? c.volume : 0;
+    }
+    case 2: {
+        uint8_t byte = s.mem[WAVE + (c.pos >> 1)];
+        uint8_t sample = (c.pos & 1) ? (byte & 0x0f) : (byte >> 4);
+        uint8_t code = (s.mem[NR32] >> 5) & 3;
+        return code ? sample >> (code - 1) : 0;
+    }
+    default:
+        return (c.lfsr & 1) ? 0 : c.volume;
+    }
+}
+
+static GB_DEVICE void apu_add_delta(apu_t &a, uint64_t at, int side, float delta) {
+    uint64_t pos = a.pos_base + (at - a.time_base) * a.step;
+    uint32_t idx = (uint32_t)(pos >> 32);
+    const float *k = apu_blep[(uint32_t)pos >> (32 - 5)];
+
+    if (idx >= APU_BUF_SAMPLES) {
+        return;
+    }
+    float *out = &a.delta[side][idx];
+    for (int t = 0; t < APU_BLEP_TAPS; t++) {
+        out[t] += delta * k[t];
+    }
+}
+
+// Recomputes what channel i feeds into each side and records the change at
+// cycle `at`. Called after anything that can change a channel's level.
+static GB_DEVICE void apu_set_level(state_t &s, int i, uint64_t at) {
+    apu_t &a = s.apu;
+    apu_channel_t &c = a.ch[i];
+
+    c.level = apu_level(s, i);
+    if (!a.ring) {
+        return;
+    }
+
+    uint8_t pan = s.mem[NR51];
+    uint8_t vol = s.mem[NR50];
+    float amp[2];
+    amp[0] = ((pan >> (4 + i)) & 1) ? c.level * (((vol >> 4) & 7) + 1) : 0;
+    amp[1] = ((pan >> i) & 1) ? c.level * ((vol & 7) + 1) : 0;
+
+    for (int side = 0; side < 2; side++) {
+        if (amp[side] != c.amp[side]) {
+            apu_add_delta(a, at, side, amp[side] - c.amp[side]);
+            c.amp[side] = amp[side];
+        }
+    }
+}
+
+static GB_DEVICE void apu_disable(state_t &s, int i, uint64_t at) {
+    s.apu.ch[i].enabled = false;
+    apu_set_level(s, i, at);
+}
+
+// Runs the waveform generators up to `now`. Nothing to do without a ring:
+// the waveform position is not visible through any register.
+static GB_DEVICE void apu_sync(state_t &s, uint64_t now) {
+    apu_t &a = s.apu;
+
+    if (!a.ring) {
+        return;
+    }
+
+    for (int i = 0; i < APU_CHANNELS; i++) {
+        apu_channel_t &c = a.ch[i];
+
+        if (!c.enabled || !c.dac) {
+            c.next = now;
+            continue;
+        }
+
+        uint32_t period = apu_period(s, i);
+        while (c.next <= now) {
+            if (i == 3) {
+                uint16_t bit = (c.lfsr ^ (c.lfsr >> 1)) & 1;
+                c.lfsr = (c.lfsr >> 1) | (bit << 14);
+                if (s.mem[NR43] & 0x08) {
+                    c.lfsr = (c.lfsr & ~0x40) | (bit << 6);
+                }
+            }
+            else {
+                c.pos = (c.pos + 1) & (i == 2 ? 31 : 7);
+            }
+            apu_set_level(s, i, c.next);
+            c.next += period;
+        }
+    }
+}
+
+#if !GB_FREESTANDING
+// Integrates everything up to `now` into samples and hands them to the ring.
+static void apu_flush(state_t &s, uint64_t now) {
+    apu_t &a = s.apu;
+    int16_t out[APU_BUF_SAMPLES * 2];
+
+    uint64_t pos = a.pos_base + (now - a.time_base) * a.step;
+    uint32_t n = (uint32_t)(pos >> 32);
+    if (n > APU_BUF_SAMPLES) {
+        n = APU_BUF_SAMPLES;
+    }
+
+    for (int side = 0; side < 2; side++) {
+        float acc = a.accum[side];
+        float dc = a.dc[side];
+
+        for (uint32_t i = 0; i < n; i++) {
+            acc += a.delta[side][i];
+            dc += (acc - dc) * (1.0f / 1024);
+
+            float v = (acc - dc) * 64;
+            if (v > 32767) {
+                v = 32767;
+            }
+            if (v < -32768) {
+                v = -32768;
+            }
+            out[i * 2 + side] = (int16_t)v;
+        }
+        a.accum[side] = acc;
+        a.dc[side] = dc;
+
+        // the kernel tail of the last deltas carries over
+        memmove(a.delta[side], a.delta[side] + n, (APU_BUF_SAMPLES + APU_BLEP_TAPS - n) * sizeof(float));
+        memset(a.delta[side] + APU_BUF_SAMPLES + APU_BLEP_TAPS - n, 0, n * sizeof(float));
+    }
+
+    apu_ring_push(*a.ring, out, n);
+    a.time_base = now;
+    a.pos_base = pos - ((uint64_t)n << 32);
+    a.flush_steps = 0;
+}
+#endif
+
+static GB_DEVICE uint16_t apu_sweep_calc(state_t &s, uint64_t at) {
+    apu_t &a = s.apu;
+    uint8_t nr10 = s.mem[NR10];
+    uint16_t d = a.sweep_shadow >> (nr10 & 7);
+    uint16_t freq = (nr10 & 0x08) ? a.sweep_shadow - d : a.sweep_shadow + d;
+
+    if (freq > 2047) {
+        apu_disable(s, 0, at);
+    }
+    return freq;
+}
+
+static GB_DEVICE void apu_clock_sweep(state_t &s, uint64_t at) {
+    apu_t &a = s.apu;
+    uint8_t nr10 = s.mem[NR10];
+    uint8_t period = (nr10 >> 4) & 7;
+
+    if (--a.sweep_timer > 0) {
+        return;
+    }
+    a.sweep_timer = period ? period : 8;
+    if (!a.sweep_enabled || !period) {
+        return;
+    }
+
+    uint16_t freq = apu_sweep_calc(s, at);
+    if (freq <= 2047 && (nr10 & 7)) {
+        a.sweep_shadow = freq;
+        a.ch[0].freq = freq;
+        s.mem[NR13] = freq & 0xff;
+        s.mem[NR14] = (s.mem[NR14] & 0xf8) | (freq >> 8);
+        apu_sweep_calc(s, at);
+    }
+}
+
+static GB_DEVICE void apu_clock_sequencer(state_t &s, uint64_t at) {
+    apu_t &a = s.apu;
+
+    if (!(s.mem[NR52] & 0x80)) {
+        return;
+    }
+
+    uint8_t step = a.seq_step;
+    a.seq_step = (step + 1) & 7;
+
+    if (!(step & 1)) {
+        for (int i = 0; i < APU_CHANNELS; i++) {
+            apu_channel_t &c = a.ch[i];
+            if (c.length_enable && c.length && --c.length == 0) {
+                apu_disable(s, i, at);
+            }
+        }
+    }
+    if (step == 2 || step == 6) {
+        apu_clock_sweep(s, at);
+    }
+    if (step == 7) {
+        for (int i = 0; i < APU_CHANNELS; i++) {
+            apu_channel_t &c = a.ch[i];
+            uint8_t nrx2 = s.mem[apu_nrx2[i]];
+            uint8_t period = nrx2 & 7;
+
+            if (i == 2 || !period || --c.env_timer > 0) {
+                continue;
+            }
+            c.env_timer = period;
+            if ((nrx2 & 0x08) && c.volume < 15) {
+                c.volume++;
+            }
+            else if (!(nrx2 & 0x08) && c.volume > 0) {
+                c.volume--;
+            }
+            apu_set_level(s, i, at);
+        }
+    }
+}
+
+static GB_DEVICE void apu_event(state_t &s, uint64_t at) {
+    apu_sync(s, at);
+    apu_clock_sequencer(s, at);
+    sched_set(s.sched, ev::APU, at + (APU_SEQ_CYCLES << s.clock_shift));
+
+#if !GB_FREESTANDING
+    if (s.apu.ring && ++s.apu.flush_steps >= APU_FLUSH_STEPS) {
+        apu_flush(s, at);
+    }
+#endif
+}
+
+static GB_DEVICE void apu_trigger(state_t &s, int i, uint64_t at) {
+    apu_t &a = s.apu;
+    apu_channel_t &c = a.ch[i];
+
+    c.enabled = c.dac;
+    if (c.length == 0) {
+        c.length = (i == 2) ? 256 : 64;
+    }
+    c.next = at + apu_period(s, i);
+    if (i == 2) {
+        c.pos = 0;
+    }
+    if (i == 3) {
+        c.lfsr = 0x7fff;
+    }
+    if (i != 2) {
+        uint8_t nrx2 = s.mem[apu_nrx2[i]];
+        c.volume = nrx2 >> 4;
+        c.env_timer = (nrx2 & 7) ? (nrx2 & 7) : 8;
+    }
+    if (i == 0) {
+        uint8_t nr10 = s.mem[NR10];
+        uint8_t period = (nr10 >> 4) & 7;
+        a.sweep_shadow = c.freq;
+        a.sweep_timer = period ? period : 8;
+        a.sweep_enabled = period || (nr10 & 7);
+        if (nr10 & 7) {
+            apu_sweep_calc(s, at);
+        }
+    }
+    apu_set_level(s, i, at);
+}
+
+static GB_DEVICE void apu_power(state_t &s, bool on, uint64_t at) {
+    apu_t &a = s.apu;
+
+    if (!on) {
+        memset(&s.mem[NR10], 0, NR52 - NR10);
+        for (int i = 0; i < APU_CHANNELS; i++) {
+            a.ch[i].dac = false;
+            a.ch[i].length_enable = false;
+            a.ch[i].freq = 0;
+            apu_disable(s, i, at);
+        }
+        return;
+    }
+    a.seq_step = 0;
+    a.ch[0].pos = 0;
+    a.ch[1].pos = 0;
+}
+
+// Returns the value to store; writes other than NR52 and wave RAM are
+// ignored while the APU is powered off.
+static GB_DEVICE uint8_t apu_write(state_t &s, uint16_t addr, uint8_t n) {
+    apu_t &a = s.apu;
+    uint64_t now = s.cycles;
+    bool powered = s.mem[NR52] & 0x80;
+
+    if (!powered && addr != NR52 && addr < WAVE) {
+        return s.mem[addr];
+    }
+
+    apu_sync(s, now);
+    s.mem[addr] = n;
+
+    if (addr >= WAVE) {
+        apu_set_level(s, 2, now);
+        return n;
+    }
+
+    int i = (addr - NR10) / 5;
+    switch (addr)
+    {
+    case NR11:
+    case NR21:
+    case NR41:
+        a.ch[i].length = 64 - (n & 0x3f);
+        apu_set_level(s, i, now);
+        break;
+    case NR31:
+        a.ch[2].length = 256 - n;
+        break;
+    case NR12:
+    case NR22:
+    case NR42:
+        a.ch[i].dac = (n & 0xf8) != 0;
+        if (!a.ch[i].dac) {
+            a.ch[i].enabled = false;
+        }
+        apu_set_level(s, i, now);
+        break;
+    case NR30:
+        a.ch[2].dac = (n & 0x80) != 0;
+        if (!a.ch[2].dac) {
+            a.ch[2].enabled = false;
+        }
+        apu_set_level(s, 2, now);
+        break;
+    case NR32:
+        apu_set_level(s, 2, now);
+        break;
+    case NR13:
+    case NR23:
+    case NR33:
+        a.ch[i].freq = (a.ch[i].freq & 0x700) | n;
+        break;
+    case NR14:
+    case NR24:
+    case NR34:
+    case NR44:
+        if (addr != NR44) {
+            a.ch[i].freq = (a.ch[i].freq & 0xff) | ((n & 7) << 8);
+        }
+        a.ch[i].length_enable = (n & 0x40) != 0;
+        if (n & 0x80) {
+            apu_trigger(s, i, now);
+        }
+        break;
+    case NR50:
+    case NR51:
+        for (int c = 0; c < APU_CHANNELS; c++) {
+            apu_set_level(s, c, now);
+        }
+        break;
+    case NR52:
+        if (((n & 0x80) != 0) != powered) {
+            apu_power(s, !powered, now);
+        }
+        return n & 0x80;
+    }
+    return n;
+}
+
+static GB_DEVICE uint8_t apu_read(state_t &s, uint16_t addr) {
+    if (addr == NR52) {
+        uint8_t status = (s.mem[NR52] & 0x80) | apu_read_mask[NR52 - NR10];
+        for (int i = 0; i < APU_CHANNELS; i++) {
+            status |= s.apu.ch[i].enabled << i;
+        }
+        return status;
+    }
+    if (addr > NR52) {
+        return 0xff;
+    }
+    return s.mem[addr] | apu_read_mask[addr - NR10];
+}
+
+// A DIV write resets the divider; if bit 12 was high that is a falling edge.
+// Called before the timer resets it. In double speed the sequencer follows
+// bit 13.
+static GB_DEVICE void apu_div_write(state_t &s) {
+    if ((timer_divider(s) >> (12 + s.clock_shift)) & 1) {
+        apu_sync(s, s.cycles);
+        apu_clock_sequencer(s, s.cycles);
+    }
+    sched_set(s.sched, ev::APU, s.cycles + (APU_SEQ_CYCLES << s.clock_shift));
+
+#if !GB_FREESTANDING
+    // writes more often than the sequencer steps keep pushing back the event
+    // that flushes, so flush here once as much time has passed
+    if (s.apu.ring && s.cycles - s.apu.time_base >= ((uint64_t)APU_FLUSH_STEPS * APU_SEQ_CYCLES << s.clock_shift)) {
+        apu_sync(s, s.cycles);
+        apu_flush(s, s.cycles);
+    }
+#endif
+}
+
+// Output samples per CPU clock, 32.32 fixed point.
+static GB_DEVICE uint64_t apu_step(state_t &s) {
+    return ((uint64_t)s.apu.rate << 32) / ((uint64_t)APU_CLOCK << s.clock_shift);
+}
+
+// Moves the sample clock origin to `now`, ahead of a change of a.step.
+static GB_DEVICE void apu_retime(state_t &s, uint64_t now) {
+    apu_t &a = s.apu;
+
+    if (!a.ring) {
+        return;
+    }
+    a.pos_base += (now - a.time_base) * a.step;
+    a.time_base = now;
+}
+
+#if !GB_FREESTANDING
+// Turns synthesis on. `ring` belongs to the caller and must outlive the
+// attachment; `rate` is the output sample rate in Hz.
+static void apu_output_attach(state_t &s, apu_ring_t *ring, uint32_t rate) {
+    apu_t &a = s.apu;
+
+    if (rate > APU_MAX_RATE) {
+        rate = APU_MAX_RATE;
+    }
+
+    a.ring = ring;
+    a.rate = rate;
+    a.step = apu_step(s);
+    a.time_base = s.cycles;
+    a.pos_base = 0;
+    a.flush_steps = 0;
+    memset(a.delta, 0, sizeof(a.delta));
+    memset(a.accum, 0, sizeof(a.accum));
+    memset(a.dc, 0, sizeof(a.dc));
+
+    for (int i = 0; i < APU_CHANNELS; i++) {
+        a.ch[i].amp[0] = 0;
+        a.ch[i].amp[1] = 0;
+        a.ch[i].next = s.cycles;
+        apu_set_level(s, i, s.cycles);
+    }
+}
+
+// Back to register-only emulation.
+static void apu_output_detach(state_t &s) {
+    s.apu.ring = nullptr;
+}
+#endif
+
+// Post-boot register values, channel 1 left enabled at volume 0.
+static GB_DEVICE void apu_init(state_t &s) {
+    apu_t &a = s.apu;
+
+    memset(&a, 0, sizeof(apu_t));
+    memset(&s.mem[NR10], 0, WAVE - NR10);
+
+    s.mem[NR10] = 0x80;
+    s.mem[NR11] = 0xbf;
+    s.mem[NR12] = 0xf3;
+    s.mem[NR14] = 0xbf;
+    s.mem[NR21] = 0x3f;
+    s.mem[NR24] = 0xbf;
+    s.mem[NR30] = 0x7f;
+    s.mem[NR31] = 0xff;
+    s.mem[NR32] = 0x9f;
+    s.mem[NR34] = 0xbf;
+    s.mem[NR41] = 0xff;
+    s.mem[NR44] = 0xbf;
+    s.mem[NR50] = 0x77;
+    s.mem[NR51] = 0xf3;
+    s.mem[NR52] = 0x80;
+
+    a.ch[0].enabled = true;
+    a.ch[0].dac = true;
+    a.ch[3].lfsr = 0x7fff;
+
+    uint64_t period = APU_SEQ_CYCLES << s.clock_shift;
+    uint64_t phase = (s.cycles - s.div_base) % period;
+    sched_set(s.sched, ev::APU, s.cycles + period - phase);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include "config.hpp"
+#if !GB_FREESTANDING
+#include <atomic>
+#endif
+
+#define APU_CHANNELS 4
+
+// Samples of band-limited deltas kept between flushes. One flush covers
+// 8 frame sequencer steps (65536 cycles), 750 samples at 48 kHz.
+#define APU_BUF_SAMPLES 2048
+#define APU_MAX_RATE    96000
+
+#define APU_BLEP_PHASES 32
+#define APU_BLEP_TAPS   16
+
+// Single-producer single-consumer ring of interleaved stereo int16 frames.
+// The emulation thread pushes, the audio thread pops, nothing is locked.
+// Owned by the host; the APU only holds a pointer while synthesis is on.
+#if GB_FREESTANDING
+struct apu_ring_t;
+#else
+struct apu_ring_t {
+    int16_t *data;                  // 2 * (mask + 1) samples
+    uint32_t mask;                  // frames - 1, frames a power of two
+    std::atomic<uint32_t> head;     // written by the producer only
+    std::atomic<uint32_t> tail;     // written by the consumer only
+};
+#endif
+
+struct apu_channel_t {
+    bool enabled;       // NR52 status bit
+    bool dac;
+    bool length_enable;
+    uint16_t length;    // counts down to 0, then the channel stops
+    uint16_t freq;      // 11 bits from NRx3/NRx4
+    uint8_t volume;
+    uint8_t env_timer;
+    uint8_t pos;        // duty step or wave sample index
+    uint16_t lfsr;
+    uint64_t next;      // cycle of the next waveform step
+    uint8_t level;      // DAC input, 0-15
+    float amp[2];       // what this channel contributes to L/R right now
+};
+
+struct apu_t {
+    apu_channel_t ch[APU_CHANNELS];
+    uint8_t seq_step;
+
+    bool sweep_enabled;
+    uint8_t sweep_timer;
+    uint16_t sweep_shadow;
+
+    // Synthesis. Only touched while `ring` is set; with no ring attached the
+    // registers, length counters, envelopes and sweep still run so NR52 and
+    // the rest read back the same, but no waveform is generated.
+    apu_ring_t *ring;
+    uint32_t rate;
+    uint64_t step;          // output samples per T-cycle, 32.32 fixed point
+    uint64_t time_base;     // cycle at which the buffer is at pos_base
+    uint64_t pos_base;
+    uint8_t flush_steps;    // sequencer steps since the last flush
+    float delta[2][APU_BUF_SAMPLES + APU_BLEP_TAPS];
+    float accum[2];
+    float dc[2];
+};
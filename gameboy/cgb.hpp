@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "state.hpp"
+#include "sched.hpp"
+#include "mem_map.hpp"
+#include "apu.hpp"
+
+// CGB registers: speed switch, VRAM/WRAM banks, color palettes and HDMA.
+// In DMG mode none of them exist and they read 0xFF.
+
+#define CGB_HDMA_BLOCK_CYCLES 32    // per 16 bytes, in single-speed clocks
+#define CGB_SPEED_SWITCH_CYCLES 8200
+
+static GB_DEVICE uint8_t cgb_expand5(uint8_t c) {
+    return (c << 3) | (c >> 2);
+}
+
+// Converts one RGB555 palette entry into every output format. Only runs on
+// palette writes, never per pixel.
+static GB_DEVICE void cgb_palette_entry(state_t &s, uint8_t entry) {
+    cgb_t &c = s.cgb;
+    uint16_t rgb = c.pal[entry * 2] | (c.pal[entry * 2 + 1] << 8);
+    uint8_t r = rgb & 0x1f;
+    uint8_t g = (rgb >> 5) & 0x1f;
+    uint8_t b = (rgb >> 10) & 0x1f;
+    uint8_t r8 = cgb_expand5(r);
+    uint8_t g8 = cgb_expand5(g);
+    uint8_t b8 = cgb_expand5(b);
+
+    c.rgba[entry] = 0xff000000 | (b8 << 16) | (g8 << 8) | r8;
+    c.rgb565[entry] = (r << 11) | (((g << 1) | (g >> 4)) << 5) | b;
+    c.gray[entry] = (r8 * 77 + g8 * 150 + b8 * 29) >> 8;
+}
+
+// BCPD/OCPD: obj selects the OBJ half of palette RAM.
+static GB_DEVICE void cgb_palette_write(state_t &s, bool obj, uint8_t n) {
+    cgb_t &c = s.cgb;
+    uint8_t &sel = obj ? c.ocps : c.bcps;
+    uint8_t index = (obj ? 64 : 0) + (sel & 0x3f);
+
+    if (c.pal[index] != n) {
+        c.pal[index] = n;
+        cgb_palette_entry(s, index >> 1);
+        c.pal_gen++;
+    }
+
+    if (sel & 0x80) {
+        sel = 0x80 | ((sel + 1) & 0x3f);
+    }
+}
+
+static GB_DEVICE void cgb_hdma_block(state_t &s) {
+    cgb_t &c = s.cgb;
+
+    // both ends are 16-byte aligned, so neither crosses a page
+    memcpy(s.page[c.hdma_dst >> 12] + (c.hdma_dst & 0xfff), s.page[c.hdma_src >> 12] + (c.hdma_src & 0xfff), 16);
+    c.hdma_src += 16;
+    c.hdma_dst = 0x8000 | ((c.hdma_dst + 16) & 0x1ff0);
+    c.hdma_left--;
+    s.cpu_stall += CGB_HDMA_BLOCK_CYCLES << s.clock_shift;
+}
+
+// Start of H-Blank on a visible line: one block of H-Blank DMA.
+static GB_DEVICE void cgb_hblank(state_t &s) {
+    if (!s.cgb.hdma_active) {
+        return;
+    }
+    cgb_hdma_block(s);
+    if (s.cgb.hdma_left == 0) {
+        s.cgb.hdma_active = false;
+    }
+}
+
+// HDMA5 with bit 7 clear copies everything now with the CPU held; with
+// bit 7 set a block goes at every H-Blank. Clearing bit 7 while an H-Blank
+// transfer runs stops it.
+static GB_DEVICE void cgb_hdma_write(state_t &s, uint8_t n) {
+    cgb_t &c = s.cgb;
+
+    if (c.hdma_active && !(n & 0x80)) {
+        c.hdma_active = false;
+        return;
+    }
+
+    c.hdma_src = ((s.mem[HDMA1] << 8) | s.mem[HDMA2]) & 0xfff0;
+    c.hdma_dst = 0x8000 | (((s.mem[HDMA3] << 8) | s.mem[HDMA4]) & 0x1ff0);
+    c.hdma_left = (n & 0x7f) + 1;
+
+    if (n & 0x80) {
+        c.hdma_active = true;
+        return;
+    }
+    while (c.hdma_left) {
+        cgb_hdma_block(s);
+    }
+}
+
+static GB_DEVICE uint64_t cgb_rescale(uint64_t at, uint64_t now, uint8_t shift) {
+    if (at == SCHED_NEVER || at <= now) {
+        return at;
+    }
+    return shift ? now + ((at - now) << 1) : now + ((at - now) >> 1);
+}
+
+// STOP with KEY1 bit 0 set. Everything counted in CPU clocks keeps going as
+// is; the PPU and APU have their pending delays converted to the new rate.
+static GB_DEVICE void cgb_speed_switch(state_t &s) {
+    uint64_t now = s.cycles;
+    uint8_t shift = s.clock_shift ^ 1;
+
+    apu_sync(s, now);
+    apu_retime(s, now);
+
+    s.sched.at[ev::LCD] = cgb_rescale(s.sched.at[ev::LCD], now, shift);
+    s.sched.at[ev::APU] = cgb_rescale(s.sched.at[ev::APU], now, shift);
+    for (int i = 0; i < APU_CHANNELS; i++) {
+        s.apu.ch[i].next = cgb_rescale(s.apu.ch[i].next, now, shift);
+    }
+    uint64_t into_line = now - s.lcd.line_start;
+    s.lcd.line_start = now - (shift ? into_line << 1 : into_line >> 1);
+
+    s.clock_shift = shift;
+    s.apu.step = apu_step(s);
+    sched_update(s.sched);
+
+    s.cgb.speed_prepare = false;
+    s.cpu_stall += CGB_SPEED_SWITCH_CYCLES;
+}
+
+static GB_DEVICE uint8_t cgb_read(state_t &s, uint16_t addr) {
+    cgb_t &c = s.cgb;
+
+    if (!c.enabled) {
+        return 0xff;
+    }
+
+    switch (addr)
+    {
+    case KEY1:
+        return 0x7e | (s.clock_shift << 7) | c.speed_prepare;
+    case VBK:
+        return 0xfe | c.vram_bank;
+    case SVBK:
+        return 0xf8 | c.wram_bank;
+    case HDMA5:
+        return (c.hdma_active ? 0 : 0x80) | ((c.hdma_left - 1) & 0x7f);
+    case BCPS:
+        return c.bcps | 0x40;
+    case OCPS:
+        return c.ocps | 0x40;
+    case BCPD:
+        return c.pal[c.bcps & 0x3f];
+    case OCPD:
+        return c.pal[64 + (c.ocps & 0x3f)];
+    }
+    return 0xff;
+}
+
+// Returns the value to store in s.mem.
+static GB_DEVICE uint8_t cgb_write(state_t &s, uint16_t addr, uint8_t n) {
+    cgb_t &c = s.cgb;
+
+    if (!c.enabled) {
+        return n;
+    }
+
+    switch (addr)
+    {
+    case KEY1:
+        c.speed_prepare = n & 1;
+        break;
+    case VBK:
+        c.vram_bank = n & 1;
+        mem_map_update(s);
+        break;
+    case SVBK:
+        c.wram_bank = n & 7;
+        mem_map_update(s);
+        break;
+    case HDMA5:
+        cgb_hdma_write(s, n);
+        break;
+    case BCPS:
+        c.bcps = n & 0xbf;
+        break;
+    case OCPS:
+        c.ocps = n & 0xbf;
+        break;
+    case BCPD:
+        cgb_palette_write(s, false, n);
+        break;
+    case OCPD:
+        cgb_palette_write(s, true, n);
+        break;
+    }
+    return n;
+}
+
+// Header byte 0x143 bit 7 marks a CGB cartridge. Palettes start out white
+// as the boot ROM leaves them.
+static GB_DEVICE void cgb_init(state_t &s, const uint8_t *rom) {
+    cgb_t &c = s.cgb;
+
+    memset(&c, 0, sizeof(cgb_t));
+    c.enabled = (rom[0x143] & 0x80) != 0;
+    memset(c.pal, 0xff, sizeof(c.pal));
+    for (int i = 0; i < 64; i++) {
+        cgb_palette_entry(s, i);
+    }
+}
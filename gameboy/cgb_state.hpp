@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+// Color Game Boy additions. Only used when the cartridge header asks for
+// CGB mode; DMG cartridges run on the DMG register set as before.
+struct cgb_t {
+    bool enabled;
+    bool speed_prepare;     // KEY1 bit 0, STOP switches speed when set
+
+    uint8_t vram_bank;      // VBK
+    uint8_t wram_bank;      // SVBK, 0 reads as 1
+    uint8_t vram1[0x2000];  // bank 0 stays at mem[0x8000]
+    uint8_t wram[6][0x1000];// banks 2-7, bank 1 stays at mem[0xd000]
+
+    uint8_t bcps;
+    uint8_t ocps;
+    uint8_t pal[128];       // BG palette RAM, then OBJ palette RAM
+
+    // Every palette entry pre-converted for each output format. lcd.vram
+    // holds (palette << 2) | color with BG palettes 0-7 and OBJ 8-15, which
+    // is also the entry index here.
+    uint32_t rgba[64];
+    uint16_t rgb565[64];
+    uint8_t gray[64];
+    uint32_t pal_gen;       // bumped on every palette write
+
+    bool hdma_active;       // H-Blank DMA in progress
+    uint16_t hdma_src;
+    uint16_t hdma_dst;
+    uint8_t hdma_left;      // 16-byte blocks still to copy
+};
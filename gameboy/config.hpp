@@ -1,4 +1,26 @@
 #pragma once
 
 #define DEBUG 0
-#define USE_BOOTROM 0
\ No newline at end of file
+#define USE_BOOTROM 0
+
+// Build only the emulation path: no I/O, no allocation, no threads and no
+// globals besides constant tables. Everything the core needs comes in
+// through state_t. Left out: pipelined rendering, the audio and input rings,
+// file-backed serial, allocating initialize_state() and debug output.
+#ifndef GB_FREESTANDING
+#if defined(__CUDACC__)
+#define GB_FREESTANDING 1
+#else
+#define GB_FREESTANDING 0
+#endif
+#endif
+
+// Core functions are callable from host and device code alike; constant
+// tables go to device constant memory when compiled for a GPU.
+#if defined(__CUDACC__)
+#define GB_DEVICE __host__ __device__
+#define GB_TABLE __constant__
+#else
+#define GB_DEVICE
+#define GB_TABLE
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "state.hpp"
+#include "sched.hpp"
+#include "lcd_pipeline.hpp"
+
+// OAM DMA. Writing FF46 starts a 160 M-cycle transfer one M-cycle later;
+// byte i lands in OAM at dma_start + i * 4. Nothing is copied per cycle:
+// whatever is due gets copied in one go when something could tell the
+// difference (the PPU reading sprites, the CPU writing the source page) and
+// the rest when the end event fires, so a per-frame DMA is one memcpy.
+
+#define DMA_LENGTH 160
+
+static GB_DEVICE void dma_sync(state_t &s, uint64_t now) {
+    if (!s.dma_active || now < s.dma_start) {
+        return;
+    }
+
+    uint64_t due = (now - s.dma_start) / 4 + 1;
+    if (due > DMA_LENGTH) {
+        due = DMA_LENGTH;
+    }
+    if (due <= s.dma_copied) {
+        return;
+    }
+
+    memcpy(&s.mem[0xfe00 + s.dma_copied], s.page[s.dma_src >> 12] + (s.dma_src & 0xfff) + s.dma_copied, due - s.dma_copied);
+    if (s.lcd.pipeline) {
+        for (uint16_t i = s.dma_copied; i < due; i++) {
+            lcd_pipeline_log(s, 0xfe00 + i, s.mem[0xfe00 + i]);
+        }
+    }
+    s.dma_copied = due;
+}
+
+static GB_DEVICE void dma_event(state_t &s, uint64_t at) {
+    dma_sync(s, at);
+    s.dma_active = false;
+}
+
+static GB_DEVICE void dma_begin(state_t &s, uint8_t n) {
+    // a restart finishes what the old transfer got through first
+    dma_sync(s, s.cycles);
+
+    // E0-FF would read echo RAM, which is not mirrored in s.mem
+    s.dma_src = (n >= 0xe0 ? n - 0x20 : n) << 8;
+    s.dma_start = s.cycles + 4;
+    s.dma_copied = 0;
+    s.dma_active = true;
+    sched_set(s.sched, ev::DMA, s.dma_start + DMA_LENGTH * 4);
+}
+
+// While the transfer runs the CPU only sees HRAM and the I/O registers;
+// everything else on the bus reads 0xFF.
+static GB_DEVICE bool dma_blocks(state_t &s, uint16_t addr) {
+    return s.dma_active && addr < 0xff00 && s.cycles >= s.dma_start;
+}
+
+static GB_DEVICE void dma_init(state_t &s) {
+    s.dma_active = false;
+    s.dma_src = 0;
+    s.dma_start = 0;
+    s.dma_copied = 0;
+}
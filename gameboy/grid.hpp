@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LR35902.hpp"
+
+// Host backend that runs instances the way a GPU kernel launch would: a
+// grid of blocks, each block a fixed number of lanes, every lane running
+// the same freestanding kernel body on its own state_t. Blocks go to a pool
+// of host threads in any order; lanes of a block run back to back on one
+// thread. Nothing is shared between lanes, so the same kernel body can be
+// launched unchanged on a device.
+
+struct grid_dim_t {
+    uint32_t blocks;
+    uint32_t threads;   // lanes per block
+};
+
+static grid_dim_t grid_dim_for(uint32_t n, uint32_t threads) {
+    return grid_dim_t{(n + threads - 1) / threads, threads};
+}
+
+// Host threads that blocks are handed to. They are started once and wait
+// between launches, so a launch costs a wakeup rather than a thread start.
+struct grid_executor_t {
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable cv;
+    uint64_t launch;        // bumped to wake the workers
+    unsigned running;       // workers not done with the current launch
+    bool quit;
+
+    grid_dim_t dim;
+    void (*body)(void *kernel, uint32_t block, uint32_t thread);
+    void *kernel;
+    std::atomic<uint32_t> next_block;
+};
+
+static void grid_executor_blocks(grid_executor_t &e) {
+    for (;;) {
+        uint32_t block = e.next_block.fetch_add(1, std::memory_order_relaxed);
+        if (block >= e.dim.blocks) {
+            return;
+        }
+        for (uint32_t thread = 0; thread < e.dim.threads; thread++) {
+            e.body(e.kernel, block, thread);
+        }
+    }
+}
+
+static void grid_executor_worker(grid_executor_t *e) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(e->lock);
+            e->cv.wait(lk, [e, seen] { return e->quit || e->launch != seen; });
+            if (e->quit) {
+                return;
+            }
+            seen = e->launch;
+        }
+        grid_executor_blocks(*e);
+        std::lock_guard<std::mutex> lk(e->lock);
+        if (--e->running == 0) {
+            e->cv.notify_all();
+        }
+    }
+}
+
+// `workers` = 0 uses one host thread per core. The thread launching work
+// is one of them.
+static grid_executor_t *grid_executor_create(unsigned workers = 0) {
+    if (workers == 0) {
+        workers = std::thread::hardware_concurrency();
+    }
+    grid_executor_t *e = new grid_executor_t();
+    e->launch = 0;
+    e->running = 0;
+    e->quit = false;
+    for (unsigned i = 1; i < workers; i++) {
+        e->workers.emplace_back(grid_executor_worker, e);
+    }
+    return e;
+}
+
+static void grid_executor_destroy(grid_executor_t *e) {
+    if (!e) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(e->lock);
+        e->quit = true;
+        e->cv.notify_all();
+    }
+    for (std::thread &t : e->workers) {
+        t.join();
+    }
+    delete e;
+}
+
+// Calls kernel(block, thread) for every lane of the grid and returns once
+// all of them are done. Launches on one executor must not overlap.
+template <typename kernel_t>
+static void grid_launch(grid_executor_t &e, grid_dim_t dim, kernel_t kernel) {
+    e.dim = dim;
+    e.body = [](void *k, uint32_t block, uint32_t thread) {
+        (*(kernel_t *)k)(block, thread);
+    };
+    e.kernel = &kernel;
+    e.next_block.store(0, std::memory_order_relaxed);
+
+    // a single block is not worth a wakeup
+    if (e.workers.empty() || dim.blocks <= 1) {
+        grid_executor_blocks(e);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(e.lock);
+        e.running = (unsigned)e.workers.size();
+        e.launch++;
+        e.cv.notify_all();
+    }
+    grid_executor_blocks(e);
+    std::unique_lock<std::mutex> lk(e.lock);
+    e.cv.wait(lk, [&e] { return e.running == 0; });
+}
+
+// Advances `n` instances by `cycles` each. Lanes past `n` in the last block
+// idle, as they would on a device.
+template <typename ppu = ppu_fast>
+static void grid_run(grid_executor_t &e, state_t *states, uint32_t n, uint64_t cycles, uint32_t threads = 32) {
+    grid_launch(e, grid_dim_for(n, threads), [=](uint32_t block, uint32_t thread) {
+        uint32_t i = block * threads + thread;
+        if (i < n) {
+            run_until<ppu>(states[i], states[i].cycles + cycles);
+        }
+    });
+}
@@ -4,6 +4,7 @@
 #include "state.hpp"
 #include "mem.hpp"
 #include "stack.hpp"
+#include "timings.hpp"
 
 typedef void InstFun(state_t &s);
 
@@ -17,7 +18,7 @@ struct instruction_t {
 
 // 8-bit ALU
 
-inline void _add_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _add_a_n(state_t &s, _reg8_t n) {
     uint16_t res = s.regs.a + n;
 
     s.regs.subtract = 0;
@@ -28,7 +29,7 @@ inline void _add_a_n(state_t &s, _reg8_t n) {
     s.regs.zero = (s.regs.a == 0);
 }
 
-inline void _adc_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _adc_a_n(state_t &s, _reg8_t n) {
     // _add_a_n(s, n + s.regs.carry);
     // s.regs.carry = s.regs.a + n + s.regs.carry >= 0x100;
     // s.regs.half_carry = ((s.regs.a & 0xf) + (n & 0xf) + s.regs.carry) >= 0x10;
@@ -41,7 +42,7 @@ inline void _adc_a_n(state_t &s, _reg8_t n) {
     s.regs.zero = !s.regs.a;
 }
 
-inline void _sub_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _sub_a_n(state_t &s, _reg8_t n) {
     uint8_t res = s.regs.a - n;
 
     s.regs.zero = (res == 0);
@@ -52,7 +53,7 @@ inline void _sub_a_n(state_t &s, _reg8_t n) {
     s.regs.a = (_reg8_t)res;
 }
 
-inline void _sbc_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _sbc_a_n(state_t &s, _reg8_t n) {
     uint8_t carry = s.regs.carry;
 
     s.regs.half_carry = (((n & 0x0f) + carry) > (s.regs.a & 0x0f));
@@ -62,7 +63,7 @@ inline void _sbc_a_n(state_t &s, _reg8_t n) {
     s.regs.zero = !s.regs.a;
 }
 
-inline void _and_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _and_a_n(state_t &s, _reg8_t n) {
     s.regs.a = s.regs.a & n;
 
     s.regs.zero = (s.regs.a == 0);
@@ -71,7 +72,7 @@ inline void _and_a_n(state_t &s, _reg8_t n) {
     s.regs.carry = 0;
 }
 
-inline void _or_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _or_a_n(state_t &s, _reg8_t n) {
     s.regs.a = s.regs.a | n;
 
     s.regs.zero = (s.regs.a == 0);
@@ -80,7 +81,7 @@ inline void _or_a_n(state_t &s, _reg8_t n) {
     s.regs.carry = 0;
 }
 
-inline void _xor_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _xor_a_n(state_t &s, _reg8_t n) {
     s.regs.a = s.regs.a ^ n;
 
     s.regs.zero = (s.regs.a == 0);
@@ -89,14 +90,14 @@ inline void _xor_a_n(state_t &s, _reg8_t n) {
     s.regs.carry = 0;
 }
 
-inline void _cp_a_n(state_t &s, _reg8_t n) {
+static GB_DEVICE inline void _cp_a_n(state_t &s, _reg8_t n) {
     s.regs.zero = (s.regs.a == n);
     s.regs.subtract = 1;
     s.regs.half_carry = ((n & 0x0f) > (s.regs.a & 0x0f));
     s.regs.carry = (s.regs.a < n);
 }
 
-inline void _inc_reg8(state_t &s, _reg8_t &r) {
+static GB_DEVICE inline void _inc_reg8(state_t &s, _reg8_t &r) {
     s.regs.half_carry = (r & 0x0f) == 0x0f;
 
     r++;
@@ -105,7 +106,7 @@ inline void _inc_reg8(state_t &s, _reg8_t &r) {
     s.regs.zero = (r == 0);
 }
 
-inline void _dec_reg8(state_t &s, _reg8_t &r) {
+static GB_DEVICE inline void _dec_reg8(state_t &s, _reg8_t &r) {
     r--;
 
     s.regs.half_carry = (r & 0x0f) == 0x0f;
@@ -115,7 +116,7 @@ inline void _dec_reg8(state_t &s, _reg8_t &r) {
 
 // 16-Bit Arithmetic
 
-inline void _add_hl_reg16(state_t &s, _reg16_t r) {
+static GB_DEVICE inline void _add_hl_reg16(state_t &s, _reg16_t r) {
     uint32_t res = s.regs.hl + r;
 
     s.regs.subtract = 0;
@@ -125,7 +126,7 @@ inline void _add_hl_reg16(state_t &s, _reg16_t r) {
     s.regs.hl = (_reg16_t)res;
 }
 
-inline void _add_sp_u8(state_t &s, int8_t r) {
+static GB_DEVICE inline void _add_sp_u8(state_t &s, int8_t r) {
     uint32_t res = s.regs.sp + r;
 
     s.regs.zero = 0;
@@ -137,7 +138,7 @@ inline void _add_sp_u8(state_t &s, int8_t r) {
 }
 
 // Miscellaneous instructions
-inline uint8_t _swap_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _swap_n(state_t &s, uint8_t n) {
     uint8_t res = (n << 4) | (n >> 4);
     
     s.regs.zero = (res == 0);
@@ -148,18 +149,18 @@ inline uint8_t _swap_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline void _di(state_t &s) {
+static GB_DEVICE inline void _di(state_t &s) {
     s.interrupts_enabled = false;
 }
 
-inline void _ei(state_t &s) {
+static GB_DEVICE inline void _ei(state_t &s) {
     s.interrupts_enabled = true;
     // printf("interrupts enabled!\n");
 }
 
 // Rotate & Shifts instructions
 
-inline uint8_t _rlc_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _rlc_n(state_t &s, uint8_t n) {
     uint8_t carry = (n >> 7) & 0x01;
     uint8_t res = (n << 1) | carry;
 
@@ -171,7 +172,7 @@ inline uint8_t _rlc_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline uint8_t _rl_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _rl_n(state_t &s, uint8_t n) {
     uint8_t carry = (n >> 7) & 0x01;
     uint8_t res = (n << 1) | s.regs.carry;
 
@@ -183,7 +184,7 @@ inline uint8_t _rl_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline uint8_t _rrc_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _rrc_n(state_t &s, uint8_t n) {
     uint8_t carry = n & 0x01;
     uint8_t res = (n >> 1) | (carry << 7);
 
@@ -195,7 +196,7 @@ inline uint8_t _rrc_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline uint8_t _rr_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _rr_n(state_t &s, uint8_t n) {
     uint8_t carry = n & 0x01;
     uint8_t res = (n >> 1) | (s.regs.carry << 7);
 
@@ -207,7 +208,7 @@ inline uint8_t _rr_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline uint8_t _sla_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _sla_n(state_t &s, uint8_t n) {
     uint8_t carry = (n >> 7) & 0x01;
     uint8_t res = n << 1;
 
@@ -219,7 +220,7 @@ inline uint8_t _sla_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline uint8_t _sra_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _sra_n(state_t &s, uint8_t n) {
     uint8_t msb = n & (0x01 << 7);
     uint8_t carry = n & 0x01;
     uint8_t res = (n >> 1) | msb;
@@ -232,7 +233,7 @@ inline uint8_t _sra_n(state_t &s, uint8_t n) {
     return res;
 }
 
-inline uint8_t _srl_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline uint8_t _srl_n(state_t &s, uint8_t n) {
     uint8_t carry = n & 0x01;
     uint8_t res = n >> 1;
 
@@ -246,47 +247,45 @@ inline uint8_t _srl_n(state_t &s, uint8_t n) {
 
 // Bit Opcodes instructions
 
-inline void _bit_b_r(state_t &s, uint8_t bit, _reg8_t r) {
+static GB_DEVICE inline void _bit_b_r(state_t &s, uint8_t bit, _reg8_t r) {
     s.regs.zero = !(r & (0x01 << bit));
     s.regs.subtract = 0;
     s.regs.half_carry = 1;
 }
 
-inline uint8_t _set_b_r(state_t &s, uint8_t bit, uint8_t r) {
+static GB_DEVICE inline uint8_t _set_b_r(state_t &s, uint8_t bit, uint8_t r) {
     return r | (0x01 << bit);
 }
 
-inline uint8_t _res_b_r(state_t &s, uint8_t bit, uint8_t r) {
+static GB_DEVICE inline uint8_t _res_b_r(state_t &s, uint8_t bit, uint8_t r) {
     return r & ~(0x01 << bit);
 }
 
 // Jumps instructions
+// Handlers only report whether a conditional branch was taken; step() picks
+// the matching cost from inst_timings.
 
-inline void _jr_cc_n(state_t &s, bool cc) {
+static GB_DEVICE inline void _jr_cc_n(state_t &s, bool cc) {
     if (cc) {
         s.pc += (int8_t)s.operand;
         // printf("pc: %04x offset : %02X\n", s.pc, (int8_t)s.operand);
         // printf("jumping from %04x to %04x\n", s.prev_pc, s.pc);
-        // branch taken so set cycles to right amount
-        s.inst_cycles_wait = 12;
+        s.branch_taken = true;
     }
 }
 
-inline void _jp_nn(state_t &s) {
+static GB_DEVICE inline void _jp_nn(state_t &s) {
     // std::cout << "jumping from " << s.pc << " to " << s.operand << "\n";
     s.pc = s.operand;
-    // branch taken so set cycles to right amount
-    s.inst_cycles_wait = 16;
+    s.branch_taken = true;
 }
 
-inline void _call_nn(state_t &s) {
+static GB_DEVICE inline void _call_nn(state_t &s) {
     push_reg16(s, s.pc);
     _jp_nn(s);
-    // branch taken so set cycles to right amount
-    s.inst_cycles_wait = 24;
 }
 
-inline void _rst_n(state_t &s, uint8_t n) {
+static GB_DEVICE inline void _rst_n(state_t &s, uint8_t n) {
     push_reg16(s, s.pc);
     s.pc = 0x0000 + n;
 }
@@ -297,207 +296,212 @@ inline void _rst_n(state_t &s, uint8_t n) {
 // =============================================================
 
 // 0x00
-void nop(state_t &s) {
+static GB_DEVICE void nop(state_t &s) {
 }
 
 // 0x01
-void ld_bc_nn(state_t &s) {
+static GB_DEVICE void ld_bc_nn(state_t &s) {
     s.regs.bc = s.operand;
 }
 
 // 0x02
-void ld_bcp_a(state_t &s) {
+static GB_DEVICE void ld_bcp_a(state_t &s) {
     write_u8(s, s.regs.bc, s.regs.a);
 }
 
 // 0x03
-void inc_bc(state_t &s) {
+static GB_DEVICE void inc_bc(state_t &s) {
     s.regs.bc += 1;
 }
 
 // 0x04
-void inc_b(state_t &s) {
+static GB_DEVICE void inc_b(state_t &s) {
     _inc_reg8(s, s.regs.b);
 }
 
 // 0x05
-void dec_b(state_t &s) {
+static GB_DEVICE void dec_b(state_t &s) {
     _dec_reg8(s, s.regs.b);
 }
 
 // 0x06
-void ld_b_n(state_t &s) {
+static GB_DEVICE void ld_b_n(state_t &s) {
     s.regs.b = (_reg8_t)s.operand;
 }
 
 // 0x07
-void rlca(state_t &s) {
+static GB_DEVICE void rlca(state_t &s) {
     s.regs.a = _rlc_n(s, s.regs.a);
     s.regs.zero = 0;
 }
 
 // 0x08
-void ld_nnp_sp(state_t &s) {
+static GB_DEVICE void ld_nnp_sp(state_t &s) {
     write_u16(s, s.operand, s.regs.sp);
 }
 
 // 0x09
-void add_hl_bc(state_t &s) {
+static GB_DEVICE void add_hl_bc(state_t &s) {
     _add_hl_reg16(s, s.regs.bc);
 }
 
 // 0x0a
-void ld_a_bcp(state_t &s) {
+static GB_DEVICE void ld_a_bcp(state_t &s) {
     s.regs.a = read_u8(s, s.regs.bc);
 }
 
 // 0x0b
-void dec_bc(state_t &s) {
+static GB_DEVICE void dec_bc(state_t &s) {
     s.regs.bc -= 1;
 }
 
 // 0x0c
-void inc_c(state_t &s) {
+static GB_DEVICE void inc_c(state_t &s) {
     _inc_reg8(s, s.regs.c);
 }
 
 // 0x0d
-void dec_c(state_t &s) {
+static GB_DEVICE void dec_c(state_t &s) {
     _dec_reg8(s, s.regs.c);
 }
 
 // 0x0e
-void ld_c_n(state_t &s) {
+static GB_DEVICE void ld_c_n(state_t &s) {
     s.regs.c = (_reg8_t)s.operand;
 }
 
 // 0x0f
-void rrca(state_t &s) {
+static GB_DEVICE void rrca(state_t &s) {
     s.regs.a = _rrc_n(s, s.regs.a);
     s.regs.zero = 0;
 }
 
 // 0x10
-void stop(state_t &s) {
+static GB_DEVICE void stop(state_t &s) {
+    // on CGB, STOP with KEY1 armed is the speed switch
+    if (s.cgb.enabled && s.cgb.speed_prepare) {
+        cgb_speed_switch(s);
+        return;
+    }
     s.stop = true;
 }
 
 // 0x11
-void ld_de_nn(state_t &s) {
+static GB_DEVICE void ld_de_nn(state_t &s) {
     s.regs.de = s.operand;
 }
 
 // 0x12
-void ld_dep_a(state_t &s) {
+static GB_DEVICE void ld_dep_a(state_t &s) {
     write_u8(s, s.regs.de, s.regs.a);
 }
 
 // 0x13
-void inc_de(state_t &s) {
+static GB_DEVICE void inc_de(state_t &s) {
     s.regs.de += 1;
 }
 
 // 0x14
-void inc_d(state_t &s) {
+static GB_DEVICE void inc_d(state_t &s) {
     _inc_reg8(s, s.regs.d);
 }
 
 // 0x15
-void dec_d(state_t &s) {
+static GB_DEVICE void dec_d(state_t &s) {
     _dec_reg8(s, s.regs.d);
 }
 
 // 0x16
-void ld_d_n(state_t &s) {
+static GB_DEVICE void ld_d_n(state_t &s) {
     s.regs.d = (_reg8_t)s.operand;
 }
 
 // 0x17
-void rla(state_t &s) {
+static GB_DEVICE void rla(state_t &s) {
     s.regs.a = _rl_n(s, s.regs.a);
     s.regs.zero = 0;
 }
 
 // 0x18
-void jr_n(state_t &s) {
+static GB_DEVICE void jr_n(state_t &s) {
     s.pc += (int8_t)s.operand;
 }
 
 // 0x19
-void add_hl_de(state_t &s) {
+static GB_DEVICE void add_hl_de(state_t &s) {
     _add_hl_reg16(s, s.regs.de);
 }
 
 // 0x1a
-void ld_a_dep(state_t &s) {
+static GB_DEVICE void ld_a_dep(state_t &s) {
     s.regs.a = read_u8(s, s.regs.de);
 }
 
 // 0x1b
-void dec_de(state_t &s) {
+static GB_DEVICE void dec_de(state_t &s) {
     s.regs.de -= 1;
 }
 
 // 0x1c
-void inc_e(state_t &s) {
+static GB_DEVICE void inc_e(state_t &s) {
     _inc_reg8(s, s.regs.e);
 }
 
 // 0x1d
-void dec_e(state_t &s) {
+static GB_DEVICE void dec_e(state_t &s) {
     _dec_reg8(s, s.regs.e);
 }
 
 // 0x1e
-void ld_e_n(state_t &s) {
+static GB_DEVICE void ld_e_n(state_t &s) {
     s.regs.e = (_reg8_t)s.operand;
 }
 
 // 0x1f
-void rra(state_t &s) {
+static GB_DEVICE void rra(state_t &s) {
     s.regs.a = _rr_n(s, s.regs.a);
     s.regs.zero = 0;
 }
 
 
 // 0x20
-void jr_nz_n(state_t &s) {
+static GB_DEVICE void jr_nz_n(state_t &s) {
     _jr_cc_n(s, !s.regs.zero);
 }
 
 // 0x21
-void ld_hl_nn(state_t &s) {
+static GB_DEVICE void ld_hl_nn(state_t &s) {
     s.regs.hl = s.operand;
 }
 
 // 0x22
-void ldi_hlp_a(state_t &s) {
+static GB_DEVICE void ldi_hlp_a(state_t &s) {
     write_u8(s, s.regs.hl, s.regs.a);
     s.regs.hl += 1;
 }
 
 // 0x23
-void inc_hl(state_t &s) {
+static GB_DEVICE void inc_hl(state_t &s) {
     s.regs.hl += 1;
 }
 
 // 0x24
-void inc_h(state_t &s) {
+static GB_DEVICE void inc_h(state_t &s) {
     _inc_reg8(s, s.regs.h);
 }
 
 // 0x25
-void dec_h(state_t &s) {
+static GB_DEVICE void dec_h(state_t &s) {
     _dec_reg8(s, s.regs.h);
 }
 
 // 0x26
-void ld_h_n(state_t &s) {
+static GB_DEVICE void ld_h_n(state_t &s) {
     s.regs.h = (_reg8_t)s.operand;
 }
 
 // 0x27
-void daa(state_t &s) {
+static GB_DEVICE void daa(state_t &s) {
     _reg8_t a = s.regs.a;
 
     if (!s.regs.subtract) {
@@ -524,43 +528,43 @@ void daa(state_t &s) {
 }
 
 // 0x28
-void jr_z_n(state_t &s) {
+static GB_DEVICE void jr_z_n(state_t &s) {
     _jr_cc_n(s, s.regs.zero);
 }
 
 // 0x29
-void add_hl_hl(state_t &s) {
+static GB_DEVICE void add_hl_hl(state_t &s) {
     _add_hl_reg16(s, s.regs.hl);
 }
 
 // 0x2a
-void ldi_a_hlp(state_t &s) {
+static GB_DEVICE void ldi_a_hlp(state_t &s) {
     s.regs.a = read_u8(s, s.regs.hl);
     s.regs.hl += 1;
 }
 
 // 0x2b
-void dec_hl(state_t &s) {
+static GB_DEVICE void dec_hl(state_t &s) {
     s.regs.hl -= 1;
 }
 
 // 0x2c
-void inc_l(state_t &s) {
+static GB_DEVICE void inc_l(state_t &s) {
     _inc_reg8(s, s.regs.l);
 }
 
 // 0x2d
-void dec_l(state_t &s) {
+static GB_DEVICE void dec_l(state_t &s) {
     _dec_reg8(s, s.regs.l);
 }
 
 // 0x2e
-void ld_l_n(state_t &s) {
+static GB_DEVICE void ld_l_n(state_t &s) {
     s.regs.l = (_reg8_t)s.operand;
 }
 
 // 0x2f
-void cpl(state_t &s) {
+static GB_DEVICE void cpl(state_t &s) {
     s.regs.a = ~s.regs.a;
 
     s.regs.half_carry = 1;
@@ -569,90 +573,90 @@ void cpl(state_t &s) {
 
 
 // 0x30
-void jr_nc_n(state_t &s) {
+static GB_DEVICE void jr_nc_n(state_t &s) {
     _jr_cc_n(s, !s.regs.carry);
 }
 
 // 0x31
-void ld_sp_nn(state_t &s) {
+static GB_DEVICE void ld_sp_nn(state_t &s) {
     s.regs.sp = s.operand;
 }
 
 // 0x32
-void ldd_hlp_a(state_t &s) {
+static GB_DEVICE void ldd_hlp_a(state_t &s) {
     write_u8(s, s.regs.hl, s.regs.a);
     s.regs.hl -= 1;
 }
 
 // 0x33
-void inc_sp(state_t &s) {
+static GB_DEVICE void inc_sp(state_t &s) {
     s.regs.sp += 1;
 }
 
 // 0x34
-void inc_hlp(state_t &s) {
+static GB_DEVICE void inc_hlp(state_t &s) {
     _reg8_t hlp = read_u8(s, s.regs.hl);
     _inc_reg8(s, hlp);
     write_u8(s, s.regs.hl, hlp);
 }
 
 // 0x35
-void dec_hlp(state_t &s) {
+static GB_DEVICE void dec_hlp(state_t &s) {
     _reg8_t hlp = read_u8(s, s.regs.hl);
     _dec_reg8(s, hlp);
     write_u8(s, s.regs.hl, hlp);
 }
 
 // 0x36
-void ld_hlp_n(state_t &s) {
+static GB_DEVICE void ld_hlp_n(state_t &s) {
     write_u8(s, s.regs.hl, (_reg8_t)s.operand);
 }
 
 // 0x37
-void scf(state_t &s) {
+static GB_DEVICE void scf(state_t &s) {
     s.regs.subtract = 0;
     s.regs.half_carry = 0;
     s.regs.carry = 1;
 }
 
 // 0x38
-void jr_c_n(state_t &s) {
+static GB_DEVICE void jr_c_n(state_t &s) {
     _jr_cc_n(s, s.regs.carry);
 }
 
 // 0x39
-void add_hl_sp(state_t &s) {
+static GB_DEVICE void add_hl_sp(state_t &s) {
     _add_hl_reg16(s, s.regs.sp);
 }
 
 // 0x3a
-void ldd_a_hlp(state_t &s) {
+static GB_DEVICE void ldd_a_hlp(state_t &s) {
     s.regs.a = read_u8(s, s.regs.hl);
     s.regs.hl -= 1;
 }
 
 // 0x3b
-void dec_sp(state_t &s) {
+static GB_DEVICE void dec_sp(state_t &s) {
     s.regs.sp -= 1;
 }
 
 // 0x3c
-void inc_a(state_t &s) {
+static GB_DEVICE void inc_a(state_t &s) {
     _inc_reg8(s, s.regs.a);
 }
 
 // 0x3d
-void dec_a(state_t &s) {
+static GB_DEVICE void dec_a(state_t &s) {
     _dec_reg8(s, s.regs.a);
 }
 
 // 0x3e
-void ld_a_n(state_t &s) {
+static GB_DEVICE void ld_a_n(state_t &s) {
     s.regs.a = (_reg8_t)s.operand;
 }
 
 // 0x3f
-void ccf(state_t &s) {
+static GB_DEVICE void ccf(state_t &s) {
     s.regs.subtract = 0;
     s.regs.half_carry = 0;
     s.regs.carry ^= 1;
@@ -660,655 +664,659 @@ void ccf(state_t &s) {
 
 
 // 0x40
-void ld_b_b(state_t &s) { s.regs.b = s.regs.b; }
+static GB_DEVICE void ld_b_b(state_t &s) { s.regs.b = s.regs.b; }
 
 // 0x41
-void ld_b_c(state_t &s) { s.regs.b = s.regs.c; }
+static GB_DEVICE void ld_b_c(state_t &s) { s.regs.b = s.regs.c; }
 
 // 0x42
-void ld_b_d(state_t &s) { s.regs.b = s.regs.d; }
+static GB_DEVICE void ld_b_d(state_t &s) { s.regs.b = s.regs.d; }
 
 // 0x43
-void ld_b_e(state_t &s) { s.regs.b = s.regs.e; }
+static GB_DEVICE void ld_b_e(state_t &s) { s.regs.b = s.regs.e; }
 
 // 0x44
-void ld_b_h(state_t &s) { s.regs.b = s.regs.h; }
+static GB_DEVICE void ld_b_h(state_t &s) { s.regs.b = s.regs.h; }
 
 // 0x45
-void ld_b_l(state_t &s) { s.regs.b = s.regs.l; }
+static GB_DEVICE void ld_b_l(state_t &s) { s.regs.b = s.regs.l; }
 
 // 0x46
-void ld_b_hlp(state_t &s) { s.regs.b = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_b_hlp(state_t &s) { s.regs.b = read_u8(s, s.regs.hl); }
 
 // 0x47
-void ld_b_a(state_t &s) { s.regs.b = s.regs.a; }
+static GB_DEVICE void ld_b_a(state_t &s) { s.regs.b = s.regs.a; }
 
 // 0x48
-void ld_c_b(state_t &s) { s.regs.c = s.regs.b; }
+static GB_DEVICE void ld_c_b(state_t &s) { s.regs.c = s.regs.b; }
 
 // 0x49
-void ld_c_c(state_t &s) { s.regs.c = s.regs.c; }
+static GB_DEVICE void ld_c_c(state_t &s) { s.regs.c = s.regs.c; }
 
 // 0x4a
-void ld_c_d(state_t &s) { s.regs.c = s.regs.d; }
+static GB_DEVICE void ld_c_d(state_t &s) { s.regs.c = s.regs.d; }
 
 // 0x4b
-void ld_c_e(state_t &s) { s.regs.c = s.regs.e; }
+static GB_DEVICE void ld_c_e(state_t &s) { s.regs.c = s.regs.e; }
 
 // 0x4c
-void ld_c_h(state_t &s) { s.regs.c = s.regs.h; }
+static GB_DEVICE void ld_c_h(state_t &s) { s.regs.c = s.regs.h; }
 
 // 0x4d
-void ld_c_l(state_t &s) { s.regs.c = s.regs.l; }
+static GB_DEVICE void ld_c_l(state_t &s) { s.regs.c = s.regs.l; }
 
 // 0x4e
-void ld_c_hlp(state_t &s) { s.regs.c = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_c_hlp(state_t &s) { s.regs.c = read_u8(s, s.regs.hl); }
 
 // 0x4f
-void ld_c_a(state_t &s) { s.regs.c = s.regs.a; }
+static GB_DEVICE void ld_c_a(state_t &s) { s.regs.c = s.regs.a; }
 
 // 0x50
-void ld_d_b(state_t &s) { s.regs.d = s.regs.b; }
+static GB_DEVICE void ld_d_b(state_t &s) { s.regs.d = s.regs.b; }
 
 // 0x51
-void ld_d_c(state_t &s) { s.regs.d = s.regs.c; }
+static GB_DEVICE void ld_d_c(state_t &s) { s.regs.d = s.regs.c; }
 
 // 0x52
-void ld_d_d(state_t &s) { s.regs.d = s.regs.d; }
+static GB_DEVICE void ld_d_d(state_t &s) { s.regs.d = s.regs.d; }
 
 // 0x53
-void ld_d_e(state_t &s) { s.regs.d = s.regs.e; }
+static GB_DEVICE void ld_d_e(state_t &s) { s.regs.d = s.regs.e; }
 
 // 0x54
-void ld_d_h(state_t &s) { s.regs.d = s.regs.h; }
+static GB_DEVICE void ld_d_h(state_t &s) { s.regs.d = s.regs.h; }
 
 // 0x55
-void ld_d_l(state_t &s) { s.regs.d = s.regs.l; }
+static GB_DEVICE void ld_d_l(state_t &s) { s.regs.d = s.regs.l; }
 
 // 0x56
-void ld_d_hlp(state_t &s) { s.regs.d = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_d_hlp(state_t &s) { s.regs.d = read_u8(s, s.regs.hl); }
 
 // 0x57
-void ld_d_a(state_t &s) { s.regs.d = s.regs.a; }
+static GB_DEVICE void ld_d_a(state_t &s) { s.regs.d = s.regs.a; }
 
 // 0x58
-void ld_e_b(state_t &s) { s.regs.e = s.regs.b; }
+static GB_DEVICE void ld_e_b(state_t &s) { s.regs.e = s.regs.b; }
 
 // 0x59
-void ld_e_c(state_t &s) { s.regs.e = s.regs.c; }
+static GB_DEVICE void ld_e_c(state_t &s) { s.regs.e = s.regs.c; }
 
 // 0x5a
-void ld_e_d(state_t &s) { s.regs.e = s.regs.d; }
+static GB_DEVICE void ld_e_d(state_t &s) { s.regs.e = s.regs.d; }
 
 // 0x5b
-void ld_e_e(state_t &s) { s.regs.e = s.regs.e; }
+static GB_DEVICE void ld_e_e(state_t &s) { s.regs.e = s.regs.e; }
 
 // 0x5c
-void ld_e_h(state_t &s) { s.regs.e = s.regs.h; }
+static GB_DEVICE void ld_e_h(state_t &s) { s.regs.e = s.regs.h; }
 
 // 0x5d
-void ld_e_l(state_t &s) { s.regs.e = s.regs.l; }
+static GB_DEVICE void ld_e_l(state_t &s) { s.regs.e = s.regs.l; }
 
 // 0x5e
-void ld_e_hlp(state_t &s) { s.regs.e = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_e_hlp(state_t &s) { s.regs.e = read_u8(s, s.regs.hl); }
 
 // 0x5f
-void ld_e_a(state_t &s) { s.regs.e = s.regs.a; }
+static GB_DEVICE void ld_e_a(state_t &s) { s.regs.e = s.regs.a; }
 
 // 0x60
-void ld_h_b(state_t &s) { s.regs.h = s.regs.b; }
+static GB_DEVICE void ld_h_b(state_t &s) { s.regs.h = s.regs.b; }
 
 // 0x61
-void ld_h_c(state_t &s) { s.regs.h = s.regs.c; }
+static GB_DEVICE void ld_h_c(state_t &s) { s.regs.h = s.regs.c; }
 
 // 0x62
-void ld_h_d(state_t &s) { s.regs.h = s.regs.d; }
+static GB_DEVICE void ld_h_d(state_t &s) { s.regs.h = s.regs.d; }
 
 // 0x63
-void ld_h_e(state_t &s) { s.regs.h = s.regs.e; }
+static GB_DEVICE void ld_h_e(state_t &s) { s.regs.h = s.regs.e; }
 
 // 0x64
-void ld_h_h(state_t &s) { s.regs.h = s.regs.h; }
+static GB_DEVICE void ld_h_h(state_t &s) { s.regs.h = s.regs.h; }
 
 // 0x65
-void ld_h_l(state_t &s) { s.regs.h = s.regs.l; }
+static GB_DEVICE void ld_h_l(state_t &s) { s.regs.h = s.regs.l; }
 
 // 0x66
-void ld_h_hlp(state_t &s) { s.regs.h = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_h_hlp(state_t &s) { s.regs.h = read_u8(s, s.regs.hl); }
 
 // 0x67
-void ld_h_a(state_t &s) { s.regs.h = s.regs.a; }
+static GB_DEVICE void ld_h_a(state_t &s) { s.regs.h = s.regs.a; }
 
 // 0x68
-void ld_l_b(state_t &s) { s.regs.l = s.regs.b; }
+static GB_DEVICE void ld_l_b(state_t &s) { s.regs.l = s.regs.b; }
 
 // 0x69
-void ld_l_c(state_t &s) { s.regs.l = s.regs.c; }
+static GB_DEVICE void ld_l_c(state_t &s) { s.regs.l = s.regs.c; }
 
 // 0x6a
-void ld_l_d(state_t &s) { s.regs.l = s.regs.d; }
+static GB_DEVICE void ld_l_d(state_t &s) { s.regs.l = s.regs.d; }
 
 // 0x6b
-void ld_l_e(state_t &s) { s.regs.l = s.regs.e; }
+static GB_DEVICE void ld_l_e(state_t &s) { s.regs.l = s.regs.e; }
 
 // 0x6c
-void ld_l_h(state_t &s) { s.regs.l = s.regs.h; }
+static GB_DEVICE void ld_l_h(state_t &s) { s.regs.l = s.regs.h; }
 
 // 0x6d
-void ld_l_l(state_t &s) { s.regs.l = s.regs.l; }
+static GB_DEVICE void ld_l_l(state_t &s) { s.regs.l = s.regs.l; }
 
 // 0x6e
-void ld_l_hlp(state_t &s) { s.regs.l = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_l_hlp(state_t &s) { s.regs.l = read_u8(s, s.regs.hl); }
 
 // 0x6f
-void ld_l_a(state_t &s) { s.regs.l = s.regs.a; }
+static GB_DEVICE void ld_l_a(state_t &s) { s.regs.l = s.regs.a; }
 
 // 0x70
-void ld_hlp_b(state_t &s) { write_u8(s, s.regs.hl, s.regs.b); }
+static GB_DEVICE void ld_hlp_b(state_t &s) { write_u8(s, s.regs.hl, s.regs.b); }
 
 // 0x71
-void ld_hlp_c(state_t &s) { write_u8(s, s.regs.hl, s.regs.c); }
+static GB_DEVICE void ld_hlp_c(state_t &s) { write_u8(s, s.regs.hl, s.regs.c); }
 
 // 0x72
-void ld_hlp_d(state_t &s) {write_u8(s, s.regs.hl, s.regs.d); }
+static GB_DEVICE void ld_hlp_d(state_t &s) {write_u8(s, s.regs.hl, s.regs.d); }
 
 // 0x73
-void ld_hlp_e(state_t &s) { write_u8(s, s.regs.hl, s.regs.e); }
+static GB_DEVICE void ld_hlp_e(state_t &s) { write_u8(s, s.regs.hl, s.regs.e); }
 
 // 0x74
-void ld_hlp_h(state_t &s) { write_u8(s, s.regs.hl, s.regs.h); }
+static GB_DEVICE void ld_hlp_h(state_t &s) { write_u8(s, s.regs.hl, s.regs.h); }
 
 // 0x75
-void ld_hlp_l(state_t &s) { write_u8(s, s.regs.hl, s.regs.l); }
+static GB_DEVICE void ld_hlp_l(state_t &s) { write_u8(s, s.regs.hl, s.regs.l); }
 
 // 0x76
-void halt(state_t &s) { 
+static GB_DEVICE void halt(state_t &s) { 
     s.halt = true;
     // printf("halted! ei: %d, if: %d\n", s.interrupts_enabled, read_u8(s, IE));
 }
 
 // 0x77
-void ld_hlp_a(state_t &s) { write_u8(s, s.regs.hl, s.regs.a); }
+static GB_DEVICE void ld_hlp_a(state_t &s) { write_u8(s, s.regs.hl, s.regs.a); }
 
 // 0x78
-void ld_a_b(state_t &s) { s.regs.a = s.regs.b; }
+static GB_DEVICE void ld_a_b(state_t &s) { s.regs.a = s.regs.b; }
 
 // 0x79
-void ld_a_c(state_t &s) { s.regs.a = s.regs.c; }
+static GB_DEVICE void ld_a_c(state_t &s) { s.regs.a = s.regs.c; }
 
 // 0x7a
-void ld_a_d(state_t &s) { s.regs.a = s.regs.d; }
+static GB_DEVICE void ld_a_d(state_t &s) { s.regs.a = s.regs.d; }
 
 // 0x7b
-void ld_a_e(state_t &s) { s.regs.a = s.regs.e; }
+static GB_DEVICE void ld_a_e(state_t &s) { s.regs.a = s.regs.e; }
 
 // 0x7c
-void ld_a_h(state_t &s) { s.regs.a = s.regs.h; }
+static GB_DEVICE void ld_a_h(state_t &s) { s.regs.a = s.regs.h; }
 
 // 0x7d
-void ld_a_l(state_t &s) { s.regs.a = s.regs.l; }
+static GB_DEVICE void ld_a_l(state_t &s) { s.regs.a = s.regs.l; }
 
 // 0x7e
-void ld_a_hlp(state_t &s) { s.regs.a = read_u8(s, s.regs.hl); }
+static GB_DEVICE void ld_a_hlp(state_t &s) { s.regs.a = read_u8(s, s.regs.hl); }
 
 // 0x7f
-void ld_a_a(state_t &s) { s.regs.a = s.regs.a; }
+static GB_DEVICE void ld_a_a(state_t &s) { s.regs.a = s.regs.a; }
 
 
 // 0x80
-void add_a_b(state_t &s) { _add_a_n(s, s.regs.b); }
+static GB_DEVICE void add_a_b(state_t &s) { _add_a_n(s, s.regs.b); }
 
 // 0x81
-void add_a_c(state_t &s) { _add_a_n(s, s.regs.c); }
+static GB_DEVICE void add_a_c(state_t &s) { _add_a_n(s, s.regs.c); }
 
 // 0x82
-void add_a_d(state_t &s) { _add_a_n(s, s.regs.d); }
+static GB_DEVICE void add_a_d(state_t &s) { _add_a_n(s, s.regs.d); }
 
 // 0x83
-void add_a_e(state_t &s) { _add_a_n(s, s.regs.e); }
+static GB_DEVICE void add_a_e(state_t &s) { _add_a_n(s, s.regs.e); }
 
 // 0x84
-void add_a_h(state_t &s) { _add_a_n(s, s.regs.h); }
+static GB_DEVICE void add_a_h(state_t &s) { _add_a_n(s, s.regs.h); }
 
 // 0x85
-void add_a_l(state_t &s) { _add_a_n(s, s.regs.l); }
+static GB_DEVICE void add_a_l(state_t &s) { _add_a_n(s, s.regs.l); }
 
 // 0x86
-void add_a_hlp(state_t &s) { _add_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void add_a_hlp(state_t &s) { _add_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0x87
-void add_a_a(state_t &s) { _add_a_n(s, s.regs.a); }
+static GB_DEVICE void add_a_a(state_t &s) { _add_a_n(s, s.regs.a); }
 
 // 0x88
-void adc_a_b(state_t &s) { _adc_a_n(s, s.regs.b); }
+static GB_DEVICE void adc_a_b(state_t &s) { _adc_a_n(s, s.regs.b); }
 
 // 0x89
-void adc_a_c(state_t &s) { _adc_a_n(s, s.regs.c); }
+static GB_DEVICE void adc_a_c(state_t &s) { _adc_a_n(s, s.regs.c); }
 
 // 0x8a
-void adc_a_d(state_t &s) { _adc_a_n(s, s.regs.d); }
+static GB_DEVICE void adc_a_d(state_t &s) { _adc_a_n(s, s.regs.d); }
 
 // 0x8b
-void adc_a_e(state_t &s) { _adc_a_n(s, s.regs.e); }
+static GB_DEVICE void adc_a_e(state_t &s) { _adc_a_n(s, s.regs.e); }
 
 // 0x8c
-void adc_a_h(state_t &s) { _adc_a_n(s, s.regs.h); }
+static GB_DEVICE void adc_a_h(state_t &s) { _adc_a_n(s, s.regs.h); }
 
 // 0x8d
-void adc_a_l(state_t &s) { _adc_a_n(s, s.regs.l); }
+static GB_DEVICE void adc_a_l(state_t &s) { _adc_a_n(s, s.regs.l); }
 
 // 0x8e
-void adc_a_hlp(state_t &s) { _adc_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void adc_a_hlp(state_t &s) { _adc_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0x8f
-void adc_a_a(state_t &s) { _adc_a_n(s, s.regs.a); }
+static GB_DEVICE void adc_a_a(state_t &s) { _adc_a_n(s, s.regs.a); }
 
 // 0x90
-void sub_a_b(state_t &s) { _sub_a_n(s, s.regs.b); }
+static GB_DEVICE void sub_a_b(state_t &s) { _sub_a_n(s, s.regs.b); }
 
 // 0x91
-void sub_a_c(state_t &s) { _sub_a_n(s, s.regs.c); }
+static GB_DEVICE void sub_a_c(state_t &s) { _sub_a_n(s, s.regs.c); }
 
 // 0x92
-void sub_a_d(state_t &s) { _sub_a_n(s, s.regs.d); }
+static GB_DEVICE void sub_a_d(state_t &s) { _sub_a_n(s, s.regs.d); }
 
 // 0x93
-void sub_a_e(state_t &s) { _sub_a_n(s, s.regs.e); }
+static GB_DEVICE void sub_a_e(state_t &s) { _sub_a_n(s, s.regs.e); }
 
 // 0x94
-void sub_a_h(state_t &s) { _sub_a_n(s, s.regs.h); }
+static GB_DEVICE void sub_a_h(state_t &s) { _sub_a_n(s, s.regs.h); }
 
 // 0x95
-void sub_a_l(state_t &s) { _sub_a_n(s, s.regs.l); }
+static GB_DEVICE void sub_a_l(state_t &s) { _sub_a_n(s, s.regs.l); }
 
 // 0x96
-void sub_a_hlp(state_t &s) { _sub_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void sub_a_hlp(state_t &s) { _sub_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0x97
-void sub_a_a(state_t &s) { _sub_a_n(s, s.regs.a); }
+static GB_DEVICE void sub_a_a(state_t &s) { _sub_a_n(s, s.regs.a); }
 
 // 0x98
-void sbc_a_b(state_t &s) { _sbc_a_n(s, s.regs.b); }
+static GB_DEVICE void sbc_a_b(state_t &s) { _sbc_a_n(s, s.regs.b); }
 
 // 0x99
-void sbc_a_c(state_t &s) { _sbc_a_n(s, s.regs.c); }
+static GB_DEVICE void sbc_a_c(state_t &s) { _sbc_a_n(s, s.regs.c); }
 
 // 0x9a
-void sbc_a_d(state_t &s) { _sbc_a_n(s, s.regs.d); }
+static GB_DEVICE void sbc_a_d(state_t &s) { _sbc_a_n(s, s.regs.d); }
 
 // 0x9b
-void sbc_a_e(state_t &s) { _sbc_a_n(s, s.regs.e); }
+static GB_DEVICE void sbc_a_e(state_t &s) { _sbc_a_n(s, s.regs.e); }
 
 // 0x9c
-void sbc_a_h(state_t &s) { _sbc_a_n(s, s.regs.h); }
+static GB_DEVICE void sbc_a_h(state_t &s) { _sbc_a_n(s, s.regs.h); }
 
 // 0x9d
-void sbc_a_l(state_t &s) { _sbc_a_n(s, s.regs.l); }
+static GB_DEVICE void sbc_a_l(state_t &s) { _sbc_a_n(s, s.regs.l); }
 
 // 0x9e
-void sbc_a_hlp(state_t &s) { _sbc_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void sbc_a_hlp(state_t &s) { _sbc_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0x9f
-void sbc_a_a(state_t &s) { _sbc_a_n(s, s.regs.a); }
+static GB_DEVICE void sbc_a_a(state_t &s) { _sbc_a_n(s, s.regs.a); }
 
 // 0xa0
-void and_a_b(state_t &s) { _and_a_n(s, s.regs.b); }
+static GB_DEVICE void and_a_b(state_t &s) { _and_a_n(s, s.regs.b); }
 
 // 0xa1
-void and_a_c(state_t &s) { _and_a_n(s, s.regs.c); }
+static GB_DEVICE void and_a_c(state_t &s) { _and_a_n(s, s.regs.c); }
 
 // 0xa2
-void and_a_d(state_t &s) { _and_a_n(s, s.regs.d); }
+static GB_DEVICE void and_a_d(state_t &s) { _and_a_n(s, s.regs.d); }
 
 // 0xa3
-void and_a_e(state_t &s) { _and_a_n(s, s.regs.e); }
+static GB_DEVICE void and_a_e(state_t &s) { _and_a_n(s, s.regs.e); }
 
 // 0xa4
-void and_a_h(state_t &s) { _and_a_n(s, s.regs.h); }
+static GB_DEVICE void and_a_h(state_t &s) { _and_a_n(s, s.regs.h); }
 
 // 0xa5
-void and_a_l(state_t &s) { _and_a_n(s, s.regs.l); }
+static GB_DEVICE void and_a_l(state_t &s) { _and_a_n(s, s.regs.l); }
 
 // 0xa6
-void and_a_hlp(state_t &s) { _and_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void and_a_hlp(state_t &s) { _and_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0xa7
-void and_a_a(state_t &s) { _and_a_n(s, s.regs.a); }
+static GB_DEVICE void and_a_a(state_t &s) { _and_a_n(s, s.regs.a); }
 
 // 0xa8
-void xor_a_b(state_t &s) { _xor_a_n(s, s.regs.b); }
+static GB_DEVICE void xor_a_b(state_t &s) { _xor_a_n(s, s.regs.b); }
 
 // 0xa9
-void xor_a_c(state_t &s) { _xor_a_n(s, s.regs.c); }
+static GB_DEVICE void xor_a_c(state_t &s) { _xor_a_n(s, s.regs.c); }
 
 // 0xaa
-void xor_a_d(state_t &s) { _xor_a_n(s, s.regs.d); }
+static GB_DEVICE void xor_a_d(state_t &s) { _xor_a_n(s, s.regs.d); }
 
 // 0xab
-void xor_a_e(state_t &s) { _xor_a_n(s, s.regs.e); }
+static GB_DEVICE void xor_a_e(state_t &s) { _xor_a_n(s, s.regs.e); }
 
 // 0xac
-void xor_a_h(state_t &s) { _xor_a_n(s, s.regs.h); }
+static GB_DEVICE void xor_a_h(state_t &s) { _xor_a_n(s, s.regs.h); }
 
 // 0xad
-void xor_a_l(state_t &s) { _xor_a_n(s, s.regs.l); }
+static GB_DEVICE void xor_a_l(state_t &s) { _xor_a_n(s, s.regs.l); }
 
 // 0xae
-void xor_a_hlp(state_t &s) { _xor_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void xor_a_hlp(state_t &s) { _xor_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0xaf
-void xor_a_a(state_t &s) { _xor_a_n(s, s.regs.a); }
+static GB_DEVICE void xor_a_a(state_t &s) { _xor_a_n(s, s.regs.a); }
 
 // 0xb0
-void or_a_b(state_t &s) { _or_a_n(s, s.regs.b); }
+static GB_DEVICE void or_a_b(state_t &s) { _or_a_n(s, s.regs.b); }
 
 // 0xb1
-void or_a_c(state_t &s) { _or_a_n(s, s.regs.c); }
+static GB_DEVICE void or_a_c(state_t &s) { _or_a_n(s, s.regs.c); }
 
 // 0xb2
-void or_a_d(state_t &s) { _or_a_n(s, s.regs.d); }
+static GB_DEVICE void or_a_d(state_t &s) { _or_a_n(s, s.regs.d); }
 
 // 0xb3
-void or_a_e(state_t &s) { _or_a_n(s, s.regs.e); }
+static GB_DEVICE void or_a_e(state_t &s) { _or_a_n(s, s.regs.e); }
 
 // 0xb4
-void or_a_h(state_t &s) { _or_a_n(s, s.regs.h); }
+static GB_DEVICE void or_a_h(state_t &s) { _or_a_n(s, s.regs.h); }
 
 // 0xb5
-void or_a_l(state_t &s) { _or_a_n(s, s.regs.l); }
+static GB_DEVICE void or_a_l(state_t &s) { _or_a_n(s, s.regs.l); }
 
 // 0xb6
-void or_a_hlp(state_t &s) { _or_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void or_a_hlp(state_t &s) { _or_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0xb7
-void or_a_a(state_t &s) { _or_a_n(s, s.regs.a); }
+static GB_DEVICE void or_a_a(state_t &s) { _or_a_n(s, s.regs.a); }
 
 // 0xb8
-void cp_a_b(state_t &s) { _cp_a_n(s, s.regs.b); }
+static GB_DEVICE void cp_a_b(state_t &s) { _cp_a_n(s, s.regs.b); }
 
 // 0xb9
-void cp_a_c(state_t &s) { _cp_a_n(s, s.regs.c); }
+static GB_DEVICE void cp_a_c(state_t &s) { _cp_a_n(s, s.regs.c); }
 
 // 0xba
-void cp_a_d(state_t &s) { _cp_a_n(s, s.regs.d); }
+static GB_DEVICE void cp_a_d(state_t &s) { _cp_a_n(s, s.regs.d); }
 
 // 0xbb
-void cp_a_e(state_t &s) { _cp_a_n(s, s.regs.e); }
+static GB_DEVICE void cp_a_e(state_t &s) { _cp_a_n(s, s.regs.e); }
 
 // 0xbc
-void cp_a_h(state_t &s) { _cp_a_n(s, s.regs.h); }
+static GB_DEVICE void cp_a_h(state_t &s) { _cp_a_n(s, s.regs.h); }
 
 // 0xbd
-void cp_a_l(state_t &s) { _cp_a_n(s, s.regs.l); }
+static GB_DEVICE void cp_a_l(state_t &s) { _cp_a_n(s, s.regs.l); }
 
 // 0xbe
-void cp_a_hlp(state_t &s) { _cp_a_n(s, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void cp_a_hlp(state_t &s) { _cp_a_n(s, read_u8(s, s.regs.hl)); }
 
 // 0xbf
-void cp_a_a(state_t &s) { _cp_a_n(s, s.regs.a); }
+static GB_DEVICE void cp_a_a(state_t &s) { _cp_a_n(s, s.regs.a); }
 
 
 // 0xc0
-void ret_nz(state_t &s) {
+static GB_DEVICE void ret_nz(state_t &s) {
     if (!s.regs.zero) {
         pop_reg16(s, s.pc);
+        s.branch_taken = true;
     }
 }
 
 // 0xc1
-void pop_bc(state_t &s) { pop_reg16(s, s.regs.bc); }
+static GB_DEVICE void pop_bc(state_t &s) { pop_reg16(s, s.regs.bc); }
 
 // 0xc2
-void jp_nz_nn(state_t &s) {
+static GB_DEVICE void jp_nz_nn(state_t &s) {
     if (!s.regs.zero) {
         _jp_nn(s);
     }
 }
 
 // 0xc3
-void jp_nn(state_t &s) {
+static GB_DEVICE void jp_nn(state_t &s) {
     _jp_nn(s);
 }
 
 // 0xc4
-void call_nz_nn(state_t &s) {
+static GB_DEVICE void call_nz_nn(state_t &s) {
     if (!s.regs.zero) {
         _call_nn(s);
     }
 }
 
 // 0xc5
-void push_bc(state_t &s) {
+static GB_DEVICE void push_bc(state_t &s) {
     push_reg16(s, s.regs.bc);
 }
 
 // 0xc6
-void add_a_n(state_t &s) {
+static GB_DEVICE void add_a_n(state_t &s) {
     _add_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xc7
-void rst_00h(state_t &s) {
+static GB_DEVICE void rst_00h(state_t &s) {
     _rst_n(s, 0x00);
 }
 
 // 0xc8
-void ret_z(state_t &s) {
+static GB_DEVICE void ret_z(state_t &s) {
     if (s.regs.zero) {
         pop_reg16(s, s.pc);
+        s.branch_taken = true;
     }
 }
 
 // 0xc9
-void ret(state_t &s) {
+static GB_DEVICE void ret(state_t &s) {
     pop_reg16(s, s.pc);
 }
 
 // 0xca
-void jp_z_nn(state_t &s) {
+static GB_DEVICE void jp_z_nn(state_t &s) {
     if (s.regs.zero) {
         _jp_nn(s);
     }
 }
 
 // 0xcb
-void prefix_cb(state_t &s) {
+static GB_DEVICE void prefix_cb(state_t &s) {
     s.prefixed = true;
 }
 
 // 0xcc
-void call_z_nn(state_t &s) {
+static GB_DEVICE void call_z_nn(state_t &s) {
     if (s.regs.zero) {
         _call_nn(s);
     }
 }
 
 // 0xcd
-void call_nn(state_t &s) {
+static GB_DEVICE void call_nn(state_t &s) {
     _call_nn(s);
 }
 
 // 0xce
-void adc_a_n(state_t &s) {
+static GB_DEVICE void adc_a_n(state_t &s) {
     _adc_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xcf
-void rst_08h(state_t &s) {
+static GB_DEVICE void rst_08h(state_t &s) {
     _rst_n(s, 0x08);
 }
 
 
 
 // 0xd0
-void ret_nc(state_t &s) {
+static GB_DEVICE void ret_nc(state_t &s) {
     if (!s.regs.carry) {
         pop_reg16(s, s.pc);
+        s.branch_taken = true;
     }
 }
 
 // 0xd1
-void pop_de(state_t &s) { pop_reg16(s, s.regs.de); }
+static GB_DEVICE void pop_de(state_t &s) { pop_reg16(s, s.regs.de); }
 
 // 0xd2
-void jp_nc_nn(state_t &s) {
+static GB_DEVICE void jp_nc_nn(state_t &s) {
     if (!s.regs.carry) {
         _jp_nn(s);
     }
 }
 
 // 0xd4
-void call_nc_nn(state_t &s) {
+static GB_DEVICE void call_nc_nn(state_t &s) {
     if (!s.regs.carry) {
         _call_nn(s);
     }
 }
 
 // 0xd5
-void push_de(state_t &s) {
+static GB_DEVICE void push_de(state_t &s) {
     push_reg16(s, s.regs.de);
 }
 
 // 0xd6
-void sub_a_n(state_t &s) {
+static GB_DEVICE void sub_a_n(state_t &s) {
     _sub_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xd7
-void rst_10h(state_t &s) {
+static GB_DEVICE void rst_10h(state_t &s) {
     _rst_n(s, 0x10);
 }
 
 // 0xd8
-void ret_c(state_t &s) {
+static GB_DEVICE void ret_c(state_t &s) {
     if (s.regs.carry) {
         pop_reg16(s, s.pc);
+        s.branch_taken = true;
     }
 }
 
 // 0xd9
-void reti(state_t &s) {
+static GB_DEVICE void reti(state_t &s) {
     pop_reg16(s, s.pc);
     _ei(s);
 }
 
 // 0xda
-void jp_c_nn(state_t &s) {
+static GB_DEVICE void jp_c_nn(state_t &s) {
     if (s.regs.carry) {
         _jp_nn(s);
     }
 }
 
 // 0xdc
-void call_c_nn(state_t &s) {
+static GB_DEVICE void call_c_nn(state_t &s) {
     if (s.regs.carry) {
         _call_nn(s);
     }
 }
 
 // 0xde
-void sbc_a_n(state_t &s) {
+static GB_DEVICE void sbc_a_n(state_t &s) {
     _sbc_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xdf
-void rst_18h(state_t &s) {
+static GB_DEVICE void rst_18h(state_t &s) {
     _rst_n(s, 0x18);
 }
 
 
 // 0xe0
-void ldh_np_a(state_t &s) {
+static GB_DEVICE void ldh_np_a(state_t &s) {
     write_u8(s, (_reg16_t)0xff00 + (_reg8_t)s.operand, s.regs.a);
 }
 
 // 0xe1
-void pop_hl(state_t &s) { pop_reg16(s, s.regs.hl); }
+static GB_DEVICE void pop_hl(state_t &s) { pop_reg16(s, s.regs.hl); }
 
 // 0xe2
-void ld_cp_a(state_t &s) {
+static GB_DEVICE void ld_cp_a(state_t &s) {
     write_u8(s, (_reg16_t)0xff00 + (_reg8_t)s.regs.c, s.regs.a);
 }
 
 // 0xe5
-void push_hl(state_t &s) {
+static GB_DEVICE void push_hl(state_t &s) {
     push_reg16(s, s.regs.hl); 
 }
 
 // 0xe6
-void and_a_n(state_t &s) {
+static GB_DEVICE void and_a_n(state_t &s) {
     _and_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xe7
-void rst_20h(state_t &s) {
+static GB_DEVICE void rst_20h(state_t &s) {
     _rst_n(s, 0x20);
 }
 
 // 0xe8
-void add_sp_n(state_t &s) {
+static GB_DEVICE void add_sp_n(state_t &s) {
     _add_sp_u8(s, (_op8_t)s.operand);
 }
 
 // 0xe9
-void jp_hl(state_t &s) {
+static GB_DEVICE void jp_hl(state_t &s) {
     s.pc = s.regs.hl;
 }
 
 // 0xea
-void ld_nnp_a(state_t &s) {
+static GB_DEVICE void ld_nnp_a(state_t &s) {
     write_u8(s, s.operand, s.regs.a);
 }
 
 // 0xee
-void xor_a_n(state_t &s) {
+static GB_DEVICE void xor_a_n(state_t &s) {
     _xor_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xe7
-void rst_28h(state_t &s) {
+static GB_DEVICE void rst_28h(state_t &s) {
     _rst_n(s, 0x28);
 }
 
 
 // 0xf0
-void ldh_a_np(state_t &s) {
+static GB_DEVICE void ldh_a_np(state_t &s) {
     s.regs.a = read_u8(s, (_reg16_t)0xff00 + (_reg8_t)s.operand);
 }
 
 // 0xf1
-void pop_af(state_t &s) { 
+static GB_DEVICE void pop_af(state_t &s) { 
     pop_reg16(s, s.regs.af);
     s.regs.f &= 0xf0;
 }
 
 // 0xf2
-void ld_a_cp(state_t &s) {
+static GB_DEVICE void ld_a_cp(state_t &s) {
     s.regs.a = read_u8(s, (_reg16_t)0xff00 + (_reg8_t)s.regs.c);
 }
 
 // 0xf3
-void di(state_t &s) {
+static GB_DEVICE void di(state_t &s) {
     _di(s);
 }
 
 // 0xf5
-void push_af(state_t &s) {
+static GB_DEVICE void push_af(state_t &s) {
     push_reg16(s, s.regs.af); 
 }
 
 // 0xf6
-void or_a_n(state_t &s) {
+static GB_DEVICE void or_a_n(state_t &s) {
     _or_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xf7
-void rst_30h(state_t &s) {
+static GB_DEVICE void rst_30h(state_t &s) {
     _rst_n(s, 0x30);
 }
 
 // 0xf8
-void ldhl_sp_n(state_t &s) {
+static GB_DEVICE void ldhl_sp_n(state_t &s) {
     _reg16_t sp = s.regs.sp;
     _add_sp_u8(s, (_op8_t)s.operand);
     s.regs.hl = s.regs.sp;
@@ -1316,27 +1324,27 @@ void ldhl_sp_n(state_t &s) {
 }
 
 // 0xf9
-void ld_sp_hl(state_t &s) {
+static GB_DEVICE void ld_sp_hl(state_t &s) {
     s.regs.sp = s.regs.hl;
 }
 
 // 0xfa
-void ld_a_nnp(state_t &s) {
+static GB_DEVICE void ld_a_nnp(state_t &s) {
     s.regs.a = read_u8(s, s.operand);
 }
 
 // 0xfb
-void ei(state_t &s) {
+static GB_DEVICE void ei(state_t &s) {
     _ei(s);
 }
 
 // 0xfe
-void cp_a_n(state_t &s) {
+static GB_DEVICE void cp_a_n(state_t &s) {
     _cp_a_n(s, (_reg8_t)s.operand);
 }
 
 // 0xf7
-void rst_38h(state_t &s) {
+static GB_DEVICE void rst_38h(state_t &s) {
     _rst_n(s, 0x38);
 }
 
@@ -1346,519 +1354,519 @@ void rst_38h(state_t &s) {
 // =============================================================
 
 // 0xcb0
-void rlc_b(state_t &s) { s.regs.b = _rlc_n(s, s.regs.b); }
+static GB_DEVICE void rlc_b(state_t &s) { s.regs.b = _rlc_n(s, s.regs.b); }
 // 0xcb1
-void rlc_c(state_t &s) { s.regs.c = _rlc_n(s, s.regs.c); }
+static GB_DEVICE void rlc_c(state_t &s) { s.regs.c = _rlc_n(s, s.regs.c); }
 // 0xcb2
-void rlc_d(state_t &s) { s.regs.d = _rlc_n(s, s.regs.d); }
+static GB_DEVICE void rlc_d(state_t &s) { s.regs.d = _rlc_n(s, s.regs.d); }
 // 0xcb3
-void rlc_e(state_t &s) { s.regs.e = _rlc_n(s, s.regs.e); }
+static GB_DEVICE void rlc_e(state_t &s) { s.regs.e = _rlc_n(s, s.regs.e); }
 // 0xcb4
-void rlc_h(state_t &s) { s.regs.h = _rlc_n(s, s.regs.h); }
+static GB_DEVICE void rlc_h(state_t &s) { s.regs.h = _rlc_n(s, s.regs.h); }
 // 0xcb5
-void rlc_l(state_t &s) { s.regs.l = _rlc_n(s, s.regs.l); }
+static GB_DEVICE void rlc_l(state_t &s) { s.regs.l = _rlc_n(s, s.regs.l); }
 // 0xcb6
-void rlc_hlp(state_t &s) { write_u8(s, s.regs.hl, _rlc_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void rlc_hlp(state_t &s) { write_u8(s, s.regs.hl, _rlc_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb7
-void rlc_a(state_t &s) { s.regs.a = _rlc_n(s, s.regs.a); }
+static GB_DEVICE void rlc_a(state_t &s) { s.regs.a = _rlc_n(s, s.regs.a); }
 // 0xcb8
-void rrc_b(state_t &s) { s.regs.b = _rrc_n(s, s.regs.b); }
+static GB_DEVICE void rrc_b(state_t &s) { s.regs.b = _rrc_n(s, s.regs.b); }
 // 0xcb9
-void rrc_c(state_t &s) { s.regs.c = _rrc_n(s, s.regs.c); }
+static GB_DEVICE void rrc_c(state_t &s) { s.regs.c = _rrc_n(s, s.regs.c); }
 // 0xcba
-void rrc_d(state_t &s) { s.regs.d = _rrc_n(s, s.regs.d); }
+static GB_DEVICE void rrc_d(state_t &s) { s.regs.d = _rrc_n(s, s.regs.d); }
 // 0xcbb
-void rrc_e(state_t &s) { s.regs.e = _rrc_n(s, s.regs.e); }
+static GB_DEVICE void rrc_e(state_t &s) { s.regs.e = _rrc_n(s, s.regs.e); }
 // 0xcbc
-void rrc_h(state_t &s) { s.regs.h = _rrc_n(s, s.regs.h); }
+static GB_DEVICE void rrc_h(state_t &s) { s.regs.h = _rrc_n(s, s.regs.h); }
 // 0xcbd
-void rrc_l(state_t &s) { s.regs.l = _rrc_n(s, s.regs.l); }
+static GB_DEVICE void rrc_l(state_t &s) { s.regs.l = _rrc_n(s, s.regs.l); }
 // 0xcbe
-void rrc_hlp(state_t &s) { write_u8(s, s.regs.hl, _rrc_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void rrc_hlp(state_t &s) { write_u8(s, s.regs.hl, _rrc_n(s, read_u8(s, s.regs.hl))); }
 // 0xcbf
-void rrc_a(state_t &s) { s.regs.a = _rrc_n(s, s.regs.a); }
+static GB_DEVICE void rrc_a(state_t &s) { s.regs.a = _rrc_n(s, s.regs.a); }
 // 0xcb10
-void rl_b(state_t &s) { s.regs.b = _rl_n(s, s.regs.b); }
+static GB_DEVICE void rl_b(state_t &s) { s.regs.b = _rl_n(s, s.regs.b); }
 // 0xcb11
-void rl_c(state_t &s) { s.regs.c = _rl_n(s, s.regs.c); }
+static GB_DEVICE void rl_c(state_t &s) { s.regs.c = _rl_n(s, s.regs.c); }
 // 0xcb12
-void rl_d(state_t &s) { s.regs.d = _rl_n(s, s.regs.d); }
+static GB_DEVICE void rl_d(state_t &s) { s.regs.d = _rl_n(s, s.regs.d); }
 // 0xcb13
-void rl_e(state_t &s) { s.regs.e = _rl_n(s, s.regs.e); }
+static GB_DEVICE void rl_e(state_t &s) { s.regs.e = _rl_n(s, s.regs.e); }
 // 0xcb14
-void rl_h(state_t &s) { s.regs.h = _rl_n(s, s.regs.h); }
+static GB_DEVICE void rl_h(state_t &s) { s.regs.h = _rl_n(s, s.regs.h); }
 // 0xcb15
-void rl_l(state_t &s) { s.regs.l = _rl_n(s, s.regs.l); }
+static GB_DEVICE void rl_l(state_t &s) { s.regs.l = _rl_n(s, s.regs.l); }
 // 0xcb16
-void rl_hlp(state_t &s) { write_u8(s, s.regs.hl, _rl_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void rl_hlp(state_t &s) { write_u8(s, s.regs.hl, _rl_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb17
-void rl_a(state_t &s) { s.regs.a = _rl_n(s, s.regs.a); }
+static GB_DEVICE void rl_a(state_t &s) { s.regs.a = _rl_n(s, s.regs.a); }
 // 0xcb18
-void rr_b(state_t &s) { s.regs.b = _rr_n(s, s.regs.b); }
+static GB_DEVICE void rr_b(state_t &s) { s.regs.b = _rr_n(s, s.regs.b); }
 // 0xcb19
-void rr_c(state_t &s) { s.regs.c = _rr_n(s, s.regs.c); }
+static GB_DEVICE void rr_c(state_t &s) { s.regs.c = _rr_n(s, s.regs.c); }
 // 0xcb1a
-void rr_d(state_t &s) { s.regs.d = _rr_n(s, s.regs.d); }
+static GB_DEVICE void rr_d(state_t &s) { s.regs.d = _rr_n(s, s.regs.d); }
 // 0xcb1b
-void rr_e(state_t &s) { s.regs.e = _rr_n(s, s.regs.e); }
+static GB_DEVICE void rr_e(state_t &s) { s.regs.e = _rr_n(s, s.regs.e); }
 // 0xcb1c
-void rr_h(state_t &s) { s.regs.h = _rr_n(s, s.regs.h); }
+static GB_DEVICE void rr_h(state_t &s) { s.regs.h = _rr_n(s, s.regs.h); }
 // 0xcb1d
-void rr_l(state_t &s) { s.regs.l = _rr_n(s, s.regs.l); }
+static GB_DEVICE void rr_l(state_t &s) { s.regs.l = _rr_n(s, s.regs.l); }
 // 0xcb1e
-void rr_hlp(state_t &s) { write_u8(s, s.regs.hl, _rr_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void rr_hlp(state_t &s) { write_u8(s, s.regs.hl, _rr_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb1f
-void rr_a(state_t &s) { s.regs.a = _rr_n(s, s.regs.a); }
+static GB_DEVICE void rr_a(state_t &s) { s.regs.a = _rr_n(s, s.regs.a); }
 // 0xcb20
-void sla_b(state_t &s) { s.regs.b = _sla_n(s, s.regs.b); }
+static GB_DEVICE void sla_b(state_t &s) { s.regs.b = _sla_n(s, s.regs.b); }
 // 0xcb21
-void sla_c(state_t &s) { s.regs.c = _sla_n(s, s.regs.c); }
+static GB_DEVICE void sla_c(state_t &s) { s.regs.c = _sla_n(s, s.regs.c); }
 // 0xcb22
-void sla_d(state_t &s) { s.regs.d = _sla_n(s, s.regs.d); }
+static GB_DEVICE void sla_d(state_t &s) { s.regs.d = _sla_n(s, s.regs.d); }
 // 0xcb23
-void sla_e(state_t &s) { s.regs.e = _sla_n(s, s.regs.e); }
+static GB_DEVICE void sla_e(state_t &s) { s.regs.e = _sla_n(s, s.regs.e); }
 // 0xcb24
-void sla_h(state_t &s) { s.regs.h = _sla_n(s, s.regs.h); }
+static GB_DEVICE void sla_h(state_t &s) { s.regs.h = _sla_n(s, s.regs.h); }
 // 0xcb25
-void sla_l(state_t &s) { s.regs.l = _sla_n(s, s.regs.l); }
+static GB_DEVICE void sla_l(state_t &s) { s.regs.l = _sla_n(s, s.regs.l); }
 // 0xcb26
-void sla_hlp(state_t &s) { write_u8(s, s.regs.hl, _sla_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void sla_hlp(state_t &s) { write_u8(s, s.regs.hl, _sla_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb27
-void sla_a(state_t &s) { s.regs.a = _sla_n(s, s.regs.a); }
+static GB_DEVICE void sla_a(state_t &s) { s.regs.a = _sla_n(s, s.regs.a); }
 // 0xcb28
-void sra_b(state_t &s) { s.regs.b = _sra_n(s, s.regs.b); }
+static GB_DEVICE void sra_b(state_t &s) { s.regs.b = _sra_n(s, s.regs.b); }
 // 0xcb29
-void sra_c(state_t &s) { s.regs.c = _sra_n(s, s.regs.c); }
+static GB_DEVICE void sra_c(state_t &s) { s.regs.c = _sra_n(s, s.regs.c); }
 // 0xcb2a
-void sra_d(state_t &s) { s.regs.d = _sra_n(s, s.regs.d); }
+static GB_DEVICE void sra_d(state_t &s) { s.regs.d = _sra_n(s, s.regs.d); }
 // 0xcb2b
-void sra_e(state_t &s) { s.regs.e = _sra_n(s, s.regs.e); }
+static GB_DEVICE void sra_e(state_t &s) { s.regs.e = _sra_n(s, s.regs.e); }
 // 0xcb2c
-void sra_h(state_t &s) { s.regs.h = _sra_n(s, s.regs.h); }
+static GB_DEVICE void sra_h(state_t &s) { s.regs.h = _sra_n(s, s.regs.h); }
 // 0xcb2d
-void sra_l(state_t &s) { s.regs.l = _sra_n(s, s.regs.l); }
+static GB_DEVICE void sra_l(state_t &s) { s.regs.l = _sra_n(s, s.regs.l); }
 // 0xcb2e
-void sra_hlp(state_t &s) { write_u8(s, s.regs.hl, _sra_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void sra_hlp(state_t &s) { write_u8(s, s.regs.hl, _sra_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb2f
-void sra_a(state_t &s) { s.regs.a = _sra_n(s, s.regs.a); }
+static GB_DEVICE void sra_a(state_t &s) { s.regs.a = _sra_n(s, s.regs.a); }
 // 0xcb30
-void swap_b(state_t &s) { s.regs.b = _swap_n(s, s.regs.b); }
+static GB_DEVICE void swap_b(state_t &s) { s.regs.b = _swap_n(s, s.regs.b); }
 // 0xcb31
-void swap_c(state_t &s) { s.regs.c = _swap_n(s, s.regs.c); }
+static GB_DEVICE void swap_c(state_t &s) { s.regs.c = _swap_n(s, s.regs.c); }
 // 0xcb32
-void swap_d(state_t &s) { s.regs.d = _swap_n(s, s.regs.d); }
+static GB_DEVICE void swap_d(state_t &s) { s.regs.d = _swap_n(s, s.regs.d); }
 // 0xcb33
-void swap_e(state_t &s) { s.regs.e = _swap_n(s, s.regs.e); }
+static GB_DEVICE void swap_e(state_t &s) { s.regs.e = _swap_n(s, s.regs.e); }
 // 0xcb34
-void swap_h(state_t &s) { s.regs.h = _swap_n(s, s.regs.h); }
+static GB_DEVICE void swap_h(state_t &s) { s.regs.h = _swap_n(s, s.regs.h); }
 // 0xcb35
-void swap_l(state_t &s) { s.regs.l = _swap_n(s, s.regs.l); }
+static GB_DEVICE void swap_l(state_t &s) { s.regs.l = _swap_n(s, s.regs.l); }
 // 0xcb36
-void swap_hlp(state_t &s) { write_u8(s, s.regs.hl, _swap_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void swap_hlp(state_t &s) { write_u8(s, s.regs.hl, _swap_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb37
-void swap_a(state_t &s) { s.regs.a = _swap_n(s, s.regs.a); }
+static GB_DEVICE void swap_a(state_t &s) { s.regs.a = _swap_n(s, s.regs.a); }
 // 0xcb38
-void srl_b(state_t &s) { s.regs.b = _srl_n(s, s.regs.b); }
+static GB_DEVICE void srl_b(state_t &s) { s.regs.b = _srl_n(s, s.regs.b); }
 // 0xcb39
-void srl_c(state_t &s) { s.regs.c = _srl_n(s, s.regs.c); }
+static GB_DEVICE void srl_c(state_t &s) { s.regs.c = _srl_n(s, s.regs.c); }
 // 0xcb3a
-void srl_d(state_t &s) { s.regs.d = _srl_n(s, s.regs.d); }
+static GB_DEVICE void srl_d(state_t &s) { s.regs.d = _srl_n(s, s.regs.d); }
 // 0xcb3b
-void srl_e(state_t &s) { s.regs.e = _srl_n(s, s.regs.e); }
+static GB_DEVICE void srl_e(state_t &s) { s.regs.e = _srl_n(s, s.regs.e); }
 // 0xcb3c
-void srl_h(state_t &s) { s.regs.h = _srl_n(s, s.regs.h); }
+static GB_DEVICE void srl_h(state_t &s) { s.regs.h = _srl_n(s, s.regs.h); }
 // 0xcb3d
-void srl_l(state_t &s) { s.regs.l = _srl_n(s, s.regs.l); }
+static GB_DEVICE void srl_l(state_t &s) { s.regs.l = _srl_n(s, s.regs.l); }
 // 0xcb3e
-void srl_hlp(state_t &s) { write_u8(s, s.regs.hl, _srl_n(s, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void srl_hlp(state_t &s) { write_u8(s, s.regs.hl, _srl_n(s, read_u8(s, s.regs.hl))); }
 // 0xcb3f
-void srl_a(state_t &s) { s.regs.a = _srl_n(s, s.regs.a); }
+static GB_DEVICE void srl_a(state_t &s) { s.regs.a = _srl_n(s, s.regs.a); }
 // 0xcb40
-void bit_0_b(state_t &s) { _bit_b_r(s, 0, s.regs.b); }
+static GB_DEVICE void bit_0_b(state_t &s) { _bit_b_r(s, 0, s.regs.b); }
 // 0xcb41
-void bit_0_c(state_t &s) { _bit_b_r(s, 0, s.regs.c); }
+static GB_DEVICE void bit_0_c(state_t &s) { _bit_b_r(s, 0, s.regs.c); }
 // 0xcb42
-void bit_0_d(state_t &s) { _bit_b_r(s, 0, s.regs.d); }
+static GB_DEVICE void bit_0_d(state_t &s) { _bit_b_r(s, 0, s.regs.d); }
 // 0xcb43
-void bit_0_e(state_t &s) { _bit_b_r(s, 0, s.regs.e); }
+static GB_DEVICE void bit_0_e(state_t &s) { _bit_b_r(s, 0, s.regs.e); }
 // 0xcb44
-void bit_0_h(state_t &s) { _bit_b_r(s, 0, s.regs.h); }
+static GB_DEVICE void bit_0_h(state_t &s) { _bit_b_r(s, 0, s.regs.h); }
 // 0xcb45
-void bit_0_l(state_t &s) { _bit_b_r(s, 0, s.regs.l); }
+static GB_DEVICE void bit_0_l(state_t &s) { _bit_b_r(s, 0, s.regs.l); }
 // 0xcb46
-void bit_0_hlp(state_t &s) { _bit_b_r(s, 0, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_0_hlp(state_t &s) { _bit_b_r(s, 0, read_u8(s, s.regs.hl)); }
 // 0xcb47
-void bit_0_a(state_t &s) { _bit_b_r(s, 0, s.regs.a); }
+static GB_DEVICE void bit_0_a(state_t &s) { _bit_b_r(s, 0, s.regs.a); }
 // 0xcb48
-void bit_1_b(state_t &s) { _bit_b_r(s, 1, s.regs.b); }
+static GB_DEVICE void bit_1_b(state_t &s) { _bit_b_r(s, 1, s.regs.b); }
 // 0xcb49
-void bit_1_c(state_t &s) { _bit_b_r(s, 1, s.regs.c); }
+static GB_DEVICE void bit_1_c(state_t &s) { _bit_b_r(s, 1, s.regs.c); }
 // 0xcb4a
-void bit_1_d(state_t &s) { _bit_b_r(s, 1, s.regs.d); }
+static GB_DEVICE void bit_1_d(state_t &s) { _bit_b_r(s, 1, s.regs.d); }
 // 0xcb4b
-void bit_1_e(state_t &s) { _bit_b_r(s, 1, s.regs.e); }
+static GB_DEVICE void bit_1_e(state_t &s) { _bit_b_r(s, 1, s.regs.e); }
 // 0xcb4c
-void bit_1_h(state_t &s) { _bit_b_r(s, 1, s.regs.h); }
+static GB_DEVICE void bit_1_h(state_t &s) { _bit_b_r(s, 1, s.regs.h); }
 // 0xcb4d
-void bit_1_l(state_t &s) { _bit_b_r(s, 1, s.regs.l); }
+static GB_DEVICE void bit_1_l(state_t &s) { _bit_b_r(s, 1, s.regs.l); }
 // 0xcb4e
-void bit_1_hlp(state_t &s) { _bit_b_r(s, 1, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_1_hlp(state_t &s) { _bit_b_r(s, 1, read_u8(s, s.regs.hl)); }
 // 0xcb4f
-void bit_1_a(state_t &s) { _bit_b_r(s, 1, s.regs.a); }
+static GB_DEVICE void bit_1_a(state_t &s) { _bit_b_r(s, 1, s.regs.a); }
 // 0xcb50
-void bit_2_b(state_t &s) { _bit_b_r(s, 2, s.regs.b); }
+static GB_DEVICE void bit_2_b(state_t &s) { _bit_b_r(s, 2, s.regs.b); }
 // 0xcb51
-void bit_2_c(state_t &s) { _bit_b_r(s, 2, s.regs.c); }
+static GB_DEVICE void bit_2_c(state_t &s) { _bit_b_r(s, 2, s.regs.c); }
 // 0xcb52
-void bit_2_d(state_t &s) { _bit_b_r(s, 2, s.regs.d); }
+static GB_DEVICE void bit_2_d(state_t &s) { _bit_b_r(s, 2, s.regs.d); }
 // 0xcb53
-void bit_2_e(state_t &s) { _bit_b_r(s, 2, s.regs.e); }
+static GB_DEVICE void bit_2_e(state_t &s) { _bit_b_r(s, 2, s.regs.e); }
 // 0xcb54
-void bit_2_h(state_t &s) { _bit_b_r(s, 2, s.regs.h); }
+static GB_DEVICE void bit_2_h(state_t &s) { _bit_b_r(s, 2, s.regs.h); }
 // 0xcb55
-void bit_2_l(state_t &s) { _bit_b_r(s, 2, s.regs.l); }
+static GB_DEVICE void bit_2_l(state_t &s) { _bit_b_r(s, 2, s.regs.l); }
 // 0xcb56
-void bit_2_hlp(state_t &s) { _bit_b_r(s, 2, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_2_hlp(state_t &s) { _bit_b_r(s, 2, read_u8(s, s.regs.hl)); }
 // 0xcb57
-void bit_2_a(state_t &s) { _bit_b_r(s, 2, s.regs.a); }
+static GB_DEVICE void bit_2_a(state_t &s) { _bit_b_r(s, 2, s.regs.a); }
 // 0xcb58
-void bit_3_b(state_t &s) { _bit_b_r(s, 3, s.regs.b); }
+static GB_DEVICE void bit_3_b(state_t &s) { _bit_b_r(s, 3, s.regs.b); }
 // 0xcb59
-void bit_3_c(state_t &s) { _bit_b_r(s, 3, s.regs.c); }
+static GB_DEVICE void bit_3_c(state_t &s) { _bit_b_r(s, 3, s.regs.c); }
 // 0xcb5a
-void bit_3_d(state_t &s) { _bit_b_r(s, 3, s.regs.d); }
+static GB_DEVICE void bit_3_d(state_t &s) { _bit_b_r(s, 3, s.regs.d); }
 // 0xcb5b
-void bit_3_e(state_t &s) { _bit_b_r(s, 3, s.regs.e); }
+static GB_DEVICE void bit_3_e(state_t &s) { _bit_b_r(s, 3, s.regs.e); }
 // 0xcb5c
-void bit_3_h(state_t &s) { _bit_b_r(s, 3, s.regs.h); }
+static GB_DEVICE void bit_3_h(state_t &s) { _bit_b_r(s, 3, s.regs.h); }
 // 0xcb5d
-void bit_3_l(state_t &s) { _bit_b_r(s, 3, s.regs.l); }
+static GB_DEVICE void bit_3_l(state_t &s) { _bit_b_r(s, 3, s.regs.l); }
 // 0xcb5e
-void bit_3_hlp(state_t &s) { _bit_b_r(s, 3, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_3_hlp(state_t &s) { _bit_b_r(s, 3, read_u8(s, s.regs.hl)); }
 // 0xcb5f
-void bit_3_a(state_t &s) { _bit_b_r(s, 3, s.regs.a); }
+static GB_DEVICE void bit_3_a(state_t &s) { _bit_b_r(s, 3, s.regs.a); }
 // 0xcb60
-void bit_4_b(state_t &s) { _bit_b_r(s, 4, s.regs.b); }
+static GB_DEVICE void bit_4_b(state_t &s) { _bit_b_r(s, 4, s.regs.b); }
 // 0xcb61
-void bit_4_c(state_t &s) { _bit_b_r(s, 4, s.regs.c); }
+static GB_DEVICE void bit_4_c(state_t &s) { _bit_b_r(s, 4, s.regs.c); }
 // 0xcb62
-void bit_4_d(state_t &s) { _bit_b_r(s, 4, s.regs.d); }
+static GB_DEVICE void bit_4_d(state_t &s) { _bit_b_r(s, 4, s.regs.d); }
 // 0xcb63
-void bit_4_e(state_t &s) { _bit_b_r(s, 4, s.regs.e); }
+static GB_DEVICE void bit_4_e(state_t &s) { _bit_b_r(s, 4, s.regs.e); }
 // 0xcb64
-void bit_4_h(state_t &s) { _bit_b_r(s, 4, s.regs.h); }
+static GB_DEVICE void bit_4_h(state_t &s) { _bit_b_r(s, 4, s.regs.h); }
 // 0xcb65
-void bit_4_l(state_t &s) { _bit_b_r(s, 4, s.regs.l); }
+static GB_DEVICE void bit_4_l(state_t &s) { _bit_b_r(s, 4, s.regs.l); }
 // 0xcb66
-void bit_4_hlp(state_t &s) { _bit_b_r(s, 4, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_4_hlp(state_t &s) { _bit_b_r(s, 4, read_u8(s, s.regs.hl)); }
 // 0xcb67
-void bit_4_a(state_t &s) { _bit_b_r(s, 4, s.regs.a); }
+static GB_DEVICE void bit_4_a(state_t &s) { _bit_b_r(s, 4, s.regs.a); }
 // 0xcb68
-void bit_5_b(state_t &s) { _bit_b_r(s, 5, s.regs.b); }
+static GB_DEVICE void bit_5_b(state_t &s) { _bit_b_r(s, 5, s.regs.b); }
 // 0xcb69
-void bit_5_c(state_t &s) { _bit_b_r(s, 5, s.regs.c); }
+static GB_DEVICE void bit_5_c(state_t &s) { _bit_b_r(s, 5, s.regs.c); }
 // 0xcb6a
-void bit_5_d(state_t &s) { _bit_b_r(s, 5, s.regs.d); }
+static GB_DEVICE void bit_5_d(state_t &s) { _bit_b_r(s, 5, s.regs.d); }
 // 0xcb6b
-void bit_5_e(state_t &s) { _bit_b_r(s, 5, s.regs.e); }
+static GB_DEVICE void bit_5_e(state_t &s) { _bit_b_r(s, 5, s.regs.e); }
 // 0xcb6c
-void bit_5_h(state_t &s) { _bit_b_r(s, 5, s.regs.h); }
+static GB_DEVICE void bit_5_h(state_t &s) { _bit_b_r(s, 5, s.regs.h); }
 // 0xcb6d
-void bit_5_l(state_t &s) { _bit_b_r(s, 5, s.regs.l); }
+static GB_DEVICE void bit_5_l(state_t &s) { _bit_b_r(s, 5, s.regs.l); }
 // 0xcb6e
-void bit_5_hlp(state_t &s) { _bit_b_r(s, 5, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_5_hlp(state_t &s) { _bit_b_r(s, 5, read_u8(s, s.regs.hl)); }
 // 0xcb6f
-void bit_5_a(state_t &s) { _bit_b_r(s, 5, s.regs.a); }
+static GB_DEVICE void bit_5_a(state_t &s) { _bit_b_r(s, 5, s.regs.a); }
 // 0xcb70
-void bit_6_b(state_t &s) { _bit_b_r(s, 6, s.regs.b); }
+static GB_DEVICE void bit_6_b(state_t &s) { _bit_b_r(s, 6, s.regs.b); }
 // 0xcb71
-void bit_6_c(state_t &s) { _bit_b_r(s, 6, s.regs.c); }
+static GB_DEVICE void bit_6_c(state_t &s) { _bit_b_r(s, 6, s.regs.c); }
 // 0xcb72
-void bit_6_d(state_t &s) { _bit_b_r(s, 6, s.regs.d); }
+static GB_DEVICE void bit_6_d(state_t &s) { _bit_b_r(s, 6, s.regs.d); }
 // 0xcb73
-void bit_6_e(state_t &s) { _bit_b_r(s, 6, s.regs.e); }
+static GB_DEVICE void bit_6_e(state_t &s) { _bit_b_r(s, 6, s.regs.e); }
 // 0xcb74
-void bit_6_h(state_t &s) { _bit_b_r(s, 6, s.regs.h); }
+static GB_DEVICE void bit_6_h(state_t &s) { _bit_b_r(s, 6, s.regs.h); }
 // 0xcb75
-void bit_6_l(state_t &s) { _bit_b_r(s, 6, s.regs.l); }
+static GB_DEVICE void bit_6_l(state_t &s) { _bit_b_r(s, 6, s.regs.l); }
 // 0xcb76
-void bit_6_hlp(state_t &s) { _bit_b_r(s, 6, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_6_hlp(state_t &s) { _bit_b_r(s, 6, read_u8(s, s.regs.hl)); }
 // 0xcb77
-void bit_6_a(state_t &s) { _bit_b_r(s, 6, s.regs.a); }
+static GB_DEVICE void bit_6_a(state_t &s) { _bit_b_r(s, 6, s.regs.a); }
 // 0xcb78
-void bit_7_b(state_t &s) { _bit_b_r(s, 7, s.regs.b); }
+static GB_DEVICE void bit_7_b(state_t &s) { _bit_b_r(s, 7, s.regs.b); }
 // 0xcb79
-void bit_7_c(state_t &s) { _bit_b_r(s, 7, s.regs.c); }
+static GB_DEVICE void bit_7_c(state_t &s) { _bit_b_r(s, 7, s.regs.c); }
 // 0xcb7a
-void bit_7_d(state_t &s) { _bit_b_r(s, 7, s.regs.d); }
+static GB_DEVICE void bit_7_d(state_t &s) { _bit_b_r(s, 7, s.regs.d); }
 // 0xcb7b
-void bit_7_e(state_t &s) { _bit_b_r(s, 7, s.regs.e); }
+static GB_DEVICE void bit_7_e(state_t &s) { _bit_b_r(s, 7, s.regs.e); }
 // 0xcb7c
-void bit_7_h(state_t &s) { _bit_b_r(s, 7, s.regs.h); }
+static GB_DEVICE void bit_7_h(state_t &s) { _bit_b_r(s, 7, s.regs.h); }
 // 0xcb7d
-void bit_7_l(state_t &s) { _bit_b_r(s, 7, s.regs.l); }
+static GB_DEVICE void bit_7_l(state_t &s) { _bit_b_r(s, 7, s.regs.l); }
 // 0xcb7e
-void bit_7_hlp(state_t &s) { _bit_b_r(s, 7, read_u8(s, s.regs.hl)); }
+static GB_DEVICE void bit_7_hlp(state_t &s) { _bit_b_r(s, 7, read_u8(s, s.regs.hl)); }
 // 0xcb7f
-void bit_7_a(state_t &s) { _bit_b_r(s, 7, s.regs.a); }
+static GB_DEVICE void bit_7_a(state_t &s) { _bit_b_r(s, 7, s.regs.a); }
 // 0xcb80
-void set_0_b(state_t &s) { s.regs.b = _set_b_r(s, 0, s.regs.b); }
+static GB_DEVICE void set_0_b(state_t &s) { s.regs.b = _set_b_r(s, 0, s.regs.b); }
 // 0xcb81
-void set_0_c(state_t &s) { s.regs.c = _set_b_r(s, 0, s.regs.c); }
+static GB_DEVICE void set_0_c(state_t &s) { s.regs.c = _set_b_r(s, 0, s.regs.c); }
 // 0xcb82
-void set_0_d(state_t &s) { s.regs.d = _set_b_r(s, 0, s.regs.d); }
+static GB_DEVICE void set_0_d(state_t &s) { s.regs.d = _set_b_r(s, 0, s.regs.d); }
 // 0xcb83
-void set_0_e(state_t &s) { s.regs.e = _set_b_r(s, 0, s.regs.e); }
+static GB_DEVICE void set_0_e(state_t &s) { s.regs.e = _set_b_r(s, 0, s.regs.e); }
 // 0xcb84
-void set_0_h(state_t &s) { s.regs.h = _set_b_r(s, 0, s.regs.h); }
+static GB_DEVICE void set_0_h(state_t &s) { s.regs.h = _set_b_r(s, 0, s.regs.h); }
 // 0xcb85
-void set_0_l(state_t &s) { s.regs.l = _set_b_r(s, 0, s.regs.l); }
+static GB_DEVICE void set_0_l(state_t &s) { s.regs.l = _set_b_r(s, 0, s.regs.l); }
 // 0xcb86
-void set_0_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 0, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_0_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 0, read_u8(s, s.regs.hl))); }
 // 0xcb87
-void set_0_a(state_t &s) { s.regs.a = _set_b_r(s, 0, s.regs.a); }
+static GB_DEVICE void set_0_a(state_t &s) { s.regs.a = _set_b_r(s, 0, s.regs.a); }
 // 0xcb88
-void set_1_b(state_t &s) { s.regs.b = _set_b_r(s, 1, s.regs.b); }
+static GB_DEVICE void set_1_b(state_t &s) { s.regs.b = _set_b_r(s, 1, s.regs.b); }
 // 0xcb89
-void set_1_c(state_t &s) { s.regs.c = _set_b_r(s, 1, s.regs.c); }
+static GB_DEVICE void set_1_c(state_t &s) { s.regs.c = _set_b_r(s, 1, s.regs.c); }
 // 0xcb8a
-void set_1_d(state_t &s) { s.regs.d = _set_b_r(s, 1, s.regs.d); }
+static GB_DEVICE void set_1_d(state_t &s) { s.regs.d = _set_b_r(s, 1, s.regs.d); }
 // 0xcb8b
-void set_1_e(state_t &s) { s.regs.e = _set_b_r(s, 1, s.regs.e); }
+static GB_DEVICE void set_1_e(state_t &s) { s.regs.e = _set_b_r(s, 1, s.regs.e); }
 // 0xcb8c
-void set_1_h(state_t &s) { s.regs.h = _set_b_r(s, 1, s.regs.h); }
+static GB_DEVICE void set_1_h(state_t &s) { s.regs.h = _set_b_r(s, 1, s.regs.h); }
 // 0xcb8d
-void set_1_l(state_t &s) { s.regs.l = _set_b_r(s, 1, s.regs.l); }
+static GB_DEVICE void set_1_l(state_t &s) { s.regs.l = _set_b_r(s, 1, s.regs.l); }
 // 0xcb8e
-void set_1_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 1, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_1_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 1, read_u8(s, s.regs.hl))); }
 // 0xcb8f
-void set_1_a(state_t &s) { s.regs.a = _set_b_r(s, 1, s.regs.a); }
+static GB_DEVICE void set_1_a(state_t &s) { s.regs.a = _set_b_r(s, 1, s.regs.a); }
 // 0xcb90
-void set_2_b(state_t &s) { s.regs.b = _set_b_r(s, 2, s.regs.b); }
+static GB_DEVICE void set_2_b(state_t &s) { s.regs.b = _set_b_r(s, 2, s.regs.b); }
 // 0xcb91
-void set_2_c(state_t &s) { s.regs.c = _set_b_r(s, 2, s.regs.c); }
+static GB_DEVICE void set_2_c(state_t &s) { s.regs.c = _set_b_r(s, 2, s.regs.c); }
 // 0xcb92
-void set_2_d(state_t &s) { s.regs.d = _set_b_r(s, 2, s.regs.d); }
+static GB_DEVICE void set_2_d(state_t &s) { s.regs.d = _set_b_r(s, 2, s.regs.d); }
 // 0xcb93
-void set_2_e(state_t &s) { s.regs.e = _set_b_r(s, 2, s.regs.e); }
+static GB_DEVICE void set_2_e(state_t &s) { s.regs.e = _set_b_r(s, 2, s.regs.e); }
 // 0xcb94
-void set_2_h(state_t &s) { s.regs.h = _set_b_r(s, 2, s.regs.h); }
+static GB_DEVICE void set_2_h(state_t &s) { s.regs.h = _set_b_r(s, 2, s.regs.h); }
 // 0xcb95
-void set_2_l(state_t &s) { s.regs.l = _set_b_r(s, 2, s.regs.l); }
+static GB_DEVICE void set_2_l(state_t &s) { s.regs.l = _set_b_r(s, 2, s.regs.l); }
 // 0xcb96
-void set_2_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 2, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_2_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 2, read_u8(s, s.regs.hl))); }
 // 0xcb97
-void set_2_a(state_t &s) { s.regs.a = _set_b_r(s, 2, s.regs.a); }
+static GB_DEVICE void set_2_a(state_t &s) { s.regs.a = _set_b_r(s, 2, s.regs.a); }
 // 0xcb98
-void set_3_b(state_t &s) { s.regs.b = _set_b_r(s, 3, s.regs.b); }
+static GB_DEVICE void set_3_b(state_t &s) { s.regs.b = _set_b_r(s, 3, s.regs.b); }
 // 0xcb99
-void set_3_c(state_t &s) { s.regs.c = _set_b_r(s, 3, s.regs.c); }
+static GB_DEVICE void set_3_c(state_t &s) { s.regs.c = _set_b_r(s, 3, s.regs.c); }
 // 0xcb9a
-void set_3_d(state_t &s) { s.regs.d = _set_b_r(s, 3, s.regs.d); }
+static GB_DEVICE void set_3_d(state_t &s) { s.regs.d = _set_b_r(s, 3, s.regs.d); }
 // 0xcb9b
-void set_3_e(state_t &s) { s.regs.e = _set_b_r(s, 3, s.regs.e); }
+static GB_DEVICE void set_3_e(state_t &s) { s.regs.e = _set_b_r(s, 3, s.regs.e); }
 // 0xcb9c
-void set_3_h(state_t &s) { s.regs.h = _set_b_r(s, 3, s.regs.h); }
+static GB_DEVICE void set_3_h(state_t &s) { s.regs.h = _set_b_r(s, 3, s.regs.h); }
 // 0xcb9d
-void set_3_l(state_t &s) { s.regs.l = _set_b_r(s, 3, s.regs.l); }
+static GB_DEVICE void set_3_l(state_t &s) { s.regs.l = _set_b_r(s, 3, s.regs.l); }
 // 0xcb9e
-void set_3_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 3, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_3_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 3, read_u8(s, s.regs.hl))); }
 // 0xcb9f
-void set_3_a(state_t &s) { s.regs.a = _set_b_r(s, 3, s.regs.a); }
+static GB_DEVICE void set_3_a(state_t &s) { s.regs.a = _set_b_r(s, 3, s.regs.a); }
 // 0xcba0
-void set_4_b(state_t &s) { s.regs.b = _set_b_r(s, 4, s.regs.b); }
+static GB_DEVICE void set_4_b(state_t &s) { s.regs.b = _set_b_r(s, 4, s.regs.b); }
 // 0xcba1
-void set_4_c(state_t &s) { s.regs.c = _set_b_r(s, 4, s.regs.c); }
+static GB_DEVICE void set_4_c(state_t &s) { s.regs.c = _set_b_r(s, 4, s.regs.c); }
 // 0xcba2
-void set_4_d(state_t &s) { s.regs.d = _set_b_r(s, 4, s.regs.d); }
+static GB_DEVICE void set_4_d(state_t &s) { s.regs.d = _set_b_r(s, 4, s.regs.d); }
 // 0xcba3
-void set_4_e(state_t &s) { s.regs.e = _set_b_r(s, 4, s.regs.e); }
+static GB_DEVICE void set_4_e(state_t &s) { s.regs.e = _set_b_r(s, 4, s.regs.e); }
 // 0xcba4
-void set_4_h(state_t &s) { s.regs.h = _set_b_r(s, 4, s.regs.h); }
+static GB_DEVICE void set_4_h(state_t &s) { s.regs.h = _set_b_r(s, 4, s.regs.h); }
 // 0xcba5
-void set_4_l(state_t &s) { s.regs.l = _set_b_r(s, 4, s.regs.l); }
+static GB_DEVICE void set_4_l(state_t &s) { s.regs.l = _set_b_r(s, 4, s.regs.l); }
 // 0xcba6
-void set_4_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 4, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_4_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 4, read_u8(s, s.regs.hl))); }
 // 0xcba7
-void set_4_a(state_t &s) { s.regs.a = _set_b_r(s, 4, s.regs.a); }
+static GB_DEVICE void set_4_a(state_t &s) { s.regs.a = _set_b_r(s, 4, s.regs.a); }
 // 0xcba8
-void set_5_b(state_t &s) { s.regs.b = _set_b_r(s, 5, s.regs.b); }
+static GB_DEVICE void set_5_b(state_t &s) { s.regs.b = _set_b_r(s, 5, s.regs.b); }
 // 0xcba9
-void set_5_c(state_t &s) { s.regs.c = _set_b_r(s, 5, s.regs.c); }
+static GB_DEVICE void set_5_c(state_t &s) { s.regs.c = _set_b_r(s, 5, s.regs.c); }
 // 0xcbaa
-void set_5_d(state_t &s) { s.regs.d = _set_b_r(s, 5, s.regs.d); }
+static GB_DEVICE void set_5_d(state_t &s) { s.regs.d = _set_b_r(s, 5, s.regs.d); }
 // 0xcbab
-void set_5_e(state_t &s) { s.regs.e = _set_b_r(s, 5, s.regs.e); }
+static GB_DEVICE void set_5_e(state_t &s) { s.regs.e = _set_b_r(s, 5, s.regs.e); }
 // 0xcbac
-void set_5_h(state_t &s) { s.regs.h = _set_b_r(s, 5, s.regs.h); }
+static GB_DEVICE void set_5_h(state_t &s) { s.regs.h = _set_b_r(s, 5, s.regs.h); }
 // 0xcbad
-void set_5_l(state_t &s) { s.regs.l = _set_b_r(s, 5, s.regs.l); }
+static GB_DEVICE void set_5_l(state_t &s) { s.regs.l = _set_b_r(s, 5, s.regs.l); }
 // 0xcbae
-void set_5_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 5, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_5_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 5, read_u8(s, s.regs.hl))); }
 // 0xcbaf
-void set_5_a(state_t &s) { s.regs.a = _set_b_r(s, 5, s.regs.a); }
+static GB_DEVICE void set_5_a(state_t &s) { s.regs.a = _set_b_r(s, 5, s.regs.a); }
 // 0xcbb0
-void set_6_b(state_t &s) { s.regs.b = _set_b_r(s, 6, s.regs.b); }
+static GB_DEVICE void set_6_b(state_t &s) { s.regs.b = _set_b_r(s, 6, s.regs.b); }
 // 0xcbb1
-void set_6_c(state_t &s) { s.regs.c = _set_b_r(s, 6, s.regs.c); }
+static GB_DEVICE void set_6_c(state_t &s) { s.regs.c = _set_b_r(s, 6, s.regs.c); }
 // 0xcbb2
-void set_6_d(state_t &s) { s.regs.d = _set_b_r(s, 6, s.regs.d); }
+static GB_DEVICE void set_6_d(state_t &s) { s.regs.d = _set_b_r(s, 6, s.regs.d); }
 // 0xcbb3
-void set_6_e(state_t &s) { s.regs.e = _set_b_r(s, 6, s.regs.e); }
+static GB_DEVICE void set_6_e(state_t &s) { s.regs.e = _set_b_r(s, 6, s.regs.e); }
 // 0xcbb4
-void set_6_h(state_t &s) { s.regs.h = _set_b_r(s, 6, s.regs.h); }
+static GB_DEVICE void set_6_h(state_t &s) { s.regs.h = _set_b_r(s, 6, s.regs.h); }
 // 0xcbb5
-void set_6_l(state_t &s) { s.regs.l = _set_b_r(s, 6, s.regs.l); }
+static GB_DEVICE void set_6_l(state_t &s) { s.regs.l = _set_b_r(s, 6, s.regs.l); }
 // 0xcbb6
-void set_6_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 6, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_6_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 6, read_u8(s, s.regs.hl))); }
 // 0xcbb7
-void set_6_a(state_t &s) { s.regs.a = _set_b_r(s, 6, s.regs.a); }
+static GB_DEVICE void set_6_a(state_t &s) { s.regs.a = _set_b_r(s, 6, s.regs.a); }
 // 0xcbb8
-void set_7_b(state_t &s) { s.regs.b = _set_b_r(s, 7, s.regs.b); }
+static GB_DEVICE void set_7_b(state_t &s) { s.regs.b = _set_b_r(s, 7, s.regs.b); }
 // 0xcbb9
-void set_7_c(state_t &s) { s.regs.c = _set_b_r(s, 7, s.regs.c); }
+static GB_DEVICE void set_7_c(state_t &s) { s.regs.c = _set_b_r(s, 7, s.regs.c); }
 // 0xcbba
-void set_7_d(state_t &s) { s.regs.d = _set_b_r(s, 7, s.regs.d); }
+static GB_DEVICE void set_7_d(state_t &s) { s.regs.d = _set_b_r(s, 7, s.regs.d); }
 // 0xcbbb
-void set_7_e(state_t &s) { s.regs.e = _set_b_r(s, 7, s.regs.e); }
+static GB_DEVICE void set_7_e(state_t &s) { s.regs.e = _set_b_r(s, 7, s.regs.e); }
 // 0xcbbc
-void set_7_h(state_t &s) { s.regs.h = _set_b_r(s, 7, s.regs.h); }
+static GB_DEVICE void set_7_h(state_t &s) { s.regs.h = _set_b_r(s, 7, s.regs.h); }
 // 0xcbbd
-void set_7_l(state_t &s) { s.regs.l = _set_b_r(s, 7, s.regs.l); }
+static GB_DEVICE void set_7_l(state_t &s) { s.regs.l = _set_b_r(s, 7, s.regs.l); }
 // 0xcbbe
-void set_7_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 7, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void set_7_hlp(state_t &s) { write_u8(s, s.regs.hl, _set_b_r(s, 7, read_u8(s, s.regs.hl))); }
 // 0xcbbf
-void set_7_a(state_t &s) { s.regs.a = _set_b_r(s, 7, s.regs.a); }
+static GB_DEVICE void set_7_a(state_t &s) { s.regs.a = _set_b_r(s, 7, s.regs.a); }
 // 0xcbc0
-void res_0_b(state_t &s) { s.regs.b = _res_b_r(s, 0, s.regs.b); }
+static GB_DEVICE void res_0_b(state_t &s) { s.regs.b = _res_b_r(s, 0, s.regs.b); }
 // 0xcbc1
-void res_0_c(state_t &s) { s.regs.c = _res_b_r(s, 0, s.regs.c); }
+static GB_DEVICE void res_0_c(state_t &s) { s.regs.c = _res_b_r(s, 0, s.regs.c); }
 // 0xcbc2
-void res_0_d(state_t &s) { s.regs.d = _res_b_r(s, 0, s.regs.d); }
+static GB_DEVICE void res_0_d(state_t &s) { s.regs.d = _res_b_r(s, 0, s.regs.d); }
 // 0xcbc3
-void res_0_e(state_t &s) { s.regs.e = _res_b_r(s, 0, s.regs.e); }
+static GB_DEVICE void res_0_e(state_t &s) { s.regs.e = _res_b_r(s, 0, s.regs.e); }
 // 0xcbc4
-void res_0_h(state_t &s) { s.regs.h = _res_b_r(s, 0, s.regs.h); }
+static GB_DEVICE void res_0_h(state_t &s) { s.regs.h = _res_b_r(s, 0, s.regs.h); }
 // 0xcbc5
-void res_0_l(state_t &s) { s.regs.l = _res_b_r(s, 0, s.regs.l); }
+static GB_DEVICE void res_0_l(state_t &s) { s.regs.l = _res_b_r(s, 0, s.regs.l); }
 // 0xcbc6
-void res_0_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 0, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_0_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 0, read_u8(s, s.regs.hl))); }
 // 0xcbc7
-void res_0_a(state_t &s) { s.regs.a = _res_b_r(s, 0, s.regs.a); }
+static GB_DEVICE void res_0_a(state_t &s) { s.regs.a = _res_b_r(s, 0, s.regs.a); }
 // 0xcbc8
-void res_1_b(state_t &s) { s.regs.b = _res_b_r(s, 1, s.regs.b); }
+static GB_DEVICE void res_1_b(state_t &s) { s.regs.b = _res_b_r(s, 1, s.regs.b); }
 // 0xcbc9
-void res_1_c(state_t &s) { s.regs.c = _res_b_r(s, 1, s.regs.c); }
+static GB_DEVICE void res_1_c(state_t &s) { s.regs.c = _res_b_r(s, 1, s.regs.c); }
 // 0xcbca
-void res_1_d(state_t &s) { s.regs.d = _res_b_r(s, 1, s.regs.d); }
+static GB_DEVICE void res_1_d(state_t &s) { s.regs.d = _res_b_r(s, 1, s.regs.d); }
 // 0xcbcb
-void res_1_e(state_t &s) { s.regs.e = _res_b_r(s, 1, s.regs.e); }
+static GB_DEVICE void res_1_e(state_t &s) { s.regs.e = _res_b_r(s, 1, s.regs.e); }
 // 0xcbcc
-void res_1_h(state_t &s) { s.regs.h = _res_b_r(s, 1, s.regs.h); }
+static GB_DEVICE void res_1_h(state_t &s) { s.regs.h = _res_b_r(s, 1, s.regs.h); }
 // 0xcbcd
-void res_1_l(state_t &s) { s.regs.l = _res_b_r(s, 1, s.regs.l); }
+static GB_DEVICE void res_1_l(state_t &s) { s.regs.l = _res_b_r(s, 1, s.regs.l); }
 // 0xcbce
-void res_1_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 1, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_1_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 1, read_u8(s, s.regs.hl))); }
 // 0xcbcf
-void res_1_a(state_t &s) { s.regs.a = _res_b_r(s, 1, s.regs.a); }
+static GB_DEVICE void res_1_a(state_t &s) { s.regs.a = _res_b_r(s, 1, s.regs.a); }
 // 0xcbd0
-void res_2_b(state_t &s) { s.regs.b = _res_b_r(s, 2, s.regs.b); }
+static GB_DEVICE void res_2_b(state_t &s) { s.regs.b = _res_b_r(s, 2, s.regs.b); }
 // 0xcbd1
-void res_2_c(state_t &s) { s.regs.c = _res_b_r(s, 2, s.regs.c); }
+static GB_DEVICE void res_2_c(state_t &s) { s.regs.c = _res_b_r(s, 2, s.regs.c); }
 // 0xcbd2
-void res_2_d(state_t &s) { s.regs.d = _res_b_r(s, 2, s.regs.d); }
+static GB_DEVICE void res_2_d(state_t &s) { s.regs.d = _res_b_r(s, 2, s.regs.d); }
 // 0xcbd3
-void res_2_e(state_t &s) { s.regs.e = _res_b_r(s, 2, s.regs.e); }
+static GB_DEVICE void res_2_e(state_t &s) { s.regs.e = _res_b_r(s, 2, s.regs.e); }
 // 0xcbd4
-void res_2_h(state_t &s) { s.regs.h = _res_b_r(s, 2, s.regs.h); }
+static GB_DEVICE void res_2_h(state_t &s) { s.regs.h = _res_b_r(s, 2, s.regs.h); }
 // 0xcbd5
-void res_2_l(state_t &s) { s.regs.l = _res_b_r(s, 2, s.regs.l); }
+static GB_DEVICE void res_2_l(state_t &s) { s.regs.l = _res_b_r(s, 2, s.regs.l); }
 // 0xcbd6
-void res_2_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 2, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_2_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 2, read_u8(s, s.regs.hl))); }
 // 0xcbd7
-void res_2_a(state_t &s) { s.regs.a = _res_b_r(s, 2, s.regs.a); }
+static GB_DEVICE void res_2_a(state_t &s) { s.regs.a = _res_b_r(s, 2, s.regs.a); }
 // 0xcbd8
-void res_3_b(state_t &s) { s.regs.b = _res_b_r(s, 3, s.regs.b); }
+static GB_DEVICE void res_3_b(state_t &s) { s.regs.b = _res_b_r(s, 3, s.regs.b); }
 // 0xcbd9
-void res_3_c(state_t &s) { s.regs.c = _res_b_r(s, 3, s.regs.c); }
+static GB_DEVICE void res_3_c(state_t &s) { s.regs.c = _res_b_r(s, 3, s.regs.c); }
 // 0xcbda
-void res_3_d(state_t &s) { s.regs.d = _res_b_r(s, 3, s.regs.d); }
+static GB_DEVICE void res_3_d(state_t &s) { s.regs.d = _res_b_r(s, 3, s.regs.d); }
 // 0xcbdb
-void res_3_e(state_t &s) { s.regs.e = _res_b_r(s, 3, s.regs.e); }
+static GB_DEVICE void res_3_e(state_t &s) { s.regs.e = _res_b_r(s, 3, s.regs.e); }
 // 0xcbdc
-void res_3_h(state_t &s) { s.regs.h = _res_b_r(s, 3, s.regs.h); }
+static GB_DEVICE void res_3_h(state_t &s) { s.regs.h = _res_b_r(s, 3, s.regs.h); }
 // 0xcbdd
-void res_3_l(state_t &s) { s.regs.l = _res_b_r(s, 3, s.regs.l); }
+static GB_DEVICE void res_3_l(state_t &s) { s.regs.l = _res_b_r(s, 3, s.regs.l); }
 // 0xcbde
-void res_3_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 3, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_3_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 3, read_u8(s, s.regs.hl))); }
 // 0xcbdf
-void res_3_a(state_t &s) { s.regs.a = _res_b_r(s, 3, s.regs.a); }
+static GB_DEVICE void res_3_a(state_t &s) { s.regs.a = _res_b_r(s, 3, s.regs.a); }
 // 0xcbe0
-void res_4_b(state_t &s) { s.regs.b = _res_b_r(s, 4, s.regs.b); }
+static GB_DEVICE void res_4_b(state_t &s) { s.regs.b = _res_b_r(s, 4, s.regs.b); }
 // 0xcbe1
-void res_4_c(state_t &s) { s.regs.c = _res_b_r(s, 4, s.regs.c); }
+static GB_DEVICE void res_4_c(state_t &s) { s.regs.c = _res_b_r(s, 4, s.regs.c); }
 // 0xcbe2
-void res_4_d(state_t &s) { s.regs.d = _res_b_r(s, 4, s.regs.d); }
+static GB_DEVICE void res_4_d(state_t &s) { s.regs.d = _res_b_r(s, 4, s.regs.d); }
 // 0xcbe3
-void res_4_e(state_t &s) { s.regs.e = _res_b_r(s, 4, s.regs.e); }
+static GB_DEVICE void res_4_e(state_t &s) { s.regs.e = _res_b_r(s, 4, s.regs.e); }
 // 0xcbe4
-void res_4_h(state_t &s) { s.regs.h = _res_b_r(s, 4, s.regs.h); }
+static GB_DEVICE void res_4_h(state_t &s) { s.regs.h = _res_b_r(s, 4, s.regs.h); }
 // 0xcbe5
-void res_4_l(state_t &s) { s.regs.l = _res_b_r(s, 4, s.regs.l); }
+static GB_DEVICE void res_4_l(state_t &s) { s.regs.l = _res_b_r(s, 4, s.regs.l); }
 // 0xcbe6
-void res_4_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 4, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_4_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 4, read_u8(s, s.regs.hl))); }
 // 0xcbe7
-void res_4_a(state_t &s) { s.regs.a = _res_b_r(s, 4, s.regs.a); }
+static GB_DEVICE void res_4_a(state_t &s) { s.regs.a = _res_b_r(s, 4, s.regs.a); }
 // 0xcbe8
-void res_5_b(state_t &s) { s.regs.b = _res_b_r(s, 5, s.regs.b); }
+static GB_DEVICE void res_5_b(state_t &s) { s.regs.b = _res_b_r(s, 5, s.regs.b); }
 // 0xcbe9
-void res_5_c(state_t &s) { s.regs.c = _res_b_r(s, 5, s.regs.c); }
+static GB_DEVICE void res_5_c(state_t &s) { s.regs.c = _res_b_r(s, 5, s.regs.c); }
 // 0xcbea
-void res_5_d(state_t &s) { s.regs.d = _res_b_r(s, 5, s.regs.d); }
+static GB_DEVICE void res_5_d(state_t &s) { s.regs.d = _res_b_r(s, 5, s.regs.d); }
 // 0xcbeb
-void res_5_e(state_t &s) { s.regs.e = _res_b_r(s, 5, s.regs.e); }
+static GB_DEVICE void res_5_e(state_t &s) { s.regs.e = _res_b_r(s, 5, s.regs.e); }
 // 0xcbec
-void res_5_h(state_t &s) { s.regs.h = _res_b_r(s, 5, s.regs.h); }
+static GB_DEVICE void res_5_h(state_t &s) { s.regs.h = _res_b_r(s, 5, s.regs.h); }
 // 0xcbed
-void res_5_l(state_t &s) { s.regs.l = _res_b_r(s, 5, s.regs.l); }
+static GB_DEVICE void res_5_l(state_t &s) { s.regs.l = _res_b_r(s, 5, s.regs.l); }
 // 0xcbee
-void res_5_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 5, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_5_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 5, read_u8(s, s.regs.hl))); }
 // 0xcbef
-void res_5_a(state_t &s) { s.regs.a = _res_b_r(s, 5, s.regs.a); }
+static GB_DEVICE void res_5_a(state_t &s) { s.regs.a = _res_b_r(s, 5, s.regs.a); }
 // 0xcbf0
-void res_6_b(state_t &s) { s.regs.b = _res_b_r(s, 6, s.regs.b); }
+static GB_DEVICE void res_6_b(state_t &s) { s.regs.b = _res_b_r(s, 6, s.regs.b); }
 // 0xcbf1
-void res_6_c(state_t &s) { s.regs.c = _res_b_r(s, 6, s.regs.c); }
+static GB_DEVICE void res_6_c(state_t &s) { s.regs.c = _res_b_r(s, 6, s.regs.c); }
 // 0xcbf2
-void res_6_d(state_t &s) { s.regs.d = _res_b_r(s, 6, s.regs.d); }
+static GB_DEVICE void res_6_d(state_t &s) { s.regs.d = _res_b_r(s, 6, s.regs.d); }
 // 0xcbf3
-void res_6_e(state_t &s) { s.regs.e = _res_b_r(s, 6, s.regs.e); }
+static GB_DEVICE void res_6_e(state_t &s) { s.regs.e = _res_b_r(s, 6, s.regs.e); }
 // 0xcbf4
-void res_6_h(state_t &s) { s.regs.h = _res_b_r(s, 6, s.regs.h); }
+static GB_DEVICE void res_6_h(state_t &s) { s.regs.h = _res_b_r(s, 6, s.regs.h); }
 // 0xcbf5
-void res_6_l(state_t &s) { s.regs.l = _res_b_r(s, 6, s.regs.l); }
+static GB_DEVICE void res_6_l(state_t &s) { s.regs.l = _res_b_r(s, 6, s.regs.l); }
 // 0xcbf6
-void res_6_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 6, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_6_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 6, read_u8(s, s.regs.hl))); }
 // 0xcbf7
-void res_6_a(state_t &s) { s.regs.a = _res_b_r(s, 6, s.regs.a); }
+static GB_DEVICE void res_6_a(state_t &s) { s.regs.a = _res_b_r(s, 6, s.regs.a); }
 // 0xcbf8
-void res_7_b(state_t &s) { s.regs.b = _res_b_r(s, 7, s.regs.b); }
+static GB_DEVICE void res_7_b(state_t &s) { s.regs.b = _res_b_r(s, 7, s.regs.b); }
 // 0xcbf9
-void res_7_c(state_t &s) { s.regs.c = _res_b_r(s, 7, s.regs.c); }
+static GB_DEVICE void res_7_c(state_t &s) { s.regs.c = _res_b_r(s, 7, s.regs.c); }
 // 0xcbfa
-void res_7_d(state_t &s) { s.regs.d = _res_b_r(s, 7, s.regs.d); }
+static GB_DEVICE void res_7_d(state_t &s) { s.regs.d = _res_b_r(s, 7, s.regs.d); }
 // 0xcbfb
-void res_7_e(state_t &s) { s.regs.e = _res_b_r(s, 7, s.regs.e); }
+static GB_DEVICE void res_7_e(state_t &s) { s.regs.e = _res_b_r(s, 7, s.regs.e); }
 // 0xcbfc
-void res_7_h(state_t &s) { s.regs.h = _res_b_r(s, 7, s.regs.h); }
+static GB_DEVICE void res_7_h(state_t &s) { s.regs.h = _res_b_r(s, 7, s.regs.h); }
 // 0xcbfd
-void res_7_l(state_t &s) { s.regs.l = _res_b_r(s, 7, s.regs.l); }
+static GB_DEVICE void res_7_l(state_t &s) { s.regs.l = _res_b_r(s, 7, s.regs.l); }
 // 0xcbfe
-void res_7_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 7, read_u8(s, s.regs.hl))); }
+static GB_DEVICE void res_7_hlp(state_t &s) { write_u8(s, s.regs.hl, _res_b_r(s, 7, read_u8(s, s.regs.hl))); }
 // 0xcbff
-void res_7_a(state_t &s) { s.regs.a = _res_b_r(s, 7, s.regs.a); }
+static GB_DEVICE void res_7_a(state_t &s) { s.regs.a = _res_b_r(s, 7, s.regs.a); }
 
-const instruction_t instructions[] = {
+GB_TABLE const instruction_t instructions[] = {
     {"NOP", 1, 4, 0, nop},
     {"LD BC,0x%04X", 3, 12, 2, ld_bc_nn},
     {"LD (BC),A", 1, 8, 0, ld_bcp_a},
@@ -2117,7 +2125,7 @@ const instruction_t instructions[] = {
     {"RST 38h", 1, 16, 0, rst_38h},
 };
 
-const instruction_t bcinstructions[] = {
+GB_TABLE const instruction_t bcinstructions[] = {
     {"RLC B", 2, 8, 0, rlc_b},
     {"RLC C", 2, 8, 0, rlc_c},
     {"RLC D", 2, 8, 0, rlc_d},
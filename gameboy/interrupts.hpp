@@ -2,9 +2,9 @@
 
 #include "state.hpp"
 
-static uint8_t read_u8(state_t &s, _reg16_t ptr);
-static void write_u8(state_t &s, _reg16_t ptr, uint8_t n);
-static void write_u16(state_t &s, _reg16_t ptr, uint16_t n);
+static GB_DEVICE uint8_t read_u8(state_t &s, _reg16_t ptr);
+static GB_DEVICE void write_u8(state_t &s, _reg16_t ptr, uint8_t n);
+static GB_DEVICE void write_u16(state_t &s, _reg16_t ptr, uint16_t n);
 
 namespace Int
 {
@@ -15,51 +15,66 @@ const uint8_t SERIAL   = 1 << 3; // 0101 1000
 const uint8_t JOYPAD   = 1 << 4; // 0110 0000
 }
 
-static void interrupt_trigger(state_t &s, uint8_t i) {
-    uint8_t int_flag = read_u8(s, IF);
-    write_u8(s, IF, int_flag | i);
+// IF and IE live in plain fields; `int_pending` is IF & IE & 0x1f, kept up
+// to date on every change so the CPU only has to test one byte.
+static GB_DEVICE void interrupt_update(state_t &s) {
+    s.int_pending = s.int_flag & s.int_enable & 0x1f;
 }
 
-static void interrupt_clear(state_t &s, uint8_t i) {
-    uint8_t int_flag = read_u8(s, IF);
-    write_u8(s, IF, int_flag & ~i);
+static GB_DEVICE void interrupt_trigger(state_t &s, uint8_t i) {
+    s.int_flag |= i;
+    interrupt_update(s);
 }
 
-static void interrupts_handle(state_t &s) {
-    uint8_t int_flag = read_u8(s, IF);
-    uint8_t int_enable = read_u8(s, IE);
+static GB_DEVICE void interrupt_clear(state_t &s, uint8_t i) {
+    s.int_flag &= ~i;
+    interrupt_update(s);
+}
+
+static GB_DEVICE void interrupt_flag_write(state_t &s, uint8_t n) {
+    s.int_flag = n & 0x1f;
+    interrupt_update(s);
+}
 
-    uint8_t int_fired = int_flag & int_enable & 0x1f;
-    if (int_fired) {
-        s.halt = false;
-        if (s.interrupts_enabled) {
-            s.interrupts_enabled = false;
-            s.regs.sp -= 2;
-            write_u16(s, s.regs.sp, s.pc);
+static GB_DEVICE void interrupt_enable_write(state_t &s, uint8_t n) {
+    s.int_enable = n;
+    interrupt_update(s);
+}
 
-            if (int_fired & Int::VBLANK) {
-                interrupt_clear(s, Int::VBLANK);
-                s.pc = 0x40;
-            }
-            else if (int_fired & Int::LCD_STAT) {
-                interrupt_clear(s, Int::LCD_STAT);
-                s.pc = 0x48;
-            }
-            else if (int_fired & Int::TIMER) {
-                // printf("fired timer interrupt!\n");
-                interrupt_clear(s, Int::TIMER);
-                s.pc = 0x50;
-            }
-            else if (int_fired & Int::SERIAL) {
-                interrupt_clear(s, Int::SERIAL);
-                s.pc = 0x58;
-            }
-            else if (int_fired & Int::JOYPAD) {
-                interrupt_clear(s, Int::JOYPAD);
-                s.pc = 0x60;
-            }
-            s.inst_cycles_wait += 20;
-            // consumes 20 cycles?
-        }
+// Only called at instruction boundaries with int_pending set. Always leaves
+// HALT; returns true if an interrupt was dispatched (IME set).
+static GB_DEVICE bool interrupts_handle(state_t &s) {
+    uint8_t int_fired = s.int_pending;
+
+    s.halt = false;
+    if (!s.interrupts_enabled) {
+        return false;
     }
-}
\ No newline at end of file
+
+    s.interrupts_enabled = false;
+    s.regs.sp -= 2;
+    write_u16(s, s.regs.sp, s.pc);
+
+    if (int_fired & Int::VBLANK) {
+        interrupt_clear(s, Int::VBLANK);
+        s.pc = 0x40;
+    }
+    else if (int_fired & Int::LCD_STAT) {
+        interrupt_clear(s, Int::LCD_STAT);
+        s.pc = 0x48;
+    }
+    else if (int_fired & Int::TIMER) {
+        interrupt_clear(s, Int::TIMER);
+        s.pc = 0x50;
+    }
+    else if (int_fired & Int::SERIAL) {
+        interrupt_clear(s, Int::SERIAL);
+        s.pc = 0x58;
+    }
+    else if (int_fired & Int::JOYPAD) {
+        interrupt_clear(s, Int::JOYPAD);
+        s.pc = 0x60;
+    }
+    s.inst_cycles_wait = 20;
+    return true;
+}
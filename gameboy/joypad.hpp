@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include "config.hpp"
+#if !GB_FREESTANDING
+#include <atomic>
+#endif
+
+#include "state.hpp"
+#include "sched.hpp"
+#include "interrupts.hpp"
+
+// Buttons as seen by the game through P1. The bit for a pressed button
+// reads 0 on the line its group is selected on.
+namespace joy
+{
+const uint8_t RIGHT  = 1 << 0;
+const uint8_t LEFT   = 1 << 1;
+const uint8_t UP     = 1 << 2;
+const uint8_t DOWN   = 1 << 3;
+const uint8_t A      = 1 << 4;
+const uint8_t B      = 1 << 5;
+const uint8_t SELECT = 1 << 6;
+const uint8_t START  = 1 << 7;
+}
+
+// Freestanding builds have no queue and take input through joypad_set().
+//
+// Input arrives through a single-producer single-consumer queue. Each entry
+// is the full button state to take effect at a cycle (or at the start of
+// V-Blank of a frame, when `frame` is set). Stamps must not go backwards;
+// an entry stamped 0 applies as soon as the emulation thread sees it.
+// Scripted runs push everything up front and replay identically every time,
+// interactive hosts push as keys change.
+
+#define JOY_QUEUE_SIZE  256
+#define JOY_POLL_CYCLES 4096    // ~1 ms between looks at an empty queue
+
+#if !GB_FREESTANDING
+struct joy_event_t {
+    uint64_t at;
+    uint8_t buttons;
+    bool frame;
+};
+
+struct joy_queue_t {
+    joy_event_t events[JOY_QUEUE_SIZE];
+    std::atomic<uint32_t> head;     // written by the producer only
+    std::atomic<uint32_t> tail;     // written by the emulation thread only
+};
+
+static void joypad_queue_init(joy_queue_t &q) {
+    q.head.store(0, std::memory_order_relaxed);
+    q.tail.store(0, std::memory_order_relaxed);
+}
+
+// Producer side; returns false if the queue is full.
+static bool joypad_push(joy_queue_t &q, uint64_t at, bool frame, uint8_t buttons) {
+    uint32_t head = q.head.load(std::memory_order_relaxed);
+
+    if (head - q.tail.load(std::memory_order_acquire) == JOY_QUEUE_SIZE) {
+        return false;
+    }
+    joy_event_t &e = q.events[head % JOY_QUEUE_SIZE];
+    e.at = at;
+    e.buttons = buttons;
+    e.frame = frame;
+    q.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+#endif
+
+// Low nibble of P1: the selected groups, active low.
+static GB_DEVICE uint8_t joypad_lines(state_t &s) {
+    uint8_t lines = 0x0f;
+
+    if (!(s.joy_select & 0x10)) {
+        lines &= ~(s.joy_buttons & 0x0f);
+    }
+    if (!(s.joy_select & 0x20)) {
+        lines &= ~(s.joy_buttons >> 4);
+    }
+    return lines;
+}
+
+// Any selected line going from high to low requests the interrupt.
+static GB_DEVICE void joypad_update(state_t &s, uint8_t before) {
+    if (before & ~joypad_lines(s)) {
+        interrupt_trigger(s, Int::JOYPAD);
+    }
+}
+
+static GB_DEVICE void joypad_set(state_t &s, uint8_t buttons) {
+    uint8_t before = joypad_lines(s);
+    s.joy_buttons = buttons;
+    joypad_update(s, before);
+}
+
+static GB_DEVICE uint8_t joypad_read(state_t &s) {
+    return 0xc0 | s.joy_select | joypad_lines(s);
+}
+
+static GB_DEVICE uint8_t joypad_write(state_t &s, uint8_t n) {
+    uint8_t before = joypad_lines(s);
+    s.joy_select = n & 0x30;
+    joypad_update(s, before);
+    return s.joy_select;
+}
+
+#if GB_FREESTANDING
+static GB_DEVICE void joypad_poll(state_t &s, uint64_t now) {
+}
+#else
+// Applies every queued entry that is due and arms the event for the next
+// one. Frame-stamped entries are also picked up at V-Blank by lcd_event().
+static void joypad_poll(state_t &s, uint64_t now) {
+    joy_queue_t &q = *s.joy_queue;
+    uint32_t tail = q.tail.load(std::memory_order_relaxed);
+    uint64_t next = now + JOY_POLL_CYCLES;
+
+    while (tail != q.head.load(std::memory_order_acquire)) {
+        const joy_event_t &e = q.events[tail % JOY_QUEUE_SIZE];
+
+        if (e.frame ? e.at > s.lcd.frame : e.at > now) {
+            if (!e.frame && e.at < next) {
+                next = e.at;
+            }
+            break;
+        }
+        joypad_set(s, e.buttons);
+        tail++;
+    }
+    q.tail.store(tail, std::memory_order_release);
+    sched_set(s.sched, ev::JOYPAD, next);
+}
+#endif
+
+static GB_DEVICE void joypad_event(state_t &s, uint64_t at) {
+    joypad_poll(s, at);
+}
+
+#if !GB_FREESTANDING
+// `q` belongs to the caller and must outlive the attachment.
+static void joypad_attach(state_t &s, joy_queue_t *q) {
+    s.joy_queue = q;
+    sched_set(s.sched, ev::JOYPAD, s.cycles);
+}
+
+static void joypad_detach(state_t &s) {
+    s.joy_queue = nullptr;
+    sched_cancel(s.sched, ev::JOYPAD);
+}
+#endif
+
+static GB_DEVICE void joypad_init(state_t &s) {
+    s.joy_buttons = 0;
+    s.joy_select = 0x30;
+    s.joy_queue = nullptr;
+}
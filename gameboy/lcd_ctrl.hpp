@@ -1,24 +1,24 @@
 #pragma once
 
 #include <cstdint>
-#include <cmath>
 #include "lcd_state.hpp"
 #include "interrupts.hpp"
+#include "lcd_output.hpp"
+#include "lcd_dirty.hpp"
+#include "lcd_fifo.hpp"
 
-static uint8_t read_u8(state_t &s, _reg16_t ptr);
-
-static uint8_t lcd_get_bg_pixel(state_t &s, uint8_t x, uint8_t y) {
-    uint8_t scy = read_u8(s, 0xff42);
-    uint8_t scx = read_u8(s, 0xff43);
+static GB_DEVICE uint8_t lcd_get_bg_pixel(state_t &s, uint8_t x, uint8_t y) {
+    uint8_t scy = s.mem[SCY];
+    uint8_t scx = s.mem[SCX];
 
     uint8_t bgy = (scy + y) % 0xff;
     uint8_t bgx = (scx + x) % 0xff;
 
-    uint8_t tilex = floor(bgx / 8);
-    uint8_t tiley = floor(bgy / 8);
+    uint8_t tilex = bgx / 8;
+    uint8_t tiley = bgy / 8;
 
     uint16_t tilenum_addr = s.lcd.bg_tilemap_addr + tilex + (tiley * 32);
-    uint8_t tilenum = read_u8(s, tilenum_addr);
+    uint8_t tilenum = s.mem[tilenum_addr];
 
     uint16_t tiledata_addr = s.lcd.bg_tiledata_addr;
     if (s.lcd.bg_tiledata_select) {
@@ -29,40 +29,22 @@ static uint8_t lcd_get_bg_pixel(state_t &s, uint8_t x, uint8_t y) {
     }
 
     tiledata_addr += 2 * (bgy % 8);
-    uint8_t b1 = read_u8(s, tiledata_addr);
-    uint8_t b2 = read_u8(s, tiledata_addr + 1);
+    uint8_t b1 = s.mem[tiledata_addr];
+    uint8_t b2 = s.mem[tiledata_addr + 1];
 
     uint8_t mask = 0x80 >> (bgx % 8);
     uint8_t px_col = (!!(b2 & mask) << 1) | !!(b1 & mask);
     return px_col;
 }
 
-static void lcd_draw_bg_line(state_t &s, uint8_t ly) {
+static GB_DEVICE void lcd_draw_bg_line(state_t &s, uint8_t ly) {
     for (uint8_t x = 0; x < 160; x++) {
         uint8_t px = lcd_get_bg_pixel(s, x, ly);
         s.lcd.vram[x + (ly * 160)] = px;
     }
 }
 
-struct alignas(1) object_t 
-{
-    uint8_t y;
-    uint8_t x;
-    uint8_t tile;
-    union {
-        struct alignas(1) {
-            uint8_t cgb_palette : 3;
-            uint8_t bank : 1;
-            uint8_t palette : 1;
-            uint8_t x_flip : 1;
-            uint8_t y_flip : 1;
-            uint8_t bg_priority : 1;
-        };
-        uint8_t flag;
-    };
-};
-
-static void lcd_draw_sprites_line(state_t &s, uint8_t ly) {
+static GB_DEVICE void lcd_draw_sprites_line(state_t &s, uint8_t ly) {
     int sprites_valid = 0;
 
     if(!s.lcd.sprites_enable) {
@@ -89,8 +71,8 @@ static void lcd_draw_sprites_line(state_t &s, uint8_t ly) {
                 tile_py = (height - 1) - tile_py;
             }
             tiledata_addr += 2 * tile_py;
-            uint8_t b1 = read_u8(s, tiledata_addr);
-            uint8_t b2 = read_u8(s, tiledata_addr + 1);
+            uint8_t b1 = s.mem[tiledata_addr];
+            uint8_t b2 = s.mem[tiledata_addr + 1];
 
             for (uint8_t x = 0; x < 8; x++) {
                 uint8_t mask = 0x80 >> x;
@@ -100,7 +82,7 @@ static void lcd_draw_sprites_line(state_t &s, uint8_t ly) {
                 uint8_t px_col = (!!(b2 & mask) << 1) | !!(b1 & mask);
 
                 if (px_col && (sprite_x + x) >= 0 && (sprite_x + x) < 160) {
-                    s.lcd.vram[(sprite_x + x) + (ly * 160)] = px_col;
+                    s.lcd.vram[(sprite_x + x) + (ly * 160)] = ((LCD_PAL_OBP0 + sprite->palette) << 2) | px_col;
                 }
             }
         }
@@ -108,82 +90,274 @@ static void lcd_draw_sprites_line(state_t &s, uint8_t ly) {
 
 }
 
-static void lcd_cycle(state_t &s) {
+// CGB background: the attribute byte in VRAM bank 1 next to each map entry
+// picks the palette, the tile data bank, flips and BG-over-OBJ priority.
+// `prio` gets the color of each pixel, with bit 7 set when the tile claims
+// priority, for the sprite pass.
+static GB_DEVICE void lcd_draw_bg_line_cgb(state_t &s, uint8_t ly, uint8_t prio[160]) {
+    uint8_t bgy = s.mem[SCY] + ly;
+    uint8_t scx = s.mem[SCX];
+    uint8_t *line = &s.lcd.vram[ly * 160];
+
+    for (uint8_t x = 0; x < 160; x++) {
+        uint8_t bgx = scx + x;
+        uint16_t map = s.lcd.bg_tilemap_addr + (bgx >> 3) + (bgy >> 3) * 32 - 0x8000;
+        uint8_t tilenum = s.mem[0x8000 + map];
+        uint8_t attr = s.cgb.vram1[map];
+
+        uint16_t tile = s.lcd.bg_tiledata_select ? tilenum * 16 : 0x1000 + (int8_t)tilenum * 16;
+        uint8_t py = (attr & 0x40) ? 7 - (bgy & 7) : bgy & 7;
+        const uint8_t *data = (attr & 0x08) ? s.cgb.vram1 : s.mem + 0x8000;
+        uint8_t b1 = data[tile + py * 2];
+        uint8_t b2 = data[tile + py * 2 + 1];
+
+        uint8_t bit = (attr & 0x20) ? bgx & 7 : 7 - (bgx & 7);
+        uint8_t px_col = (((b2 >> bit) & 1) << 1) | ((b1 >> bit) & 1);
+
+        line[x] = ((attr & 7) << 2) | px_col;
+        prio[x] = px_col | (attr & 0x80);
+    }
+}
+
+// CGB sprites: palettes 8-15, tile data from either bank, and on overlap
+// the lower OAM index wins, so OAM is walked backwards. With LCDC bit 0
+// clear the background loses all priority.
+static GB_DEVICE void lcd_draw_sprites_line_cgb(state_t &s, uint8_t ly, const uint8_t prio[160]) {
+    if (!s.lcd.sprites_enable) {
+        return;
+    }
+    uint8_t height = (s.lcd.sprite_size * 8) + 8;
+    uint8_t *line = &s.lcd.vram[ly * 160];
+
+    for (int i = 39; i >= 0; i--) {
+        object_t *sprite = (object_t*)(s.mem + SPRITE_ATTRIBUTE_TABLE + (i * 4));
+        int16_t sprite_y = (int16_t)sprite->y - 16;
+        int16_t sprite_x = (int16_t)sprite->x - 8;
+
+        if (ly < sprite_y || ly >= sprite_y + height) {
+            continue;
+        }
+
+        uint8_t tile = (height == 16) ? sprite->tile & 0xfe : sprite->tile;
+        uint8_t tile_py = ly - sprite_y;
+        if (sprite->y_flip) {
+            tile_py = (height - 1) - tile_py;
+        }
+        const uint8_t *data = sprite->bank ? s.cgb.vram1 : s.mem + 0x8000;
+        uint8_t b1 = data[tile * 16 + tile_py * 2];
+        uint8_t b2 = data[tile * 16 + tile_py * 2 + 1];
+
+        for (uint8_t x = 0; x < 8; x++) {
+            int16_t lx = sprite_x + x;
+            uint8_t bit = sprite->x_flip ? x : 7 - x;
+            uint8_t px_col = (((b2 >> bit) & 1) << 1) | ((b1 >> bit) & 1);
+
+            if (!px_col || lx < 0 || lx >= 160) {
+                continue;
+            }
+            if (s.lcd.bg_enable && (prio[lx] & 3) && ((prio[lx] & 0x80) || sprite->bg_priority)) {
+                continue;
+            }
+            line[lx] = ((8 + sprite->cgb_palette) << 2) | px_col;
+        }
+    }
+}
+
+// Line timings in T-cycles. Instead of counting these down every cycle the
+// PPU schedules itself at the next mode boundary and sleeps until then.
+#define LCD_OAM_CYCLES    80
+#define LCD_XFER_CYCLES   172
+#define LCD_HBLANK_CYCLES 204
+#define LCD_LINE_CYCLES   (LCD_OAM_CYCLES + LCD_XFER_CYCLES + LCD_HBLANK_CYCLES)
+
+// The PPU runs on dots, which stay at 4 MHz when the CPU is in double speed,
+// while s.cycles counts CPU clocks.
+static GB_DEVICE uint64_t lcd_dots(state_t &s, uint64_t n) {
+    return n << s.clock_shift;
+}
+
+// Everything that happens to a line at the end of mode 3. Runs on the
+// emulation thread, or on the pipeline worker when one is attached.
+static GB_DEVICE void lcd_render_line(state_t &s, uint8_t ly) {
+    if (s.cgb.enabled) {
+        uint8_t prio[160];
+        lcd_draw_bg_line_cgb(s, ly, prio);
+        lcd_draw_sprites_line_cgb(s, ly, prio);
+    }
+    else {
+        lcd_draw_bg_line(s, ly);
+        lcd_draw_sprites_line(s, ly);
+    }
+    lcd_output_line(s, ly);
+    lcd_track_line(s, ly);
+}
+
+static GB_DEVICE void lcd_pipeline_line(state_t &s, uint8_t ly);
+static GB_DEVICE void lcd_pipeline_vblank(state_t &s);
+static GB_DEVICE void lcd_pipeline_stop(state_t &s);
+static GB_DEVICE void dma_sync(state_t &s, uint64_t now);
+static GB_DEVICE void joypad_poll(state_t &s, uint64_t now);
+static GB_DEVICE void cgb_hblank(state_t &s);
+
+// Accuracy policies for the PPU. lcd_event() and step() are instantiated per
+// policy, so the fast path carries none of the FIFO code or checks.
+
+// Whole line drawn at the end of a fixed 172-cycle mode 3.
+struct ppu_fast {
+    static GB_DEVICE void xfer_begin(state_t &s, uint64_t at) {
+        sched_set(s.sched, ev::LCD, at + lcd_dots(s, LCD_XFER_CYCLES));
+    }
+
+    // returns true when mode 3 is over
+    static GB_DEVICE bool xfer_event(state_t &s, uint64_t at) {
+        if (s.lcd.skip) {
+            return true;
+        }
+        if (s.lcd.pipeline) {
+            lcd_pipeline_line(s, s.lcd.ly);
+        }
+        else {
+            lcd_render_line(s, s.lcd.ly);
+        }
+        return true;
+    }
+
+    static GB_DEVICE void vblank(state_t &s) {
+        if (s.lcd.pipeline) {
+            lcd_pipeline_vblank(s);
+        }
+    }
+};
+
+// Cycle-exact pixel FIFO, one event per dot during mode 3.
+struct ppu_fifo {
+    static GB_DEVICE void xfer_begin(state_t &s, uint64_t at) {
+        lcd_fifo_begin(s);
+        sched_set(s.sched, ev::LCD, at);
+    }
+
+    static GB_DEVICE bool xfer_event(state_t &s, uint64_t at) {
+        if (!lcd_fifo_step(s)) {
+            sched_set(s.sched, ev::LCD, at + lcd_dots(s, 1));
+            return false;
+        }
+        // the FIFO is the mode 3 timing, only its output can be skipped
+        if (!s.lcd.skip) {
+            lcd_output_line(s, s.lcd.ly);
+            lcd_track_line(s, s.lcd.ly);
+        }
+        return true;
+    }
+
+    // pipelined rendering replays whole lines, which this policy can't use
+    static GB_DEVICE void vblank(state_t &s) {
+        if (s.lcd.pipeline) {
+            lcd_pipeline_stop(s);
+        }
+    }
+};
+
+static GB_DEVICE void lcd_check_lyc(state_t &s, lcd_stat_t status) {
+    if (status.ly_int && s.lcd.ly == s.mem[LYC]) {
+        interrupt_trigger(s, Int::LCD_STAT);
+    }
+}
+
+// Runs one mode transition. `at` is the cycle the transition was due, so the
+// next one is scheduled relative to it even if we got here late.
+template <typename ppu = ppu_fast>
+static GB_DEVICE void lcd_event(state_t &s, uint64_t at) {
     lcd_stat_t status;
-    status.raw = read_u8(s, STAT);
-    status.lyc_eq_ly = 0;
+    status.raw = s.mem[STAT];
 
-    s.lcd.cycles += 1;
+    // the PPU is about to look at OAM
+    if (s.dma_active) {
+        dma_sync(s, at);
+    }
 
     switch (s.lcd.mode)
     {
     case lcd::OAM:     // 80 clock cycles   OAM Search
-        if (s.lcd.cycles >= 80) {
-            s.lcd.mode = lcd::OAMRAM;
-        }
+        s.lcd.mode = lcd::OAMRAM;
+        ppu::xfer_begin(s, at);
         break;
-    case lcd::OAMRAM:  // 172 clock cycles  Pixel Transfer
-        if (s.lcd.cycles >= 80 + 172) {
-            s.lcd.mode = lcd::HBLANK;
-
-            lcd_draw_bg_line(s, s.lcd.ly);
-            lcd_draw_sprites_line(s, s.lcd.ly);
+    case lcd::OAMRAM:  // 172+ clock cycles Pixel Transfer
+        if (!ppu::xfer_event(s, at)) {
+            break;
+        }
+        s.lcd.mode = lcd::HBLANK;
 
-            if (status.hblank_int) {
-                interrupt_trigger(s, Int::LCD_STAT);
-            }
+        if (status.hblank_int) {
+            interrupt_trigger(s, Int::LCD_STAT);
         }
+        if (s.cgb.hdma_active) {
+            cgb_hblank(s);
+        }
+        // H-Blank takes up whatever is left of the 456-cycle line
+        sched_set(s.sched, ev::LCD, s.lcd.line_start + lcd_dots(s, LCD_LINE_CYCLES));
         break;
-    case lcd::HBLANK:  // 204 clock cycles  H-Blank
-        if (s.lcd.cycles >= 80 + 172 + 204) {
-            s.lcd.cycles = 0;
-            s.lcd.ly += 1;
-
-            s.lcd.mode = lcd::OAM;
-            if (s.lcd.ly >= 144)
-            {
-                s.lcd.mode = lcd::VBLANK;
-                interrupt_trigger(s, Int::VBLANK);
-                if (status.vblank_int) {
-                    interrupt_trigger(s, Int::LCD_STAT);
-                }
+    case lcd::HBLANK:  // 204- clock cycles H-Blank
+        s.lcd.ly += 1;
+        s.lcd.line_start = at;
+
+        if (s.lcd.ly >= 144) {
+            s.lcd.mode = lcd::VBLANK;
+            s.lcd.frame += 1;
+            ppu::vblank(s);
+            // frame-stamped input lands exactly here
+            if (s.joy_queue) {
+                joypad_poll(s, at);
             }
-
-            if (s.lcd.ly == read_u8(s, LYC)) {
-                status.lyc_eq_ly = 1;
+            interrupt_trigger(s, Int::VBLANK);
+            if (status.vblank_int) {
                 interrupt_trigger(s, Int::LCD_STAT);
             }
+            sched_set(s.sched, ev::LCD, at + lcd_dots(s, LCD_LINE_CYCLES));
         }
+        else {
+            s.lcd.mode = lcd::OAM;
+            sched_set(s.sched, ev::LCD, at + lcd_dots(s, LCD_OAM_CYCLES));
+        }
+        lcd_check_lyc(s, status);
         break;
-    case lcd::VBLANK:  // 4560 clock cycles V-Blank
-        if (s.lcd.cycles >= 80 + 172 + 204) {
-            s.lcd.cycles = 0;
-            s.lcd.ly += 1;
-
-            if (s.lcd.ly >= 154) {
-                s.lcd.ly = 0;
-                s.lcd.mode = lcd::OAM;
-            }
+    case lcd::VBLANK:  // 4560 clock cycles V-Blank, one event per line
+        s.lcd.ly += 1;
+        s.lcd.line_start = at;
 
-            if (s.lcd.ly == read_u8(s, LYC)) {
-                status.lyc_eq_ly = 1;
-                interrupt_trigger(s, Int::LCD_STAT);
-            }
+        if (s.lcd.ly >= 154) {
+            s.lcd.ly = 0;
+            s.lcd.mode = lcd::OAM;
+            sched_set(s.sched, ev::LCD, at + lcd_dots(s, LCD_OAM_CYCLES));
+        }
+        else {
+            sched_set(s.sched, ev::LCD, at + lcd_dots(s, LCD_LINE_CYCLES));
         }
+        lcd_check_lyc(s, status);
         break;
     }
+}
 
+// STAT is never stored with its live bits; mode and the LY=LYC flag are
+// built from the PPU state whenever the CPU reads the register.
+static GB_DEVICE uint8_t lcd_stat_read(state_t &s) {
+    lcd_stat_t status;
+    status.raw = s.mem[STAT] & 0x78;
     status.mode = s.lcd.mode & 3;
-    write_u8(s, STAT, status.raw);
+    status.lyc_eq_ly = (s.lcd.ly == s.mem[LYC]);
+    return status.raw | 0x80;
 }
 
-static void lcd_init(state_t &s) {
+static GB_DEVICE void lcd_init(state_t &s) {
     lcd_t &lcd = s.lcd;
 
     memset(&lcd, 0, sizeof(lcd_t));
+
+    // starts out in H-Blank of line 0, so the first event ends that line
+    lcd.line_start = s.cycles;
+    sched_set(s.sched, ev::LCD, s.cycles + lcd_dots(s, LCD_LINE_CYCLES));
 }
 
-static void lcd_control_set(state_t &s, uint8_t lcdc) {
+static GB_DEVICE void lcd_control_set(state_t &s, uint8_t lcdc) {
     s.lcd.lcd_enable            = (lcdc >> 7) & 0x01;
     s.lcd.window_tilemap_select = (lcdc >> 6) & 0x01;
     s.lcd.window_enable         = (lcdc >> 5) & 0x01;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "state.hpp"
+#include "lcd_output.hpp"
+
+// Per-line change tracking so consumers (display, encoders, streamers) can
+// skip frames or lines that came out identical to what they already have.
+
+static GB_DEVICE uint64_t lcd_hash_line(const uint8_t *px, uint64_t seed) {
+    uint64_t h = seed ^ 0x9e3779b97f4a7c15ull;
+
+    for (int i = 0; i < 160; i += 8) {
+        uint64_t w;
+        memcpy(&w, px + i, 8);
+        h = (h ^ w) * 0x100000001b3ull;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+// Called once a line has been drawn. The seed mixes in the line number and
+// the palettes, so a palette swap or a line moving up or down is a change.
+static GB_DEVICE void lcd_track_line(state_t &s, uint8_t ly) {
+    uint64_t seed = ly | (s.mem[BGP] << 8) | (s.mem[OBP0] << 16) | ((uint64_t)s.mem[OBP1] << 24);
+    seed |= (uint64_t)s.cgb.pal_gen << 32;
+    uint64_t h = lcd_hash_line(&s.lcd.vram[ly * 160], seed);
+
+    if (h != s.lcd.line_hash[ly]) {
+        s.lcd.frame_hash ^= s.lcd.line_hash[ly] ^ h;
+        s.lcd.line_hash[ly] = h;
+        s.lcd.line_changed[ly] = s.lcd.frame;
+        s.lcd.last_change = s.lcd.frame;
+    }
+}
+
+// `since` is the value of lcd.frame the caller saw when it last consumed a
+// frame. Sets one bit per line (LSB first) that changed at or after it and
+// returns how many lines that is.
+static GB_DEVICE int lcd_lines_changed_since(state_t &s, uint64_t since, uint8_t bitmap[LCD_DIRTY_BYTES]) {
+    int changed = 0;
+
+    memset(bitmap, 0, LCD_DIRTY_BYTES);
+    for (int ly = 0; ly < 144; ly++) {
+        if (s.lcd.line_changed[ly] >= since) {
+            bitmap[ly >> 3] |= 1 << (ly & 7);
+            changed++;
+        }
+    }
+    return changed;
+}
+
+static GB_DEVICE bool lcd_frame_changed_since(state_t &s, uint64_t since) {
+    return s.lcd.last_change >= since;
+}
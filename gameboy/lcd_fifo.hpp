@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "state.hpp"
+
+// Dot-by-dot pixel FIFO renderer used by the ppu_fifo policy. Mode 3 lasts
+// as long as the fetcher needs: 172 dots, plus SCX % 8 discarded pixels,
+// plus a refetch when the window starts, plus a stall for every sprite.
+// SCX/SCY, LCDC and the palettes are sampled when each tile or pixel is
+// actually fetched or shifted out, so mid-scanline writes take effect.
+
+static GB_DEVICE uint16_t lcd_fifo_tile_addr(state_t &s, uint8_t tile, uint8_t row) {
+    uint16_t addr = s.lcd.bg_tiledata_select ? 0x8000 + tile * 16 : 0x9000 + (int8_t)tile * 16;
+    return addr + row * 2;
+}
+
+// OAM scan: first ten sprites on this line in OAM order, then ordered by x
+// (ties keep OAM order, which is also DMG drawing priority).
+static GB_DEVICE void lcd_fifo_scan_oam(state_t &s) {
+    lcd_fifo_t &f = s.lcd.fifo;
+    uint8_t height = s.lcd.sprite_size ? 16 : 8;
+
+    f.num_sprites = 0;
+    for (int i = 0; i < 40 && f.num_sprites < 10; i++) {
+        object_t *sprite = (object_t *)(s.mem + SPRITE_ATTRIBUTE_TABLE + i * 4);
+        int16_t sprite_y = (int16_t)sprite->y - 16;
+
+        if (s.lcd.ly >= sprite_y && s.lcd.ly < sprite_y + height) {
+            uint8_t j = f.num_sprites++;
+            while (j > 0 && s.mem[SPRITE_ATTRIBUTE_TABLE + f.sprites[j - 1] * 4 + 1] > sprite->x) {
+                f.sprites[j] = f.sprites[j - 1];
+                j--;
+            }
+            f.sprites[j] = i;
+        }
+    }
+    f.next_sprite = 0;
+}
+
+static GB_DEVICE void lcd_fifo_begin(state_t &s) {
+    lcd_fifo_t &f = s.lcd.fifo;
+
+    if (s.lcd.ly == 0) {
+        f.wy_hit = false;
+        f.win_line = 0;
+    }
+    if (s.lcd.ly == s.mem[WY]) {
+        f.wy_hit = true;
+    }
+
+    memset(f.obj, 0, sizeof(f.obj));
+    f.bg_head = 0;
+    f.bg_count = 0;
+    f.fetch_dot = 0;
+    f.fetch_x = 0;
+    f.first_fetch = true;
+    f.lx = 0;
+    f.discard = s.mem[SCX] & 7;
+    f.stall = 0;
+    f.penalty_col = 0xff;
+    f.window = false;
+    f.window_drawn = false;
+
+    lcd_fifo_scan_oam(s);
+}
+
+static GB_DEVICE void lcd_fifo_fetcher(state_t &s) {
+    lcd_fifo_t &f = s.lcd.fifo;
+
+    if (f.fetch_dot < 6) {
+        f.fetch_dot++;
+
+        uint8_t row;
+        if (f.window) {
+            row = f.win_line;
+        }
+        else {
+            row = s.lcd.ly + s.mem[SCY];
+        }
+
+        switch (f.fetch_dot)
+        {
+        case 2: {
+            uint16_t map = f.window ? s.lcd.win_tilemap_addr : s.lcd.bg_tilemap_addr;
+            uint8_t col = f.window ? f.fetch_x : ((s.mem[SCX] >> 3) + f.fetch_x) & 31;
+            f.tile = s.mem[map + col + (row >> 3) * 32];
+            break;
+        }
+        case 4:
+            f.lo = s.mem[lcd_fifo_tile_addr(s, f.tile, row & 7)];
+            break;
+        case 6:
+            f.hi = s.mem[lcd_fifo_tile_addr(s, f.tile, row & 7) + 1];
+            break;
+        }
+    }
+
+    // push only into an empty FIFO
+    if (f.fetch_dot == 6 && f.bg_count == 0) {
+        f.fetch_dot = 0;
+        if (f.first_fetch) {
+            f.first_fetch = false;
+            return;
+        }
+        for (int x = 0; x < 8; x++) {
+            uint8_t mask = 0x80 >> x;
+            f.bg[(f.bg_head + x) & 15] = (!!(f.hi & mask) << 1) | !!(f.lo & mask);
+        }
+        f.bg_count = 8;
+        f.fetch_x++;
+    }
+}
+
+// Merges the next sprite into the object FIFO. Pixels already claimed by an
+// earlier (higher priority) sprite are kept.
+static GB_DEVICE void lcd_fifo_fetch_sprite(state_t &s) {
+    lcd_fifo_t &f = s.lcd.fifo;
+    object_t *sprite = (object_t *)(s.mem + SPRITE_ATTRIBUTE_TABLE + f.sprites[f.next_sprite++] * 4);
+    uint8_t height = s.lcd.sprite_size ? 16 : 8;
+    uint8_t tile = s.lcd.sprite_size ? (sprite->tile & 0xfe) : sprite->tile;
+
+    uint8_t tile_py = s.lcd.ly - ((int16_t)sprite->y - 16);
+    if (sprite->y_flip) {
+        tile_py = (height - 1) - tile_py;
+    }
+    uint16_t addr = SPRITE_TILES_TABLE + tile * 16 + tile_py * 2;
+    uint8_t b1 = s.mem[addr];
+    uint8_t b2 = s.mem[addr + 1];
+
+    int16_t sprite_x = (int16_t)sprite->x - 8;
+    for (int x = 0; x < 8; x++) {
+        int16_t slot = sprite_x + x - f.lx;
+        if (slot < 0 || slot > 7 || f.obj[slot]) {
+            continue;
+        }
+
+        uint8_t mask = sprite->x_flip ? (0x01 << x) : (0x80 >> x);
+        uint8_t px_col = (!!(b2 & mask) << 1) | !!(b1 & mask);
+        if (px_col) {
+            f.obj[slot] = (sprite->bg_priority << 4) | ((LCD_PAL_OBP0 + sprite->palette) << 2) | px_col;
+        }
+    }
+}
+
+static GB_DEVICE void lcd_fifo_dot(state_t &s) {
+    lcd_fifo_t &f = s.lcd.fifo;
+
+    if (f.stall) {
+        if (--f.stall == 0) {
+            lcd_fifo_fetch_sprite(s);
+        }
+        return;
+    }
+
+    if (s.lcd.sprites_enable && f.next_sprite < f.num_sprites && f.discard == 0) {
+        uint8_t x = s.mem[SPRITE_ATTRIBUTE_TABLE + f.sprites[f.next_sprite] * 4 + 1];
+        if (x <= f.lx + 8) {
+            // the fetcher has to finish its tile first, once per tile column
+            uint8_t fine = (f.lx + (f.window ? 0 : s.mem[SCX])) & 7;
+            uint8_t col = (f.lx + (f.window ? 0 : s.mem[SCX])) >> 3;
+            f.stall = 6;
+            if (col != f.penalty_col && fine < 5) {
+                f.stall += 5 - fine;
+            }
+            f.penalty_col = col;
+
+            if (--f.stall == 0) {
+                lcd_fifo_fetch_sprite(s);
+            }
+            return;
+        }
+    }
+
+    if (s.lcd.window_enable && f.wy_hit && !f.window && f.lx + 7 >= s.mem[WX]) {
+        f.window = true;
+        f.window_drawn = true;
+        f.bg_count = 0;
+        f.fetch_dot = 0;
+        f.fetch_x = 0;
+    }
+
+    if (f.bg_count) {
+        uint8_t color = f.bg[f.bg_head];
+        f.bg_head = (f.bg_head + 1) & 15;
+        f.bg_count--;
+
+        if (f.discard) {
+            f.discard--;
+        }
+        else {
+            uint8_t px = s.lcd.bg_enable ? color : 0;
+            uint8_t obj = f.obj[0];
+            memmove(f.obj, f.obj + 1, 7);
+            f.obj[7] = 0;
+
+            if (obj && s.lcd.sprites_enable && (!(obj & 0x10) || px == 0)) {
+                px = obj & 0x0f;
+            }
+            s.lcd.vram[f.lx + s.lcd.ly * 160] = px;
+            f.lx++;
+        }
+    }
+
+    lcd_fifo_fetcher(s);
+}
+
+// One dot of mode 3; returns true once the line is complete.
+static GB_DEVICE bool lcd_fifo_step(state_t &s) {
+    lcd_fifo_t &f = s.lcd.fifo;
+
+    if (f.lx >= 160) {
+        if (f.window_drawn) {
+            f.win_line++;
+        }
+        return true;
+    }
+    lcd_fifo_dot(s);
+    return false;
+}
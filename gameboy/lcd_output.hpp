@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#if defined(__SSSE3__) && !defined(__CUDA_ARCH__)
+#include <tmmintrin.h>
+#endif
+
+#include "state.hpp"
+
+// Converts finished lines from the palette-index buffer in lcd_t::vram
+// straight into caller-provided framebuffers. Palettes are sampled per line,
+// so mid-frame BGP/OBP writes show up the same way they do on hardware.
+
+// The four DMG shades as bytes R, G, B, A.
+static GB_TABLE const uint32_t lcd_dmg_rgba[4] = {0xff46cbaf, 0xff6daa79, 0xff5f6f22, 0xff552908};
+static GB_TABLE const uint8_t lcd_dmg_gray[4] = {0xff, 0xaa, 0x55, 0x00};
+
+static GB_DEVICE uint16_t lcd_rgb565(uint32_t rgba) {
+    uint8_t r = rgba & 0xff;
+    uint8_t g = (rgba >> 8) & 0xff;
+    uint8_t b = (rgba >> 16) & 0xff;
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+}
+
+static GB_DEVICE uint32_t lcd_output_min_pitch(uint8_t format) {
+    switch (format)
+    {
+    case fb::PACKED_2BPP: return 160 / 4;
+    case fb::INDEXED8:    return 160;
+    case fb::GRAY8:       return 160;
+    case fb::RGB565:      return 160 * 2;
+    case fb::RGBA8888:    return 160 * 4;
+    }
+    return 0;
+}
+
+// Returns the output slot, or -1 if the format/pitch is invalid or all slots
+// are taken. A pitch of 0 means tightly packed lines.
+static GB_DEVICE int lcd_output_attach(state_t &s, void *buf, uint8_t format, uint32_t pitch = 0) {
+    uint32_t min_pitch = lcd_output_min_pitch(format);
+    if (pitch == 0) {
+        pitch = min_pitch;
+    }
+    if (buf == nullptr || min_pitch == 0 || pitch < min_pitch || s.lcd.num_outputs >= LCD_MAX_OUTPUTS) {
+        return -1;
+    }
+
+    lcd_output_t &out = s.lcd.outputs[s.lcd.num_outputs];
+    out.buf = buf;
+    out.pitch = pitch;
+    out.format = format;
+    return s.lcd.num_outputs++;
+}
+
+static GB_DEVICE void lcd_output_detach_all(state_t &s) {
+    s.lcd.num_outputs = 0;
+}
+
+// Shade (0-3) for every vram value (palette << 2) | color.
+static GB_DEVICE void lcd_palette_shades(state_t &s, uint8_t shades[16]) {
+    uint8_t regs[3] = {s.mem[BGP], s.mem[OBP0], s.mem[OBP1]};
+
+    for (int i = 0; i < 16; i++) {
+        uint8_t pal = i >> 2;
+        shades[i] = (pal < 3) ? (regs[pal] >> ((i & 3) * 2)) & 3 : 0;
+    }
+}
+
+// Splits the per-format value of every vram index into byte planes so each
+// plane is a single 16-entry table lookup.
+static GB_DEVICE void lcd_output_planes(uint8_t format, const uint8_t shades[16], uint8_t planes[4][16]) {
+    memset(planes, 0, 4 * 16);
+
+    for (int i = 0; i < 16; i++) {
+        uint8_t shade = shades[i];
+        uint32_t rgba = lcd_dmg_rgba[shade];
+        uint16_t rgb565 = lcd_rgb565(rgba);
+
+        switch (format)
+        {
+        case fb::PACKED_2BPP:
+        case fb::INDEXED8:
+            planes[0][i] = shade;
+            break;
+        case fb::GRAY8:
+            planes[0][i] = lcd_dmg_gray[shade];
+            break;
+        case fb::RGB565:
+            planes[0][i] = rgb565 & 0xff;
+            planes[1][i] = rgb565 >> 8;
+            break;
+        case fb::RGBA8888:
+            planes[0][i] = rgba & 0xff;
+            planes[1][i] = (rgba >> 8) & 0xff;
+            planes[2][i] = (rgba >> 16) & 0xff;
+            planes[3][i] = (rgba >> 24) & 0xff;
+            break;
+        }
+    }
+}
+
+#if defined(__SSSE3__) && !defined(__CUDA_ARCH__)
+static GB_DEVICE void lcd_convert_line(const uint8_t *src, uint8_t format, uint8_t planes[4][16], uint8_t *dst) {
+    __m128i p0 = _mm_loadu_si128((const __m128i *)planes[0]);
+    __m128i p1 = _mm_loadu_si128((const __m128i *)planes[1]);
+    __m128i p2 = _mm_loadu_si128((const __m128i *)planes[2]);
+    __m128i p3 = _mm_loadu_si128((const __m128i *)planes[3]);
+    __m128i weights = _mm_set1_epi32(0x01041040);   // 64, 16, 4, 1
+    __m128i ones = _mm_set1_epi16(1);
+
+    for (int x = 0; x < 160; x += 16) {
+        __m128i px = _mm_loadu_si128((const __m128i *)(src + x));
+        __m128i b0 = _mm_shuffle_epi8(p0, px);
+
+        switch (format)
+        {
+        case fb::PACKED_2BPP: {
+            // s0*64 + s1*16 | s2*4 + s3 per 16 bits, then sum pairs into bytes
+            __m128i v = _mm_madd_epi16(_mm_maddubs_epi16(b0, weights), ones);
+            v = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+            uint32_t packed = _mm_cvtsi128_si32(v);
+            memcpy(dst + x / 4, &packed, 4);
+            break;
+        }
+        case fb::INDEXED8:
+        case fb::GRAY8:
+            _mm_storeu_si128((__m128i *)(dst + x), b0);
+            break;
+        case fb::RGB565: {
+            __m128i b1 = _mm_shuffle_epi8(p1, px);
+            _mm_storeu_si128((__m128i *)(dst + x * 2), _mm_unpacklo_epi8(b0, b1));
+            _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_unpackhi_epi8(b0, b1));
+            break;
+        }
+        case fb::RGBA8888: {
+            __m128i b1 = _mm_shuffle_epi8(p1, px);
+            __m128i b2 = _mm_shuffle_epi8(p2, px);
+            __m128i b3 = _mm_shuffle_epi8(p3, px);
+            __m128i rg_lo = _mm_unpacklo_epi8(b0, b1);
+            __m128i rg_hi = _mm_unpackhi_epi8(b0, b1);
+            __m128i ba_lo = _mm_unpacklo_epi8(b2, b3);
+            __m128i ba_hi = _mm_unpackhi_epi8(b2, b3);
+            _mm_storeu_si128((__m128i *)(dst + x * 4), _mm_unpacklo_epi16(rg_lo, ba_lo));
+            _mm_storeu_si128((__m128i *)(dst + x * 4 + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+            _mm_storeu_si128((__m128i *)(dst + x * 4 + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+            _mm_storeu_si128((__m128i *)(dst + x * 4 + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+            break;
+        }
+        }
+    }
+}
+#else
+static GB_DEVICE void lcd_convert_line(const uint8_t *src, uint8_t format, uint8_t planes[4][16], uint8_t *dst) {
+    for (int x = 0; x < 160; x++) {
+        uint8_t px = src[x] & 0x0f;
+
+        switch (format)
+        {
+        case fb::PACKED_2BPP:
+            if ((x & 3) == 0) {
+                dst[x / 4] = 0;
+            }
+            dst[x / 4] |= planes[0][px] << (6 - (x & 3) * 2);
+            break;
+        case fb::INDEXED8:
+        case fb::GRAY8:
+            dst[x] = planes[0][px];
+            break;
+        case fb::RGB565:
+            dst[x * 2 + 0] = planes[0][px];
+            dst[x * 2 + 1] = planes[1][px];
+            break;
+        case fb::RGBA8888:
+            dst[x * 4 + 0] = planes[0][px];
+            dst[x * 4 + 1] = planes[1][px];
+            dst[x * 4 + 2] = planes[2][px];
+            dst[x * 4 + 3] = planes[3][px];
+            break;
+        }
+    }
+}
+#endif
+
+// CGB lines index the 64 pre-converted palette entries directly. The 2-bit
+// formats have no room for color, they get the color number.
+static GB_DEVICE void lcd_convert_line_cgb(state_t &s, const uint8_t *src, uint8_t format, uint8_t *dst) {
+    const cgb_t &c = s.cgb;
+
+    for (int x = 0; x < 160; x++) {
+        uint8_t px = src[x] & 0x3f;
+
+        switch (format)
+        {
+        case fb::PACKED_2BPP:
+            if ((x & 3) == 0) {
+                dst[x / 4] = 0;
+            }
+            dst[x / 4] |= (px & 3) << (6 - (x & 3) * 2);
+            break;
+        case fb::INDEXED8:
+            dst[x] = px & 3;
+            break;
+        case fb::GRAY8:
+            dst[x] = c.gray[px];
+            break;
+        case fb::RGB565:
+            memcpy(dst + x * 2, &c.rgb565[px], 2);
+            break;
+        case fb::RGBA8888:
+            memcpy(dst + x * 4, &c.rgba[px], 4);
+            break;
+        }
+    }
+}
+
+static GB_DEVICE void lcd_output_line(state_t &s, uint8_t ly) {
+    if (s.lcd.num_outputs == 0) {
+        return;
+    }
+
+    if (s.cgb.enabled) {
+        const uint8_t *line = &s.lcd.vram[ly * 160];
+        for (int i = 0; i < s.lcd.num_outputs; i++) {
+            lcd_output_t &out = s.lcd.outputs[i];
+            lcd_convert_line_cgb(s, line, out.format, (uint8_t *)out.buf + ly * out.pitch);
+        }
+        return;
+    }
+
+    uint8_t shades[16];
+    uint8_t planes[4][16];
+    lcd_palette_shades(s, shades);
+
+    const uint8_t *src = &s.lcd.vram[ly * 160];
+    for (int i = 0; i < s.lcd.num_outputs; i++) {
+        lcd_output_t &out = s.lcd.outputs[i];
+        lcd_output_planes(out.format, shades, planes);
+        lcd_convert_line(src, out.format, planes, (uint8_t *)out.buf + ly * out.pitch);
+    }
+}
+
+// Converts the whole frame in lcd_t::vram again, with the palettes as they
+// are now; for outputs that went stale, e.g. after loading a state.
+static GB_DEVICE void lcd_output_redraw(state_t &s) {
+    for (int ly = 0; ly < 144; ly++) {
+        lcd_output_line(s, ly);
+    }
+}
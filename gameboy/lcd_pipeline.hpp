@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "state.hpp"
+#include "lcd_ctrl.hpp"
+
+#if GB_FREESTANDING
+// No worker thread to hand lines to; s.lcd.pipeline stays null and the
+// PPU's calls into here are never reached.
+static GB_DEVICE bool lcd_pipeline_watches(uint16_t addr) {
+    return false;
+}
+static GB_DEVICE void lcd_pipeline_log(state_t &s, uint16_t addr, uint8_t value) {
+}
+static GB_DEVICE void lcd_pipeline_line(state_t &s, uint8_t ly) {
+}
+static GB_DEVICE void lcd_pipeline_vblank(state_t &s) {
+}
+static GB_DEVICE void lcd_pipeline_stop(state_t &s) {
+}
+#else
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pipelined rendering. The emulation thread keeps all PPU timing (modes, LY,
+// interrupts) but instead of drawing a line it logs every write the renderer
+// can observe, plus a marker where mode 3 ends. A worker thread replays that
+// log against its own copy of VRAM, OAM and the LCD registers one frame
+// behind. Because markers and writes stay in emulation order, per-line
+// register changes (SCX/SCY/palettes) render exactly as they do inline.
+
+namespace lcdlog
+{
+const uint8_t WRITE = 0;
+const uint8_t LINE  = 1;
+}
+
+struct lcd_log_entry_t {
+    uint64_t cycle;
+    uint16_t addr;
+    uint8_t value;      // written byte, or the line number for LINE
+    uint8_t kind;
+};
+
+struct lcd_pipeline_t {
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable cv;
+
+    std::vector<lcd_log_entry_t> log[2];
+    int fill;           // log the emulation thread appends to
+    bool busy;          // worker owns log[fill ^ 1]
+    bool quit;
+
+    state_t shadow;
+    uint8_t shadow_mem[0x10000];
+
+    // The worker converts into its own buffers; changed lines are copied to
+    // the caller's outputs when a frame is published so they never tear.
+    lcd_output_t outputs[LCD_MAX_OUTPUTS];
+    uint8_t num_outputs;
+    std::vector<uint8_t> out_buf[LCD_MAX_OUTPUTS];
+    bool full_copy;
+};
+
+static bool lcd_pipeline_watches(uint16_t addr) {
+    return (addr >= 0x8000 && addr <= 0x9fff)
+        || (addr >= 0xfe00 && addr <= 0xfe9f)
+        || (addr >= LCDC && addr <= WX);
+}
+
+static void lcd_pipeline_log(state_t &s, uint16_t addr, uint8_t value) {
+    lcd_pipeline_t &p = *s.lcd.pipeline;
+    lcd_log_entry_t e = {s.cycles, addr, value, lcdlog::WRITE};
+    p.log[p.fill].push_back(e);
+}
+
+static void lcd_pipeline_line(state_t &s, uint8_t ly) {
+    lcd_pipeline_t &p = *s.lcd.pipeline;
+    lcd_log_entry_t e = {s.cycles, 0, ly, lcdlog::LINE};
+    p.log[p.fill].push_back(e);
+}
+
+static void lcd_pipeline_replay(lcd_pipeline_t &p, const std::vector<lcd_log_entry_t> &log) {
+    state_t &sh = p.shadow;
+
+    for (size_t i = 0; i < log.size(); i++) {
+        const lcd_log_entry_t &e = log[i];
+
+        if (e.kind == lcdlog::LINE) {
+            lcd_render_line(sh, e.value);
+            continue;
+        }
+        sh.mem[e.addr] = e.value;
+        if (e.addr == LCDC) {
+            lcd_control_set(sh, e.value);
+        }
+    }
+}
+
+static void lcd_pipeline_worker(lcd_pipeline_t *p) {
+    std::unique_lock<std::mutex> lk(p->lock);
+
+    for (;;) {
+        p->cv.wait(lk, [p] { return p->busy || p->quit; });
+        if (!p->busy) {
+            break;
+        }
+
+        const std::vector<lcd_log_entry_t> &log = p->log[p->fill ^ 1];
+        lk.unlock();
+        lcd_pipeline_replay(*p, log);
+        lk.lock();
+
+        p->busy = false;
+        p->cv.notify_all();
+    }
+}
+
+// Everything below runs on the emulation thread while the worker is idle.
+
+static void lcd_pipeline_publish(state_t &s, lcd_pipeline_t &p) {
+    lcd_t &src = p.shadow.lcd;
+
+    memcpy(s.lcd.vram, src.vram, sizeof(src.vram));
+    memcpy(s.lcd.line_hash, src.line_hash, sizeof(src.line_hash));
+    memcpy(s.lcd.line_changed, src.line_changed, sizeof(src.line_changed));
+    s.lcd.frame_hash = src.frame_hash;
+    s.lcd.last_change = src.last_change;
+
+    for (int i = 0; i < p.num_outputs; i++) {
+        lcd_output_t &out = p.outputs[i];
+        uint32_t len = lcd_output_min_pitch(out.format);
+
+        for (int ly = 0; ly < 144; ly++) {
+            if (p.full_copy || src.line_changed[ly] == src.frame) {
+                memcpy((uint8_t *)out.buf + ly * out.pitch, &p.out_buf[i][ly * out.pitch], len);
+            }
+        }
+    }
+    p.full_copy = false;
+}
+
+// Mirrors the caller's output list onto worker-owned buffers of the same shape.
+static void lcd_pipeline_configure(state_t &s, lcd_pipeline_t &p) {
+    bool same = (s.lcd.num_outputs == p.num_outputs);
+    for (int i = 0; same && i < p.num_outputs; i++) {
+        same = s.lcd.outputs[i].buf == p.outputs[i].buf
+            && s.lcd.outputs[i].pitch == p.outputs[i].pitch
+            && s.lcd.outputs[i].format == p.outputs[i].format;
+    }
+    if (same) {
+        return;
+    }
+
+    p.num_outputs = s.lcd.num_outputs;
+    p.shadow.lcd.num_outputs = s.lcd.num_outputs;
+    for (int i = 0; i < p.num_outputs; i++) {
+        p.outputs[i] = s.lcd.outputs[i];
+        p.out_buf[i].assign(p.outputs[i].pitch * 144, 0);
+        p.shadow.lcd.outputs[i] = p.outputs[i];
+        p.shadow.lcd.outputs[i].buf = p.out_buf[i].data();
+    }
+    p.full_copy = true;
+}
+
+// Called at the start of V-Blank: waits for the previous frame, publishes it
+// and hands the log of the frame that just ended to the worker.
+static void lcd_pipeline_vblank(state_t &s) {
+    lcd_pipeline_t &p = *s.lcd.pipeline;
+    std::unique_lock<std::mutex> lk(p.lock);
+    p.cv.wait(lk, [&p] { return !p.busy; });
+
+    lcd_pipeline_publish(s, p);
+    lcd_pipeline_configure(s, p);
+
+    // lines of the handed-over frame count as changed in the frame they get
+    // published in, like inline rendering stamps them before V-Blank
+    p.shadow.lcd.frame = s.lcd.frame;
+    p.fill ^= 1;
+    p.log[p.fill].clear();
+    p.busy = true;
+    p.cv.notify_all();
+}
+
+static void lcd_pipeline_start(state_t &s) {
+    if (s.lcd.pipeline) {
+        return;
+    }
+    // the write log replays into a flat 64KB copy, which has no VRAM banks
+    if (s.cgb.enabled) {
+        return;
+    }
+
+    lcd_pipeline_t *p = new lcd_pipeline_t();
+    p->shadow = s;
+    p->shadow.mem = p->shadow_mem;
+    p->shadow.lcd.pipeline = nullptr;
+    p->shadow.lcd.num_outputs = 0;
+    memcpy(p->shadow_mem, s.mem, 0x10000);
+
+    p->fill = 0;
+    p->busy = false;
+    p->quit = false;
+    p->num_outputs = 0;
+    p->log[0].reserve(1 << 14);
+    p->log[1].reserve(1 << 14);
+    lcd_pipeline_configure(s, *p);
+    p->shadow.lcd.frame = s.lcd.frame;
+
+    s.lcd.pipeline = p;
+    p->worker = std::thread(lcd_pipeline_worker, p);
+}
+
+// Drains the worker, renders what has been logged of the current frame and
+// goes back to inline rendering.
+static void lcd_pipeline_stop(state_t &s) {
+    lcd_pipeline_t *p = s.lcd.pipeline;
+    if (!p) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(p->lock);
+        p->quit = true;
+        p->cv.notify_all();
+    }
+    p->worker.join();
+
+    p->shadow.lcd.frame = s.lcd.frame;
+    lcd_pipeline_replay(*p, p->log[p->fill]);
+    // lines stamped with an earlier frame may not have reached the outputs;
+    // after this nothing copies them
+    p->full_copy = true;
+    lcd_pipeline_publish(s, *p);
+
+    s.lcd.pipeline = nullptr;
+    delete p;
+}
+#endif
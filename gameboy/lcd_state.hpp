@@ -1,6 +1,6 @@
 #pragma once
 
-#include <cstdio>
+#include <cstdint>
 #include "config.hpp"
 
 namespace lcd
@@ -14,6 +14,81 @@ const uint8_t OAMRAM = 3;
 #define SPRITE_TILES_TABLE 0x8000
 #define SPRITE_ATTRIBUTE_TABLE 0xfe00
 
+// Pixels in lcd_t::vram are stored before palette mapping as
+// (palette << 2) | color, so the output stage can apply BGP/OBP0/OBP1 itself.
+#define LCD_PAL_BG   0
+#define LCD_PAL_OBP0 1
+#define LCD_PAL_OBP1 2
+
+namespace fb
+{
+const uint8_t PACKED_2BPP = 0;  // 4 shades per byte, leftmost pixel in bits 7-6
+const uint8_t INDEXED8    = 1;  // one shade (0-3) per byte
+const uint8_t GRAY8       = 2;  // 0xff, 0xaa, 0x55, 0x00
+const uint8_t RGB565      = 3;
+const uint8_t RGBA8888    = 4;  // bytes R, G, B, A (SDL_PIXELFORMAT_ABGR8888)
+}
+
+#define LCD_MAX_OUTPUTS 4
+
+#define LCD_DIRTY_BYTES (144 / 8)
+
+struct alignas(1) object_t 
+{
+    uint8_t y;
+    uint8_t x;
+    uint8_t tile;
+    union {
+        struct alignas(1) {
+            uint8_t cgb_palette : 3;
+            uint8_t bank : 1;
+            uint8_t palette : 1;
+            uint8_t x_flip : 1;
+            uint8_t y_flip : 1;
+            uint8_t bg_priority : 1;
+        };
+        uint8_t flag;
+    };
+};
+
+// Pixel FIFO and fetcher state, only used by the ppu_fifo policy.
+struct lcd_fifo_t {
+    uint8_t bg[16];         // ring of 2-bit BG/window colors
+    uint8_t bg_head;
+    uint8_t bg_count;
+    uint8_t obj[8];         // (bg_priority << 4) | (palette << 2) | color, 0 = empty
+
+    uint8_t fetch_dot;      // 0-6 into the current tile fetch
+    uint8_t fetch_x;        // tile column being fetched
+    uint8_t tile;
+    uint8_t lo;
+    uint8_t hi;
+    bool first_fetch;       // the first tile of a line is fetched twice
+
+    uint8_t lx;             // next pixel to output
+    uint8_t discard;        // SCX % 8 pixels dropped at the start of a line
+    uint8_t stall;          // dots left in a sprite fetch
+    uint8_t penalty_col;    // tile column that already paid the sprite wait
+
+    bool window;            // fetching from the window this line
+    bool wy_hit;            // LY matched WY at some point this frame
+    bool window_drawn;
+    uint8_t win_line;
+
+    uint8_t sprites[10];    // OAM indices on this line, sorted by x
+    uint8_t num_sprites;
+    uint8_t next_sprite;
+};
+
+struct lcd_pipeline_t;
+
+// Caller-owned buffer the PPU writes every finished line into.
+struct lcd_output_t {
+    void *buf;
+    uint32_t pitch;     // bytes per line
+    uint8_t format;
+};
+
 struct alignas(1) lcd_stat_t {
     union {
         struct {
@@ -50,9 +125,26 @@ struct lcd_t {
     uint16_t bg_tiledata_addr;
 
     uint8_t mode;
-    unsigned cycles;
     uint8_t ly;
+    uint64_t line_start;    // cycle the current line began
+
+    lcd_fifo_t fifo;
 
     uint8_t vram[144 * 160];
+
+    lcd_output_t outputs[LCD_MAX_OUTPUTS];
+    uint8_t num_outputs;
+    bool skip;              // frames nobody sees: lines are neither drawn nor output
+
+    // Change tracking. `frame` counts V-Blanks; a line drawn while frame == F
+    // that differs from its previous contents gets line_changed = F.
+    uint64_t frame;
+    uint64_t last_change;
+    uint64_t frame_hash;        // xor of all line hashes
+    uint64_t line_hash[144];
+    uint64_t line_changed[144];
+
+    // Set while lines are rendered on a worker thread (see lcd_pipeline.hpp).
+    lcd_pipeline_t *pipeline;
 };
 
@@ -0,0 +1,238 @@
+#pragma once
+
+#if __cplusplus < 202002L
+#error "mcycle.hpp needs C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+
+#include "LR35902.hpp"
+
+// M-cycle core. Every scheduled component (PPU, timer and whatever else owns
+// an ev:: slot) and the CPU run as coroutines resumed by one cooperative
+// scheduler in time order. Instructions are still the plain handlers from
+// instructions.hpp, so the CPU yields between instructions, but each of its
+// memory accesses goes through a bus hook that places it on the M-cycle the
+// timing table says it happens on and first brings every other component up
+// to that cycle. A write to SCX in the last M-cycle of an instruction, or a
+// read of STAT/TIMA, therefore sees the hardware state of that exact cycle.
+//
+// Usage: mc_core_t core; mc_init(core, s); mc_run_until(core, cycle); ...
+// mc_destroy(core). Host only; the step() core stays the portable one.
+//
+// Line rendering and the event handlers are shared with step(), so this
+// core runs at about 80% of its speed on CPU-bound code and level with it
+// on code that mostly halts: 50x realtime where step() manages 65x or so.
+// gb-headless --mcycle measures it.
+
+struct mc_task_t {
+    struct promise_type {
+        mc_task_t get_return_object() {
+            return mc_task_t{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> h;
+};
+
+struct mc_core_t {
+    state_t *s;
+    std::coroutine_handle<> cpu;
+    std::coroutine_handle<> dev[ev::COUNT];
+
+    uint64_t cpu_wake;      // cycle the CPU coroutine wants to run again
+    uint64_t dev_at;        // due time of the component being resumed
+    uint64_t end;           // of the current mc_run_until()
+
+    uint64_t inst_start;    // M-cycle 0 of the current instruction
+    uint8_t access_left;    // M-cycles of it that still touch memory
+    uint8_t access_last;
+};
+
+// Resumes every component that is due at or before `until`, in time order.
+static void mc_run_devices(mc_core_t &c, uint64_t until) {
+    state_t &s = *c.s;
+
+    while (s.sched.next <= until) {
+        uint8_t id = sched_pop(s.sched, c.dev_at);
+        s.cycles = c.dev_at;
+        c.dev[id].resume();
+        sched_update(s.sched);
+    }
+}
+
+static void mc_bus_hook(state_t &s) {
+    mc_core_t &c = *(mc_core_t *)s.bus_ctx;
+
+    // accesses beyond what the table lists stay on the last known M-cycle
+    if (c.access_left) {
+        uint8_t m = 0;
+        while (!(c.access_left & (1 << m))) {
+            m++;
+        }
+        c.access_left &= c.access_left - 1;
+        c.access_last = m;
+    }
+
+    uint64_t at = c.inst_start + c.access_last * 4;
+    if (s.sched.next <= at) {
+        // the PPU reads memory through read_u8 too, those are not CPU accesses
+        s.bus_hook = nullptr;
+        mc_run_devices(c, at);
+        s.bus_hook = mc_bus_hook;
+    }
+    s.cycles = at;
+}
+
+static void mc_expect(mc_core_t &c, uint8_t mask) {
+    c.access_left = mask;
+}
+
+template <typename ppu>
+static mc_task_t mc_device(mc_core_t &c, uint8_t id) {
+    for (;;) {
+        dispatch_event<ppu>(*c.s, id, c.dev_at);
+        co_await std::suspend_always{};
+    }
+}
+
+// Returns the length of what was executed in T-cycles.
+static uint64_t mc_instruction(mc_core_t &c) {
+    state_t &s = *c.s;
+
+    mc_expect(c, 0x01);
+    _inst_t opcode = read_u8(s, s.pc);
+    auto inst = instructions[opcode];
+
+    if (inst.execute == nullptr) {
+        cpu_fault(s, opcode);
+        return 4;
+    }
+
+    // the branch masks list every access of the taken path, the untaken
+    // path only ever performs a prefix of them
+    const inst_timing_t &timing = inst_timings[opcode];
+    mc_expect(c, timing.reads_branch | timing.writes_branch);
+
+    if (inst.length == 2) {
+        s.operand = read_u8(s, s.pc + 1);
+    }
+    else if (inst.length == 3) {
+        s.operand = read_u16(s, s.pc + 1);
+    }
+
+    s.pc += inst.length;
+    s.branch_taken = false;
+    inst.execute(s);
+
+    uint64_t len = s.branch_taken ? timing.cycles_branch : timing.cycles;
+
+    if (s.prefixed) {
+        mc_expect(c, 0x02);
+        opcode = read_u8(s, s.pc);
+
+        const inst_timing_t &cb = cb_inst_timings[opcode];
+        mc_expect(c, cb.reads_branch | cb.writes_branch);
+        bcinstructions[opcode].execute(s);
+        len = cb.cycles;
+        s.pc++;
+        s.prefixed = false;
+    }
+    s.num_inst++;
+    return len;
+}
+
+static mc_task_t mc_cpu(mc_core_t &c) {
+    state_t &s = *c.s;
+
+    for (;;) {
+        c.inst_start = s.cycles;
+        c.access_last = 0;
+        s.bus_hook = mc_bus_hook;
+        s.bus_ctx = &c;
+
+        uint64_t len;
+        mc_expect(c, 0x0c);   // dispatch pushes PC in M-cycles 2 and 3
+        if (s.cpu_stall) {
+            len = s.cpu_stall;
+            s.cpu_stall = 0;
+        }
+        else if (s.int_pending && interrupts_handle(s)) {
+            len = s.inst_cycles_wait;
+        }
+        else if (s.halt) {
+            len = 4;
+            if (s.sched.next != SCHED_NEVER && s.sched.next > s.cycles) {
+                len = (s.sched.next - s.cycles + 3) & ~3ull;
+            }
+        }
+        else {
+            len = mc_instruction(c);
+        }
+
+        s.bus_hook = nullptr;
+        c.cpu_wake = c.inst_start + len;
+
+        // the scheduler would resume the CPU straight away, so skip the trip
+        if (s.sched.next > c.cpu_wake && c.cpu_wake < c.end && !s.stop) {
+            s.cycles = c.cpu_wake;
+            continue;
+        }
+        co_await std::suspend_always{};
+    }
+}
+
+template <typename ppu = ppu_fast>
+static void mc_init(mc_core_t &c, state_t &s) {
+    c.s = &s;
+    c.cpu = mc_cpu(c).h;
+    for (int i = 0; i < ev::COUNT; i++) {
+        c.dev[i] = mc_device<ppu>(c, i).h;
+    }
+    c.cpu_wake = s.cycles;
+    c.dev_at = 0;
+    c.end = s.cycles;
+    c.inst_start = s.cycles;
+    c.access_left = 0;
+    c.access_last = 0;
+}
+
+// Runs everything due before `end`. Components due at the same cycle as the
+// CPU go first, like run_events() does before an instruction in step().
+static void mc_run_until(mc_core_t &c, uint64_t end) {
+    state_t &s = *c.s;
+    c.end = end;
+
+    while (!s.stop) {
+        if (s.sched.next <= c.cpu_wake) {
+            if (s.sched.next >= end) {
+                break;
+            }
+            mc_run_devices(c, s.sched.next);
+        }
+        else {
+            if (c.cpu_wake >= end) {
+                break;
+            }
+            s.cycles = c.cpu_wake;
+            c.cpu.resume();
+        }
+    }
+    if (s.cycles < end && !s.stop) {
+        s.cycles = end;
+    }
+}
+
+static void mc_destroy(mc_core_t &c) {
+    c.cpu.destroy();
+    for (int i = 0; i < ev::COUNT; i++) {
+        c.dev[i].destroy();
+    }
+    c.s->bus_hook = nullptr;
+}
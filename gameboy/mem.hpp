@@ -3,8 +3,16 @@
 #include <cstdint>
 #include "config.hpp"
 #include "lcd_ctrl.hpp"
-
-static unsigned const char bootrom[256] =
+#include "lcd_pipeline.hpp"
+#include "timer.hpp"
+#include "dma.hpp"
+#include "apu.hpp"
+#include "joypad.hpp"
+#include "serial.hpp"
+#include "mem_map.hpp"
+#include "cgb.hpp"
+
+static GB_TABLE unsigned const char bootrom[256] =
     {
         0x31, 0xFE, 0xFF, 0xAF, 0x21, 0xFF, 0x9F, 0x32, 0xCB, 0x7C, 0x20, 0xFB, 0x21, 0x26, 0xFF, 0x0E,
         0x11, 0x3E, 0x80, 0x32, 0xE2, 0x0C, 0x3E, 0xF3, 0xE2, 0x32, 0x3E, 0x77, 0x77, 0x3E, 0xFC, 0xE0,
@@ -32,21 +40,52 @@ static unsigned const char bootrom[256] =
 #define BACKGROUND_MAP_DATA_START 0x9800
 #define BACKGROUND_MAP_DATA_END   0x9fff
 
-static uint8_t read_u8(state_t &s, _reg16_t ptr) {
+static GB_DEVICE uint8_t read_u8(state_t &s, _reg16_t ptr) {
+    if (s.bus_hook) {
+        s.bus_hook(s);
+    }
+
+    if (dma_blocks(s, ptr)) {
+        return 0xff;
+    }
+
 #if USE_BOOTROM
     if (ptr < 0x100) {
         return bootrom[ptr];
     }
 #endif
 
+    if (ptr >= NR10 && ptr < WAVE) {
+        return apu_read(s, ptr);
+    }
+
     switch (ptr)
     {
         case P1:
-            return 0xff;
-            break;
-        case LCDC:
-            printf("reading lcdc\n");
-            break;
+            return joypad_read(s);
+        case SC:
+            return serial_control_read(s);
+        case DIV:
+            return timer_div_read(s);
+        case TIMA:
+            return timer_tima_read(s);
+        case TAC:
+            return s.mem[TAC] | 0xf8;
+        case IF:
+            return s.int_flag | 0xe0;
+        case IE:
+            return s.int_enable;
+        case STAT:
+            return lcd_stat_read(s);
+        case KEY1:
+        case VBK:
+        case HDMA5:
+        case BCPS:
+        case BCPD:
+        case OCPS:
+        case OCPD:
+        case SVBK:
+            return cgb_read(s, ptr);
         case LY: // LCDC (lcd control register)
             // printf("reading ly\n");
             return s.lcd.ly;
@@ -61,84 +100,92 @@ static uint8_t read_u8(state_t &s, _reg16_t ptr) {
         return 0xff;
     }
 
-    return s.mem[ptr];
+    return s.page[ptr >> 12][ptr & 0xfff];
 }
 
-static uint16_t read_u16(state_t &s, _reg16_t ptr) {
+static GB_DEVICE uint16_t read_u16(state_t &s, _reg16_t ptr) {
     return read_u8(s, ptr) | (read_u8(s, ptr + 1) << 8);
 }
 
-static void write_u8(state_t &s, _reg16_t ptr, uint8_t n) {
-    uint16_t tac_values[] = {1024, 16, 64, 256};
-    uint16_t dest;
+static GB_DEVICE void write_u8(state_t &s, _reg16_t ptr, uint8_t n) {
+    if (s.bus_hook) {
+        s.bus_hook(s);
+    }
 
     if (ptr < 0x8000)
         return;
 
+    if (s.dma_active) {
+        // OAM belongs to the transfer, and a write to the page being copied
+        // must not reach bytes that were due before it
+        if (ptr >= 0xfe00 && ptr <= 0xfe9f && dma_blocks(s, ptr)) {
+            return;
+        }
+        if ((ptr >> 8) == (s.dma_src >> 8)) {
+            dma_sync(s, s.cycles);
+        }
+    }
+
+    if (ptr >= NR10 && ptr <= WAVE + 0x0f) {
+        n = apu_write(s, ptr, n);
+    }
+
     switch (ptr)
     {
-    case 0xff02:
-        if (n == 0x81) {
-            char c = read_u8(s, 0xff01);
-            printf("%c", c);
-            n = 0;
-        }
+    case SC:
+        n = serial_control_write(s, n);
+        break;
+    case P1:
+        n = joypad_write(s, n);
         break;
     case DIV:
-        s.divider_counter = 0;
+        apu_div_write(s);
+        timer_div_write(s);
         n = 0;
         break;
+    case TIMA:
+        timer_tima_write(s, n);
+        break;
     case TAC:
-        s.timer_tac = tac_values[n & 3];
-        s.timer_enable = (n >> 2) & 1;
-        // printf("timer enable: %d at speed %d\n", s.timer_enable, s.timer_tac);
+        timer_tac_write(s, n);
         break;
     case LCDC:
         lcd_control_set(s, n);
         break;
+    case STAT:
+        // only the interrupt selects are writable, the rest is computed on read
+        n &= 0x78;
+        break;
     case IE:
-        printf("enabling interrupt.. \n");
-        if (n & (1 << 0)) {
-            printf("Vblank ");
-        }
-        if (n & (1 << 1)) {
-            printf("LCD_stat ");
-        }
-        if (n & (1 << 2)) {
-            printf("Timer ");
-        }
-        printf("ie: %d ", s.interrupts_enabled);
-        printf("\n");
+        interrupt_enable_write(s, n);
         break;
     case IF:
-        // if (s.interrupts_enabled) {
-        //     printf("triggered interrupt: \n");
-        //     if (n & (1 << 0)) {
-        //         printf("Vblank ");
-        //     }
-        //     if (n & (1 << 1)) {
-        //         printf("LCD_stat ");
-        //     }
-        //     if (n & (1 << 2)) {
-        //         printf("Timer ");
-        //     }
-        //     printf("ie: %d ", s.interrupts_enabled);
-        //     printf("\n");
-        // }
+        interrupt_flag_write(s, n);
         break;
     case DMA:
-        // printf("dma transfer request!!!\n");
-        dest = ((n & 0x00ff) << 8);
-        memcpy(&s.mem[0xfe00], &s.mem[dest], 0xfe9f - 0xfe00);
-
+        dma_begin(s, n);
+        break;
+    case KEY1:
+    case VBK:
+    case HDMA5:
+    case BCPS:
+    case BCPD:
+    case OCPS:
+    case OCPD:
+    case SVBK:
+        n = cgb_write(s, ptr, n);
+        break;
     default:
         break;
     }
 
-    s.mem[ptr] = n;
+    if (s.lcd.pipeline && lcd_pipeline_watches(ptr)) {
+        lcd_pipeline_log(s, ptr, n);
+    }
+    s.page[ptr >> 12][ptr & 0xfff] = n;
 }
 
-static void write_u16(state_t &s, _reg16_t ptr, uint16_t n) {
+static GB_DEVICE void write_u16(state_t &s, _reg16_t ptr, uint16_t n) {
     write_u8(s, ptr, (uint8_t)(n & 0x00ff));
     write_u8(s, ptr + 1, (uint8_t)((n & 0xff00) >> 8));
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#include "state.hpp"
+
+// CPU view of memory in 4KB pages. Everything not banked maps straight onto
+// s.mem; in CGB mode VBK swaps pages 8-9 and SVBK swaps page D. Echo RAM at
+// E000 mirrors C000. Hardware registers are decoded before the page table
+// is consulted, so it only ever serves plain memory.
+static GB_DEVICE void mem_map_update(state_t &s) {
+    for (int i = 0; i < 16; i++) {
+        s.page[i] = s.mem + i * 0x1000;
+    }
+    s.page[0xe] = s.mem + 0xc000;
+
+    if (!s.cgb.enabled) {
+        return;
+    }
+    if (s.cgb.vram_bank) {
+        s.page[0x8] = s.cgb.vram1;
+        s.page[0x9] = s.cgb.vram1 + 0x1000;
+    }
+    if (s.cgb.wram_bank >= 2) {
+        s.page[0xd] = s.cgb.wram[s.cgb.wram_bank - 2];
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#if defined(__SSSE3__) && !defined(__CUDA_ARCH__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__) && !defined(__CUDA_ARCH__)
+#include <emmintrin.h>
+#endif
+
+#include "lcd_output.hpp"
+
+// Observation stage for learning agents, the usual preprocessing done in
+// the core instead of per step in Python: grayscale straight from the
+// palette indices in lcd_t::vram, the pixel-wise max of the last two frames
+// (sprites flicker), an area-averaging resize to 84x84 and a stack of the
+// most recent frames.
+//
+// Palettes are sampled once, at the end of the frame; a frame with
+// mid-frame palette writes comes out as if the last palette applied to all
+// of it. The GRAY8 framebuffer output is exact per line.
+
+#define OBS_WIDTH  84
+#define OBS_HEIGHT 84
+#define OBS_SIZE   (OBS_WIDTH * OBS_HEIGHT)
+#define OBS_TAPS   3        // source pixels per output pixel, enough for 160/84
+
+// Area weights of one axis, in 1/256, summing to 256 per output pixel.
+struct obs_axis_t {
+    uint8_t start[OBS_WIDTH > OBS_HEIGHT ? OBS_WIDTH : OBS_HEIGHT];
+    uint16_t weight[OBS_WIDTH > OBS_HEIGHT ? OBS_WIDTH : OBS_HEIGHT][OBS_TAPS];
+};
+
+struct obs_t {
+    obs_axis_t x;
+    obs_axis_t y;
+};
+
+// Output pixel i covers [i * in / out, (i + 1) * in / out) of the source;
+// measured in 1/out of a source pixel everything stays integral.
+static GB_DEVICE void obs_axis_init(obs_axis_t &a, uint32_t in, uint32_t out) {
+    for (uint32_t i = 0; i < out; i++) {
+        uint32_t lo = i * in, hi = lo + in;
+        uint32_t first = lo / out;
+        uint32_t sum = 0, big = 0;
+
+        a.start[i] = first;
+        for (uint32_t t = 0; t < OBS_TAPS; t++) {
+            uint32_t px_lo = (first + t) * out, px_hi = px_lo + out;
+            uint32_t l = px_lo > lo ? px_lo : lo;
+            uint32_t h = px_hi < hi ? px_hi : hi;
+            uint32_t w = h > l ? (h - l) * 256 / in : 0;
+            a.weight[i][t] = w;
+            sum += w;
+            if (w > a.weight[i][big]) {
+                big = t;
+            }
+        }
+        // rounding leftovers go to the largest tap
+        a.weight[i][big] += 256 - sum;
+
+        // taps off the end carry no weight, read a valid line instead
+        if (first + OBS_TAPS > in) {
+            a.start[i] = in - OBS_TAPS;
+            uint32_t shift = first + OBS_TAPS - in;
+            for (int t = OBS_TAPS - 1; t >= 0; t--) {
+                a.weight[i][t] = t >= (int)shift ? a.weight[i][t - shift] : 0;
+            }
+        }
+    }
+}
+
+static GB_DEVICE void obs_init(obs_t &o) {
+    obs_axis_init(o.x, 160, OBS_WIDTH);
+    obs_axis_init(o.y, 144, OBS_HEIGHT);
+}
+
+// The current frame as 8-bit gray, 160x144.
+static GB_DEVICE void obs_gray(state_t &s, uint8_t *dst) {
+    const uint8_t *src = s.lcd.vram;
+
+    if (s.cgb.enabled) {
+        for (int i = 0; i < 144 * 160; i++) {
+            dst[i] = s.cgb.gray[src[i] & 0x3f];
+        }
+        return;
+    }
+
+    uint8_t shades[16], lut[16];
+    lcd_palette_shades(s, shades);
+    for (int i = 0; i < 16; i++) {
+        lut[i] = lcd_dmg_gray[shades[i]];
+    }
+
+#if defined(__SSSE3__) && !defined(__CUDA_ARCH__)
+    __m128i table = _mm_loadu_si128((const __m128i *)lut);
+    __m128i low = _mm_set1_epi8(0x0f);
+    for (int i = 0; i < 144 * 160; i += 16) {
+        __m128i px = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + i)), low);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(table, px));
+    }
+#else
+    for (int i = 0; i < 144 * 160; i++) {
+        dst[i] = lut[src[i] & 0x0f];
+    }
+#endif
+}
+
+// a = max(a, b), pixel-wise.
+static GB_DEVICE void obs_max(uint8_t *a, const uint8_t *b, uint32_t len) {
+    uint32_t i = 0;
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(a + i), _mm_max_epu8(x, y));
+    }
+#endif
+    for (; i < len; i++) {
+        a[i] = a[i] > b[i] ? a[i] : b[i];
+    }
+}
+
+// One output line of the vertical pass: 160 weighted sums of three lines.
+static GB_DEVICE void obs_resize_rows(const uint8_t *r0, const uint8_t *r1, const uint8_t *r2,
+                                      const uint16_t w[OBS_TAPS], uint8_t *dst) {
+    uint32_t x = 0;
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i w0 = _mm_set1_epi16(w[0]), w1 = _mm_set1_epi16(w[1]), w2 = _mm_set1_epi16(w[2]);
+    __m128i half = _mm_set1_epi16(128);
+    for (; x < 160; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(r0 + x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(r1 + x));
+        __m128i c = _mm_loadu_si128((const __m128i *)(r2 + x));
+        // 255 * 256 + 128 still fits 16 bits unsigned
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0),
+                                                 _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1)),
+                                   _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), w2), half));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0),
+                                                 _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1)),
+                                   _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), w2), half));
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+    }
+#endif
+    for (; x < 160; x++) {
+        dst[x] = (r0[x] * w[0] + r1[x] * w[1] + r2[x] * w[2] + 128) >> 8;
+    }
+}
+
+// 160x144 gray to OBS_WIDTH x OBS_HEIGHT: lines first, 16 pixels at a time,
+// then the few taps left per output pixel along each line.
+static GB_DEVICE void obs_resize(const obs_t &o, const uint8_t *src, uint8_t *dst) {
+    uint8_t line[160];
+
+    for (int y = 0; y < OBS_HEIGHT; y++) {
+        const uint8_t *r = src + o.y.start[y] * 160;
+        obs_resize_rows(r, r + 160, r + 320, o.y.weight[y], line);
+
+        for (int x = 0; x < OBS_WIDTH; x++) {
+            const uint8_t *p = line + o.x.start[x];
+            const uint16_t *w = o.x.weight[x];
+            dst[y * OBS_WIDTH + x] = (p[0] * w[0] + p[1] * w[1] + p[2] * w[2] + 128) >> 8;
+        }
+    }
+}
+
+// Shifts a stack of `depth` frames, oldest first, and appends `frame`. A
+// fresh stack (`fill`) gets the frame in every slot.
+static GB_DEVICE void obs_push(uint8_t *stack, uint32_t depth, const uint8_t *frame, bool fill) {
+    if (fill) {
+        for (uint32_t i = 0; i < depth; i++) {
+            memcpy(stack + i * OBS_SIZE, frame, OBS_SIZE);
+        }
+        return;
+    }
+    memmove(stack, stack + OBS_SIZE, (depth - 1) * OBS_SIZE);
+    memcpy(stack + (depth - 1) * OBS_SIZE, frame, OBS_SIZE);
+}
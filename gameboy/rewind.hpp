@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "rle.hpp"
+#include "snapshot.hpp"
+
+// Rewind history: one snapshot per frame in a ring of host memory. Only the
+// newest snapshot is kept whole; every older one is stored as the XOR of it
+// and the one after, run-length coded. From frame to frame most of the
+// machine doesn't change, so a delta is mostly zero runs and takes a few KB
+// instead of snapshot_size(). Going back a frame decodes the newest delta
+// over the whole snapshot, which turns it into the previous one; going
+// forward is just running again. When the ring is full the oldest deltas
+// are dropped, which nothing depends on.
+
+#define REWIND_FRAMING 8    // a u32 size before and after every delta
+
+struct rewind_t {
+    uint8_t *last;          // newest snapshot
+    uint8_t *next;          // snapshot being taken
+    uint8_t *delta;         // delta being written or read
+    uint8_t *ring;
+    size_t ring_size;
+    size_t head;            // running byte positions of the deltas in the ring
+    size_t tail;
+    uint32_t frames;        // deltas in the ring, the frames we can go back
+    bool has_last;
+};
+
+// Smallest ring: one delta that didn't compress.
+#define REWIND_MIN_RING (REWIND_FRAMING + snapshot_size() + RLE_SLACK)
+
+// Memory needed for a history of about `ring` bytes of deltas.
+static GB_DEVICE constexpr size_t rewind_mem_size(size_t ring) {
+    return 3 * snapshot_size() + RLE_SLACK + ring;
+}
+
+// Sets up a history in `size` bytes of caller memory, of any alignment.
+// Returns false when that is too small for even one delta.
+static GB_DEVICE bool rewind_init(rewind_t &r, void *mem, size_t size) {
+    if (size < rewind_mem_size(REWIND_MIN_RING)) {
+        return false;
+    }
+    uint8_t *p = (uint8_t *)mem;
+    r.last = p;
+    r.next = p + snapshot_size();
+    r.delta = p + 2 * snapshot_size();
+    r.ring = r.delta + snapshot_size() + RLE_SLACK;
+    r.ring_size = size - rewind_mem_size(0);
+    r.head = 0;
+    r.tail = 0;
+    r.frames = 0;
+    r.has_last = false;
+    return true;
+}
+
+static GB_DEVICE void rewind_clear(rewind_t &r) {
+    r.head = 0;
+    r.tail = 0;
+    r.frames = 0;
+    r.has_last = false;
+}
+
+static GB_DEVICE void rewind_ring_write(rewind_t &r, size_t at, const void *src, size_t len) {
+    size_t off = at % r.ring_size;
+    size_t first = len < r.ring_size - off ? len : r.ring_size - off;
+    memcpy(r.ring + off, src, first);
+    memcpy(r.ring, (const uint8_t *)src + first, len - first);
+}
+
+static GB_DEVICE void rewind_ring_read(const rewind_t &r, size_t at, void *dst, size_t len) {
+    size_t off = at % r.ring_size;
+    size_t first = len < r.ring_size - off ? len : r.ring_size - off;
+    memcpy(dst, r.ring + off, first);
+    memcpy((uint8_t *)dst + first, r.ring, len - first);
+}
+
+// Records the machine as the newest frame of the history. Returns false when
+// a delta didn't fit even in an empty ring; the history then restarts here.
+static GB_DEVICE bool rewind_push(rewind_t &r, const state_t &s) {
+    if (!r.has_last) {
+        snapshot_save(s, r.last, snapshot_size());
+        r.has_last = true;
+        return true;
+    }
+
+    snapshot_save(s, r.next, snapshot_size());
+    uint32_t size = (uint32_t)rle_encode(r.last, r.next, snapshot_size(), r.delta);
+    uint8_t *swap = r.last;
+    r.last = r.next;
+    r.next = swap;
+
+    size_t need = size + REWIND_FRAMING;
+    if (need > r.ring_size) {
+        r.head = r.tail = 0;
+        r.frames = 0;
+        return false;
+    }
+    while (r.ring_size - (r.head - r.tail) < need) {
+        uint32_t old;
+        rewind_ring_read(r, r.tail, &old, 4);
+        r.tail += old + REWIND_FRAMING;
+        r.frames--;
+    }
+    rewind_ring_write(r, r.head, &size, 4);
+    rewind_ring_write(r, r.head + 4, r.delta, size);
+    rewind_ring_write(r, r.head + 4 + size, &size, 4);
+    r.head += need;
+    r.frames++;
+    return true;
+}
+
+// Puts the machine back up to `frames` frames before the newest one
+// recorded; 0 goes back to the newest. Returns the frames actually gone
+// back, or a snap:: error from loading, which only a machine running
+// another cartridge than the history gets.
+static GB_DEVICE int rewind_step(rewind_t &r, state_t &s, uint32_t frames) {
+    if (!r.has_last) {
+        return 0;
+    }
+    uint32_t n = frames < r.frames ? frames : r.frames;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t size;
+        rewind_ring_read(r, r.head - 4, &size, 4);
+        rewind_ring_read(r, r.head - 4 - size, r.delta, size);
+        rle_apply(r.last, r.delta, size);
+        r.head -= size + REWIND_FRAMING;
+        r.frames--;
+    }
+    int rc = snapshot_load(s, r.last, snapshot_size());
+    return rc == snap::OK ? (int)n : rc;
+}
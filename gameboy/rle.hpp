@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+#include <emmintrin.h>
+#endif
+
+#include "config.hpp"
+
+// Zero-run coding for machine state, whose bytes mostly stay zero or, taken
+// as the XOR against an earlier state, mostly stay the same. Coded data is
+// a sequence of (zeros, literals) pairs, both lengths varints, each followed
+// by its literal bytes. Inputs stay under 2MB, so a pair's varints take at
+// most 6 bytes, and runs shorter than RLE_MIN_RUN stay in the literals: a
+// pair always skips more than it costs and nothing codes to more than its
+// size plus RLE_SLACK.
+
+#define RLE_MIN_RUN 8
+#define RLE_SLACK   16
+
+static GB_DEVICE uint8_t *rle_put_varint(uint8_t *out, uint32_t v) {
+    while (v >= 0x80) {
+        *out++ = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    *out++ = (uint8_t)v;
+    return out;
+}
+
+static GB_DEVICE const uint8_t *rle_get_varint(const uint8_t *in, uint32_t &v) {
+    v = 0;
+    for (int shift = 0; ; shift += 7) {
+        uint8_t b = *in++;
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return in;
+        }
+    }
+}
+
+static GB_DEVICE uint8_t rle_at(const uint8_t *b, size_t i) {
+    return b ? b[i] : 0;
+}
+
+// Length of the run of equal bytes of a and b starting at i.
+static GB_DEVICE size_t rle_equal_run(const uint8_t *a, const uint8_t *b, size_t i, size_t n) {
+    size_t start = i;
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = b ? _mm_loadu_si128((const __m128i *)(b + i)) : _mm_setzero_si128();
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) {
+            break;
+        }
+    }
+#else
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x, y = 0;
+        memcpy(&x, a + i, 8);
+        if (b) {
+            memcpy(&y, b + i, 8);
+        }
+        if (x != y) {
+            break;
+        }
+    }
+#endif
+    while (i < n && a[i] == rle_at(b, i)) {
+        i++;
+    }
+    return i - start;
+}
+
+// Codes a ^ b, n bytes; with b null, a itself. Returns the coded size.
+// Output never gets more than 6 bytes ahead of the input it has read, so
+// `out` may overlap `a` if it starts at least RLE_SLACK bytes before it.
+static GB_DEVICE size_t rle_encode(const uint8_t *a, const uint8_t *b, size_t n, uint8_t *out) {
+    uint8_t *start = out;
+    size_t i = 0;
+
+    while (i < n) {
+        size_t zeros = rle_equal_run(a, b, i, n);
+        i += zeros;
+        if (i == n) {
+            break;
+        }
+
+        // literals run on until a long enough zero run or the end
+        size_t lit = i;
+        while (i < n) {
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+            // skip 16 bytes where no long enough run starts: none fits in
+            // them and none runs on past their end
+            if (i + 16 <= n) {
+                __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+                __m128i y = b ? _mm_loadu_si128((const __m128i *)(b + i)) : _mm_setzero_si128();
+                uint32_t eq = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+                uint32_t run = eq;
+                for (int k = 1; k < RLE_MIN_RUN; k++) {
+                    run &= eq >> k;
+                }
+                if (!run && !(eq & 0x8000)) {
+                    i += 16;
+                    continue;
+                }
+            }
+#endif
+            if (a[i] != rle_at(b, i)) {
+                i++;
+                continue;
+            }
+            size_t z = rle_equal_run(a, b, i, n);
+            if (z >= RLE_MIN_RUN || i + z == n) {
+                break;
+            }
+            i += z;
+        }
+
+        out = rle_put_varint(out, (uint32_t)zeros);
+        out = rle_put_varint(out, (uint32_t)(i - lit));
+        for (size_t k = lit; k < i; k++) {
+            *out++ = a[k] ^ rle_at(b, k);
+        }
+    }
+    return out - start;
+}
+
+// XORs decoded data into dst: a delta onto what it was taken against, or
+// plain coded data onto zeros.
+static GB_DEVICE void rle_apply(uint8_t *dst, const uint8_t *in, size_t size) {
+    const uint8_t *end = in + size;
+
+    while (in < end) {
+        uint32_t zeros, lit;
+        in = rle_get_varint(in, zeros);
+        in = rle_get_varint(in, lit);
+        dst += zeros;
+        uint32_t k = 0;
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+        for (; k + 16 <= lit; k += 16) {
+            __m128i x = _mm_loadu_si128((const __m128i *)(dst + k));
+            __m128i y = _mm_loadu_si128((const __m128i *)(in + k));
+            _mm_storeu_si128((__m128i *)(dst + k), _mm_xor_si128(x, y));
+        }
+#endif
+        for (; k < lit; k++) {
+            dst[k] ^= in[k];
+        }
+        dst += lit;
+        in += lit;
+    }
+}
+
+// Whether `size` bytes of untrusted coded data stay within `n` bytes when
+// decoded; trailing zeros are left out, so they may come short of it.
+static GB_DEVICE bool rle_valid(const uint8_t *in, size_t size, size_t n) {
+    const uint8_t *end = in + size;
+    size_t total = 0;
+
+    while (in < end) {
+        uint32_t len[2];
+        for (int j = 0; j < 2; j++) {
+            len[j] = 0;
+            for (int shift = 0; ; shift += 7) {
+                if (in == end || shift > 28) {
+                    return false;
+                }
+                uint8_t b = *in++;
+                len[j] |= (uint32_t)(b & 0x7f) << shift;
+                if (!(b & 0x80)) {
+                    break;
+                }
+            }
+        }
+        if (len[1] > (size_t)(end - in) || len[0] > n - total || len[1] > n - total - len[0]) {
+            return false;
+        }
+        in += len[1];
+        total += len[0] + len[1];
+    }
+    return true;
+}
+
+// Reads single bytes out of coded data without decoding the rest, for a
+// look at a few fields before committing to it. Reads going forward cost
+// one pass over the data in all; going back starts over. The data must
+// have passed rle_valid().
+struct rle_reader_t {
+    const uint8_t *in;
+    const uint8_t *end;
+    const uint8_t *next;    // pair after the current one
+    const uint8_t *lits;    // literals of the current pair
+    size_t base;            // decoded offset of the current pair
+    uint32_t zeros;
+    uint32_t lit;
+};
+
+static GB_DEVICE void rle_reader_init(rle_reader_t &r, const uint8_t *in, size_t size) {
+    r.in = in;
+    r.end = in + size;
+    r.next = in;
+    r.lits = in;
+    r.base = 0;
+    r.zeros = 0;
+    r.lit = 0;
+}
+
+static GB_DEVICE uint8_t rle_read_u8(rle_reader_t &r, size_t at) {
+    if (at < r.base) {
+        rle_reader_init(r, r.in, r.end - r.in);
+    }
+    while (at >= r.base + r.zeros + r.lit && r.next < r.end) {
+        r.base += r.zeros + r.lit;
+        r.next = rle_get_varint(r.next, r.zeros);
+        r.next = rle_get_varint(r.next, r.lit);
+        r.lits = r.next;
+        r.next += r.lit;
+    }
+    size_t i = at - r.base;
+    return i >= r.zeros && i - r.zeros < r.lit ? r.lits[i - r.zeros] : 0;
+}
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <fstream>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include "config.hpp"
 
 #define ROM_ENTRY_OFFSET    0x100
@@ -10,12 +12,18 @@
 #define ROM_ROM_SIZE_OFFSET 0x148
 #define ROM_RAM_SIZE_OFFSET 0x149
 
-int load_rom(uint8_t **buf) {
-    std::ifstream file("/home/rico/Documents/programming/gameboy/games/tetris.gb");
-    // std::ifstream file("/home/rico/Documents/programming/gameboy/games/drmario.gb");
+#define ROM_DEFAULT_PATH "/home/rico/Documents/programming/gameboy/games/tetris.gb"
+
+// Reads a cartridge image into a malloc'd buffer of at least 32KB, zero
+// padded, so the core can always copy the two fixed banks. Prints nothing,
+// errors included, unless `verbose`.
+static int load_rom(uint8_t **buf, const char *path = ROM_DEFAULT_PATH, bool verbose = true) {
+    std::ifstream file(path, std::ios::binary);
 
     if (!file) {
-        printf("Error opening rom file!\n");
+        if (verbose) {
+            printf("Error opening rom file %s!\n", path);
+        }
         return -1;
     }
 
@@ -23,9 +31,14 @@ int load_rom(uint8_t **buf) {
     int length = file.tellg();
     file.seekg (0, file.beg);
 
-    printf("rom size: %d\n", length);
+    if (length < 0x150) {
+        if (verbose) {
+            printf("Error: %s is too small for a cartridge header\n", path);
+        }
+        return -1;
+    }
 
-    char *buffer = (char*)malloc(length);
+    char *buffer = (char*)calloc(length < 0x8000 ? 0x8000 : length, 1);
     file.read(buffer, length);
 
     char *rom_title = &buffer[ROM_TITLE_OFFSET];
@@ -33,9 +46,12 @@ int load_rom(uint8_t **buf) {
     unsigned cartridge_rom_size = (1<<15) << buffer[ROM_ROM_SIZE_OFFSET];
     unsigned cartridge_ram_size = buffer[ROM_RAM_SIZE_OFFSET];
 
-    printf("cartridge title: %s\n", rom_title);
-    printf("cartridge rom size: %04x\n", cartridge_rom_size);
-    printf("cartridge ram size: %04x\n", cartridge_ram_size);
+    if (verbose) {
+        printf("rom size: %d\n", length);
+        printf("cartridge title: %.16s\n", rom_title);
+        printf("cartridge rom size: %04x\n", cartridge_rom_size);
+        printf("cartridge ram size: %04x\n", cartridge_ram_size);
+    }
 
     *buf = (uint8_t*)buffer;
     file.close();
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+#include "snapshot.hpp"
+
+// Run-ahead. Games typically read the joypad a frame or two before the
+// frame that shows the reaction, so a button press takes that long to
+// appear. After every real frame the machine is saved, run `frames` more
+// frames on the current input, and restored: the host shows the last of
+// them, the frame the press would have produced by then, while emulation
+// carries on from the real one.
+//
+// The speculative frames leave no trace: lines are only drawn in the last
+// one (into the same outputs), and audio, the input queue and the serial
+// device are detached throughout, so nothing is heard twice or consumed
+// early. Restoring puts the saved synthesis position back as it was, so the
+// audio stream continues without a gap.
+//
+// `buf` takes snapshot_size() bytes; `run_frame` runs the machine up to the
+// next V-Blank with whatever core the host uses. Queued input that is due
+// should be applied first (joypad_poll()), or it only counts from the next
+// real frame on.
+
+template <typename Run>
+static GB_DEVICE void runahead(state_t &s, void *buf, uint32_t frames, Run run_frame) {
+    if (frames == 0) {
+        return;
+    }
+    snapshot_save(s, buf, snapshot_size());
+
+    apu_ring_t *ring = s.apu.ring;
+    joy_queue_t *joy_queue = s.joy_queue;
+    serial_device_t *serial = s.serial;
+    uint64_t joy_at = s.sched.at[ev::JOYPAD];
+    s.apu.ring = nullptr;
+    s.joy_queue = nullptr;
+    s.serial = nullptr;
+    sched_cancel(s.sched, ev::JOYPAD);  // polls the queue; restored with the rest
+
+    s.lcd.skip = true;
+    for (uint32_t i = 1; i < frames && !s.stop; i++) {
+        run_frame(s);
+    }
+    s.lcd.skip = false;
+    if (!s.stop) {
+        run_frame(s);
+    }
+
+    // without a ring attached the load doesn't restart synthesis; without a
+    // queue it drops the input poll, which goes back as it was
+    snapshot_load(s, buf, snapshot_size());
+    s.apu.ring = ring;
+    s.joy_queue = joy_queue;
+    s.serial = serial;
+    s.sched.at[ev::JOYPAD] = joy_at;
+    sched_update(s.sched);
+}
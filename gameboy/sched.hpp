@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include "config.hpp"
+
+// Absolute-time event slots. Components that used to be ticked once per
+// T-cycle store the cycle at which they next need attention here instead,
+// and step() only calls into them once s.cycles reaches that point.
+namespace ev
+{
+const uint8_t LCD    = 0;
+const uint8_t TIMER  = 1;
+const uint8_t DMA    = 2;
+const uint8_t APU    = 3;
+const uint8_t JOYPAD = 4;
+const uint8_t SERIAL = 5;
+const uint8_t COUNT  = 6;
+}
+
+#define SCHED_NEVER UINT64_MAX
+
+struct sched_t {
+    uint64_t at[ev::COUNT];
+    uint64_t next;      // min(at[]), the only value step() looks at
+};
+
+static GB_DEVICE void sched_update(sched_t &sc) {
+    uint64_t next = SCHED_NEVER;
+    for (int i = 0; i < ev::COUNT; i++) {
+        if (sc.at[i] < next) {
+            next = sc.at[i];
+        }
+    }
+    sc.next = next;
+}
+
+static GB_DEVICE void sched_init(sched_t &sc) {
+    for (int i = 0; i < ev::COUNT; i++) {
+        sc.at[i] = SCHED_NEVER;
+    }
+    sc.next = SCHED_NEVER;
+}
+
+static GB_DEVICE void sched_set(sched_t &sc, uint8_t id, uint64_t at) {
+    sc.at[id] = at;
+    sched_update(sc);
+}
+
+static GB_DEVICE void sched_cancel(sched_t &sc, uint8_t id) {
+    sched_set(sc, id, SCHED_NEVER);
+}
+
+// Takes the earliest slot out of the schedule. The handler is expected to
+// re-arm itself relative to the returned time, not to s.cycles.
+static GB_DEVICE uint8_t sched_pop(sched_t &sc, uint64_t &at) {
+    uint8_t id = 0;
+    for (int i = 1; i < ev::COUNT; i++) {
+        if (sc.at[i] < sc.at[id]) {
+            id = i;
+        }
+    }
+    at = sc.at[id];
+    sc.at[id] = SCHED_NEVER;
+    return id;
+}
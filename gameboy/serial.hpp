@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include "config.hpp"
+#if !GB_FREESTANDING
+#include <cstdio>
+#endif
+
+#include "state.hpp"
+#include "sched.hpp"
+#include "interrupts.hpp"
+
+// Serial port. Writing SC with bits 7 and 0 set starts an internally
+// clocked transfer: 8 bits at 8192 Hz, so the byte in SB is exchanged with
+// whatever is on the other end 4096 cycles later, SC bit 7 drops and the
+// serial interrupt is requested. The other end is a serial_device_t; with
+// none attached the line floats high and 0xFF comes back. On the CGB, SC
+// bit 1 selects the fast clock, 32 times faster.
+
+#define SERIAL_BYTE_CYCLES 4096
+#define SERIAL_FAST_SHIFT  5
+
+struct serial_device_t {
+    // Gets the byte shifted out, returns the byte shifted in.
+    uint8_t (*exchange)(serial_device_t *dev, uint8_t out);
+    void *ctx;
+};
+
+// Collects output in memory, e.g. the result text of a test ROM.
+struct serial_buffer_t {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t len;
+};
+
+static GB_DEVICE uint8_t serial_buffer_exchange(serial_device_t *dev, uint8_t out) {
+    serial_buffer_t &b = *(serial_buffer_t *)dev->ctx;
+
+    if (b.len < b.size) {
+        b.data[b.len++] = out;
+    }
+    return 0xff;
+}
+
+static GB_DEVICE void serial_buffer_device(serial_device_t &dev, serial_buffer_t &b) {
+    dev.exchange = serial_buffer_exchange;
+    dev.ctx = &b;
+}
+
+#if !GB_FREESTANDING
+// Writes output to a stdio stream; stdio does the buffering.
+static uint8_t serial_file_exchange(serial_device_t *dev, uint8_t out) {
+    fputc(out, (FILE *)dev->ctx);
+    return 0xff;
+}
+
+static void serial_file_device(serial_device_t &dev, FILE *f) {
+    dev.exchange = serial_file_exchange;
+    dev.ctx = f;
+}
+#endif
+
+// Link cable to another instance. The peer takes the master's byte and, if
+// it was waiting on an external clock transfer, finishes it. The exchange
+// happens at the master's completion time, so both instances should be
+// stepped from one thread and kept close together in emulated time.
+static GB_DEVICE uint8_t serial_link_exchange(serial_device_t *dev, uint8_t out) {
+    state_t &peer = *(state_t *)dev->ctx;
+    uint8_t in = peer.mem[SB];
+
+    peer.mem[SB] = out;
+    if ((peer.mem[SC] & 0x81) == 0x80) {
+        peer.mem[SC] &= 0x7f;
+        interrupt_trigger(peer, Int::SERIAL);
+    }
+    return in;
+}
+
+static GB_DEVICE void serial_attach(state_t &s, serial_device_t *dev) {
+    s.serial = dev;
+}
+
+static GB_DEVICE void serial_detach(state_t &s) {
+    s.serial = nullptr;
+}
+
+// Connects two instances; the devices belong to the caller.
+static GB_DEVICE void serial_link(state_t &a, serial_device_t &dev_a, state_t &b, serial_device_t &dev_b) {
+    dev_a.exchange = serial_link_exchange;
+    dev_a.ctx = &b;
+    dev_b.exchange = serial_link_exchange;
+    dev_b.ctx = &a;
+    serial_attach(a, &dev_a);
+    serial_attach(b, &dev_b);
+}
+
+static GB_DEVICE void serial_event(state_t &s, uint64_t at) {
+    uint8_t out = s.mem[SB];
+
+    s.mem[SB] = s.serial ? s.serial->exchange(s.serial, out) : 0xff;
+    s.mem[SC] &= 0x7f;
+    interrupt_trigger(s, Int::SERIAL);
+}
+
+// Externally clocked transfers wait for the peer; clearing bit 7 aborts.
+static GB_DEVICE uint8_t serial_control_write(state_t &s, uint8_t n) {
+    if ((n & 0x81) == 0x81) {
+        bool fast = s.cgb.enabled && (n & 0x02);
+        sched_set(s.sched, ev::SERIAL, s.cycles + (SERIAL_BYTE_CYCLES >> (fast ? SERIAL_FAST_SHIFT : 0)));
+    }
+    else {
+        sched_cancel(s.sched, ev::SERIAL);
+    }
+    return n;
+}
+
+static GB_DEVICE uint8_t serial_control_read(state_t &s) {
+    return s.mem[SC] | (s.cgb.enabled ? 0x7c : 0x7e);
+}
+
+static GB_DEVICE void serial_init(state_t &s) {
+    s.serial = nullptr;
+    s.mem[SB] = 0;
+    s.mem[SC] = 0;
+}
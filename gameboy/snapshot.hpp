@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "apu.hpp"
+#include "mem_map.hpp"
+
+// Save states. A snapshot is a fixed-size image of the whole machine: a
+// header, state_t as it is in memory and the 64KB address space, so saving
+// and loading are a few memcpys into and out of a caller's buffer, with no
+// allocation and no per-field encoding.
+//
+// The pointers in state_t belong to the host (memory, attached outputs,
+// queues, devices, hooks), as does lcd_t::skip; they are zeroed in the
+// image, so two identical machines save to identical bytes. Loading keeps
+// the ones of the machine loaded into. Bump SNAPSHOT_VERSION whenever
+// state_t changes meaning without changing size; a size change is caught on
+// its own.
+
+#define SNAPSHOT_MAGIC   0x53425543     // "CUBS"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_MEM     0x10000
+
+namespace snap
+{
+const int OK      = 0;
+const int SIZE    = -1;     // buffer too small
+const int VERSION = -2;     // not a snapshot, one of another build, or damaged
+const int ROM     = -3;     // taken with another cartridge
+}
+
+struct snapshot_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t state_size;    // sizeof(state_t) of the writer
+    uint32_t mem_size;
+    uint32_t rom_id;        // see snapshot_rom_id()
+    uint32_t reserved[3];
+};
+
+static GB_DEVICE constexpr size_t snapshot_size() {
+    return sizeof(snapshot_header_t) + sizeof(state_t) + SNAPSHOT_MEM;
+}
+
+// Identifies the cartridge by its header: title, version and checksums.
+static GB_DEVICE uint32_t snapshot_rom_id(const uint8_t *mem) {
+    uint32_t h = 2166136261u;
+    for (int i = 0x134; i < 0x150; i++) {
+        h = (h ^ mem[i]) * 16777619u;
+    }
+    return h;
+}
+
+// A loaded state_t is trusted by the core: some fields index arrays or
+// address memory, and events far behind the clock would keep it catching
+// up for ages. Those fields are checked in the image first, through
+// get(offset, dst, size), in state_t order.
+#define SNAPSHOT_MAX_CYCLES (1ull << 62)
+#define SNAPSHOT_MAX_LAG    (1u << 20)  // well past the longest stall
+
+template <typename T, typename Get>
+static GB_DEVICE T snapshot_get(Get &get, size_t offset) {
+    T v;
+    get(offset, &v, sizeof(T));
+    return v;
+}
+
+#define SNAPSHOT_GET(get, field) snapshot_get<decltype(((state_t *)0)->field)>(get, offsetof(state_t, field))
+
+template <typename Get>
+static GB_DEVICE bool snapshot_state_valid(Get &get) {
+    uint16_t win_map = SNAPSHOT_GET(get, lcd.win_tilemap_addr);
+    uint16_t bg_map = SNAPSHOT_GET(get, lcd.bg_tilemap_addr);
+    uint16_t bg_data = SNAPSHOT_GET(get, lcd.bg_tiledata_addr);
+    uint8_t mode = SNAPSHOT_GET(get, lcd.mode);
+    uint8_t ly = SNAPSHOT_GET(get, lcd.ly);
+    uint64_t line_start = SNAPSHOT_GET(get, lcd.line_start);
+    if ((win_map != 0x9800 && win_map != 0x9c00) || (bg_map != 0x9800 && bg_map != 0x9c00) ||
+        (bg_data != 0x8000 && bg_data != 0x9000) || mode > 3 || ly > 153 || (mode != lcd::VBLANK && ly >= 144)) {
+        return false;
+    }
+
+    uint8_t bg_head = SNAPSHOT_GET(get, lcd.fifo.bg_head);
+    uint8_t stall = SNAPSHOT_GET(get, lcd.fifo.stall);
+    bool sprites_valid = true;
+    for (int i = 0; i < 10; i++) {
+        sprites_valid &= snapshot_get<uint8_t>(get, offsetof(state_t, lcd.fifo.sprites) + i) < 40;
+    }
+    uint8_t num_sprites = SNAPSHOT_GET(get, lcd.fifo.num_sprites);
+    uint8_t next_sprite = SNAPSHOT_GET(get, lcd.fifo.next_sprite);
+    if (bg_head >= 16 || !sprites_valid || num_sprites > 10 || next_sprite > num_sprites ||
+        (stall && next_sprite == num_sprites)) {
+        return false;
+    }
+
+    for (int i = 0; i < APU_CHANNELS; i++) {
+        uint8_t pos = snapshot_get<uint8_t>(get, offsetof(state_t, apu.ch) + i * sizeof(apu_channel_t) +
+                                                     offsetof(apu_channel_t, pos));
+        if (pos > (i == 2 ? 31 : 7)) {
+            return false;
+        }
+    }
+
+    uint64_t at[ev::COUNT];
+    for (int i = 0; i < ev::COUNT; i++) {
+        at[i] = snapshot_get<uint64_t>(get, offsetof(state_t, sched.at) + i * sizeof(uint64_t));
+    }
+    uint64_t cycles = SNAPSHOT_GET(get, cycles);
+    uint8_t clock_shift = SNAPSHOT_GET(get, clock_shift);
+    uint32_t cpu_stall = SNAPSHOT_GET(get, cpu_stall);
+    if (cycles > SNAPSHOT_MAX_CYCLES || clock_shift > 1 || cpu_stall > SNAPSHOT_MAX_LAG ||
+        line_start > cycles + SNAPSHOT_MAX_LAG || line_start + SNAPSHOT_MAX_LAG < cycles) {
+        return false;
+    }
+    for (int i = 0; i < ev::COUNT; i++) {
+        if (at[i] != SCHED_NEVER && at[i] + SNAPSHOT_MAX_LAG < cycles) {
+            return false;
+        }
+    }
+
+    uint8_t timer_bit = SNAPSHOT_GET(get, timer_bit);
+    uint8_t dma_copied = SNAPSHOT_GET(get, dma_copied);
+    uint16_t dma_src = SNAPSHOT_GET(get, dma_src);
+    if ((timer_bit != 3 && timer_bit != 5 && timer_bit != 7 && timer_bit != 9) || dma_copied > 160 ||
+        (dma_src & 0xff) || dma_src >= 0xe000) {
+        return false;
+    }
+
+    uint8_t vram_bank = SNAPSHOT_GET(get, cgb.vram_bank);
+    uint8_t wram_bank = SNAPSHOT_GET(get, cgb.wram_bank);
+    uint8_t hdma_active = snapshot_get<uint8_t>(get, offsetof(state_t, cgb.hdma_active));
+    uint16_t hdma_src = SNAPSHOT_GET(get, cgb.hdma_src);
+    uint16_t hdma_dst = SNAPSHOT_GET(get, cgb.hdma_dst);
+    uint8_t hdma_left = SNAPSHOT_GET(get, cgb.hdma_left);
+    return vram_bank <= 1 && wram_bank <= 7 && hdma_left <= 0x80 &&
+           (!hdma_active || (!(hdma_src & 0xf) && (hdma_dst & 0xe00f) == 0x8000));
+}
+
+// get() over a plain image of state_t, of any alignment.
+struct snapshot_image_t {
+    const uint8_t *p;
+
+    GB_DEVICE void operator()(size_t offset, void *dst, size_t size) const {
+        memcpy(dst, p + offset, size);
+    }
+};
+
+// Checks the header and the machine; `rom_id` 0 skips the cartridge check.
+static GB_DEVICE int snapshot_check(const void *buf, size_t size, uint32_t rom_id = 0) {
+    snapshot_header_t h;
+    if (size < sizeof(h)) {
+        return snap::SIZE;
+    }
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != SNAPSHOT_MAGIC || h.version != SNAPSHOT_VERSION || h.header_size != sizeof(h) ||
+        h.state_size != sizeof(state_t) || h.mem_size != SNAPSHOT_MEM) {
+        return snap::VERSION;
+    }
+    if (size < snapshot_size()) {
+        return snap::SIZE;
+    }
+    snapshot_image_t image = {(const uint8_t *)buf + sizeof(h)};
+    if (!snapshot_state_valid(image)) {
+        return snap::VERSION;
+    }
+    if (rom_id && h.rom_id != rom_id) {
+        return snap::ROM;
+    }
+    return snap::OK;
+}
+
+static GB_DEVICE void snapshot_clear(uint8_t *state, size_t offset, size_t size) {
+    memset(state + offset, 0, size);
+}
+
+#define SNAPSHOT_CLEAR(state, field) snapshot_clear(state, offsetof(state_t, field), sizeof(((state_t *)0)->field))
+
+// Zeroes the host's fields in a copy of state_t.
+static GB_DEVICE void snapshot_clear_host(uint8_t *state) {
+    SNAPSHOT_CLEAR(state, mem);
+    SNAPSHOT_CLEAR(state, page);
+    SNAPSHOT_CLEAR(state, joy_queue);
+    SNAPSHOT_CLEAR(state, serial);
+    SNAPSHOT_CLEAR(state, bus_hook);
+    SNAPSHOT_CLEAR(state, bus_ctx);
+    SNAPSHOT_CLEAR(state, apu.ring);
+    SNAPSHOT_CLEAR(state, lcd.pipeline);
+    SNAPSHOT_CLEAR(state, lcd.outputs);
+    SNAPSHOT_CLEAR(state, lcd.num_outputs);
+    SNAPSHOT_CLEAR(state, lcd.skip);
+}
+
+// The host's fields, kept across a load.
+struct snapshot_host_t {
+    uint8_t *mem;
+    joy_queue_t *joy_queue;
+    serial_device_t *serial;
+    void (*bus_hook)(state_t &s);
+    void *bus_ctx;
+    apu_ring_t *ring;
+    uint32_t rate;
+    lcd_pipeline_t *pipeline;
+    lcd_output_t outputs[LCD_MAX_OUTPUTS];
+    uint8_t num_outputs;
+    bool skip;
+};
+
+static GB_DEVICE void snapshot_host_save(const state_t &s, snapshot_host_t &h) {
+    h.mem = s.mem;
+    h.joy_queue = s.joy_queue;
+    h.serial = s.serial;
+    h.bus_hook = s.bus_hook;
+    h.bus_ctx = s.bus_ctx;
+    h.ring = s.apu.ring;
+    h.rate = s.apu.rate;
+    h.pipeline = s.lcd.pipeline;
+    memcpy(h.outputs, s.lcd.outputs, sizeof(h.outputs));
+    h.num_outputs = s.lcd.num_outputs;
+    h.skip = s.lcd.skip;
+}
+
+// Puts the host's fields back over a loaded state_t and rebuilds what
+// depends on them.
+static GB_DEVICE void snapshot_host_restore(state_t &s, const snapshot_host_t &h) {
+    s.mem = h.mem;
+    s.joy_queue = h.joy_queue;
+    s.serial = h.serial;
+    s.bus_hook = h.bus_hook;
+    s.bus_ctx = h.bus_ctx;
+    s.apu.ring = nullptr;
+    s.lcd.pipeline = h.pipeline;
+    memcpy(s.lcd.outputs, h.outputs, sizeof(h.outputs));
+    s.lcd.num_outputs = h.num_outputs;
+    s.lcd.skip = h.skip;
+    mem_map_update(s);
+
+    // fields that follow from others, and an input poll that only makes
+    // sense with a queue to poll
+    if (!s.joy_queue) {
+        s.sched.at[ev::JOYPAD] = SCHED_NEVER;
+    }
+    else if (s.sched.at[ev::JOYPAD] == SCHED_NEVER) {
+        s.sched.at[ev::JOYPAD] = s.cycles;
+    }
+    sched_update(s.sched);
+    interrupt_update(s);
+
+#if !GB_FREESTANDING
+    // the saved synthesis position belongs to another stream; restart ours
+    if (h.ring) {
+        apu_output_attach(s, h.ring, h.rate);
+    }
+#endif
+}
+
+// `buf` needs snapshot_size() bytes and any alignment.
+static GB_DEVICE int snapshot_save(const state_t &s, void *buf, size_t size) {
+    if (size < snapshot_size()) {
+        return snap::SIZE;
+    }
+
+    snapshot_header_t h = {};
+    h.magic = SNAPSHOT_MAGIC;
+    h.version = SNAPSHOT_VERSION;
+    h.header_size = sizeof(h);
+    h.state_size = sizeof(state_t);
+    h.mem_size = SNAPSHOT_MEM;
+    h.rom_id = snapshot_rom_id(s.mem);
+
+    uint8_t *out = (uint8_t *)buf;
+    memcpy(out, &h, sizeof(h));
+    out += sizeof(h);
+    memcpy(out, &s, sizeof(state_t));
+    snapshot_clear_host(out);
+    memcpy(out + sizeof(state_t), s.mem, SNAPSHOT_MEM);
+    return snap::OK;
+}
+
+// Restores a snapshot into a machine set up for the same cartridge. On
+// failure the machine is left untouched.
+static GB_DEVICE int snapshot_load(state_t &s, const void *buf, size_t size) {
+    int rc = snapshot_check(buf, size, snapshot_rom_id(s.mem));
+    if (rc != snap::OK) {
+        return rc;
+    }
+
+    snapshot_host_t host;
+    snapshot_host_save(s, host);
+    const uint8_t *in = (const uint8_t *)buf + sizeof(snapshot_header_t);
+    memcpy(&s, in, sizeof(state_t));
+    memcpy(host.mem, in + sizeof(state_t), SNAPSHOT_MEM);
+    snapshot_host_restore(s, host);
+    return snap::OK;
+}
@@ -5,12 +5,12 @@
 #define STACK_START 0xfffe
 
 
-static void push_reg16(state_t &s, _reg16_t r) {
+static GB_DEVICE void push_reg16(state_t &s, _reg16_t r) {
     s.regs.sp -= 2;
     write_u16(s, s.regs.sp, r);
 }
 
-static void pop_reg16(state_t &s, _reg16_t &r) {
+static GB_DEVICE void pop_reg16(state_t &s, _reg16_t &r) {
     r = read_u16(s, s.regs.sp);
     s.regs.sp += 2;
 }
\ No newline at end of file
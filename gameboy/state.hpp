@@ -5,6 +5,12 @@
 
 #include "config.hpp"
 #include "lcd_state.hpp"
+#include "apu_state.hpp"
+#include "cgb_state.hpp"
+#include "sched.hpp"
+
+struct joy_queue_t;
+struct serial_device_t;
 
 typedef uint8_t _inst_t;
 typedef uint8_t _op8_t;
@@ -25,6 +31,29 @@ enum
     
     IF   = 0xff0f,   // Interrupt Flag (R/W)
 
+    NR10 = 0xff10,   // Channel 1 Sweep (R/W)
+    NR11 = 0xff11,   // Channel 1 Length/Duty (R/W)
+    NR12 = 0xff12,   // Channel 1 Envelope (R/W)
+    NR13 = 0xff13,   // Channel 1 Frequency lo (W)
+    NR14 = 0xff14,   // Channel 1 Frequency hi/Trigger (R/W)
+    NR21 = 0xff16,   // Channel 2 Length/Duty (R/W)
+    NR22 = 0xff17,   // Channel 2 Envelope (R/W)
+    NR23 = 0xff18,   // Channel 2 Frequency lo (W)
+    NR24 = 0xff19,   // Channel 2 Frequency hi/Trigger (R/W)
+    NR30 = 0xff1a,   // Channel 3 DAC Enable (R/W)
+    NR31 = 0xff1b,   // Channel 3 Length (W)
+    NR32 = 0xff1c,   // Channel 3 Output Level (R/W)
+    NR33 = 0xff1d,   // Channel 3 Frequency lo (W)
+    NR34 = 0xff1e,   // Channel 3 Frequency hi/Trigger (R/W)
+    NR41 = 0xff20,   // Channel 4 Length (W)
+    NR42 = 0xff21,   // Channel 4 Envelope (R/W)
+    NR43 = 0xff22,   // Channel 4 Polynomial Counter (R/W)
+    NR44 = 0xff23,   // Channel 4 Trigger (R/W)
+    NR50 = 0xff24,   // Master Volume (R/W)
+    NR51 = 0xff25,   // Panning (R/W)
+    NR52 = 0xff26,   // Sound On/Off (R/W)
+    WAVE = 0xff30,   // Wave Pattern RAM, 16 bytes (R/W)
+
     LCDC = 0xff40,   // LCD Control (R/W)
     STAT = 0xff41,   // LCD Status (R/W)
     SCY  = 0xff42,   // Scroll Y (R/W)
@@ -40,6 +69,19 @@ enum
     WY   = 0xff4A,   // Window Y Position (R/W)
     WX   = 0xff4B,   // Window X Position (R/W)
 
+    KEY1 = 0xff4d,   // CGB Prepare Speed Switch (R/W)
+    VBK  = 0xff4f,   // CGB VRAM Bank (R/W)
+    HDMA1 = 0xff51,  // CGB HDMA Source hi (W)
+    HDMA2 = 0xff52,  // CGB HDMA Source lo (W)
+    HDMA3 = 0xff53,  // CGB HDMA Destination hi (W)
+    HDMA4 = 0xff54,  // CGB HDMA Destination lo (W)
+    HDMA5 = 0xff55,  // CGB HDMA Length/Mode/Start (R/W)
+    BCPS = 0xff68,   // CGB BG Palette Index (R/W)
+    BCPD = 0xff69,   // CGB BG Palette Data (R/W)
+    OCPS = 0xff6a,   // CGB OBJ Palette Index (R/W)
+    OCPD = 0xff6b,   // CGB OBJ Palette Data (R/W)
+    SVBK = 0xff70,   // CGB WRAM Bank (R/W)
+
     IE   = 0xffff,   // Interrupt Enable (R/W)
 };
 
@@ -104,23 +146,57 @@ struct state_t {
 
     bool halt;
     bool stop;
+    bool fault;             // stopped on an opcode the core doesn't implement
+    uint8_t fault_opcode;
+    uint16_t fault_pc;
 
     bool interrupts_enabled;
+    uint8_t int_flag;       // IF
+    uint8_t int_enable;     // IE
+    uint8_t int_pending;    // IF & IE & 0x1f
     lcd_t lcd;
-
-    unsigned cycles;
-    int inst_cycles_wait;
+    apu_t apu;
+    sched_t sched;
+
+    // Time is counted in CPU clocks. In CGB double speed those run twice as
+    // fast, so PPU and APU delays are shifted left by clock_shift.
+    uint64_t cycles;
+    uint8_t clock_shift;
+    uint32_t cpu_stall;     // extra clocks the CPU is held for (HDMA, speed switch)
+    int inst_cycles_wait;   // length of the last step in T-cycles
     bool prefixed;
+    bool branch_taken;
 
-    _reg16_t divider_counter;
-    _reg16_t timer_counter;
-    _reg16_t timer_tac;
+    uint64_t div_base;      // cycle the divider was last reset
+    uint64_t tima_cycle;    // cycle `tima` is up to date for
+    uint8_t tima;
+    uint8_t timer_bit;
     bool timer_enable;
+    bool tima_reload;
+
+    bool dma_active;
+    uint8_t dma_copied;     // OAM bytes already written
+    uint16_t dma_src;
+    uint64_t dma_start;     // cycle the first byte is due
+
+    uint8_t joy_buttons;    // joy:: bits currently held
+    uint8_t joy_select;     // P1 bits 4-5 as last written
+    joy_queue_t *joy_queue; // see joypad.hpp
+
+    serial_device_t *serial;    // other end of the link, see serial.hpp
+
+    // Called before every CPU memory access when set; lets an M-cycle core
+    // bring the other components up to the cycle of the access.
+    void (*bus_hook)(state_t &s);
+    void *bus_ctx;
+
+    cgb_t cgb;
 
     unsigned rom_size;
     uint8_t *mem;
+    uint8_t *page[16];      // CPU view of each 4KB page, see mem_map_update()
 
     bool breakp;
-    unsigned num_inst;
+    uint64_t num_inst;      // instructions executed
 };
 
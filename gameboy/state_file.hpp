@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "rle.hpp"
+#include "snapshot.hpp"
+
+// Save-state files, for states kept on disk. A header with a fixed table of
+// sections, each the image of one part of the machine at an offset aligned
+// to STATE_FILE_ALIGN: a mapped file restores with one copy per section and
+// no parsing. Sections may be zero-run coded instead (STATE_FILE_RLE),
+// which mostly pays off for the machine itself and for banks a game
+// doesn't use.
+//
+// The ROM area of the address space is the cartridge's and isn't stored;
+// the cartridge has no mapper state to store either. Loading checks the
+// cartridge like snapshot_load() does and leaves the host's fields alone.
+//
+// A pack is many state files in one, each aligned the same way, with an
+// index of (offset, size) at the end.
+
+#define STATE_FILE_MAGIC    0x46425543  // "CUBF"
+#define STATE_FILE_VERSION  1
+#define STATE_FILE_ALIGN    64
+#define STATE_FILE_SECTIONS 6
+
+#define STATE_PACK_MAGIC    0x50425543  // "CUBP"
+#define STATE_PACK_VERSION  1
+
+// Sections, in file order.
+namespace section
+{
+const int MACHINE  = 0;     // state_t: CPU, timers, PPU, APU, CGB registers and banks
+const int VRAM     = 1;
+const int CART_RAM = 2;
+const int WRAM     = 3;     // with the echo area
+const int OAM      = 4;
+const int IO       = 5;     // registers, HRAM and IE
+}
+
+// Section and state_file_write() flag.
+#define STATE_FILE_RLE 1
+
+struct state_file_section_t {
+    uint32_t offset;        // from the start of the file
+    uint32_t size;          // bytes in the file
+    uint32_t raw_size;      // bytes restored
+    uint32_t flags;
+};
+
+struct state_file_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t state_size;    // sizeof(state_t) of the writer
+    uint32_t rom_id;        // see snapshot_rom_id()
+    uint32_t file_size;
+    uint32_t num_sections;
+    uint32_t reserved[2];
+    state_file_section_t sections[STATE_FILE_SECTIONS];
+};
+
+struct state_pack_header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t reserved;
+    uint32_t count;
+    uint64_t index_offset;  // count state_pack_entry_t
+};
+
+struct state_pack_entry_t {
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Address and size of the memory sections.
+static GB_TABLE const uint16_t state_file_mem[STATE_FILE_SECTIONS][2] = {
+    {0, 0}, {0x8000, 0x2000}, {0xa000, 0x2000}, {0xc000, 0x3e00}, {0xfe00, 0x100}, {0xff00, 0x100},
+};
+
+static GB_DEVICE constexpr size_t state_file_align(size_t n) {
+    return (n + STATE_FILE_ALIGN - 1) & ~(size_t)(STATE_FILE_ALIGN - 1);
+}
+
+static GB_DEVICE size_t state_file_raw_size(int id) {
+    return id == section::MACHINE ? sizeof(state_t) : state_file_mem[id][1];
+}
+
+// Buffer size state_file_write() needs. Without STATE_FILE_RLE the file
+// takes this much less RLE_SLACK per section, always in the same layout.
+static GB_DEVICE size_t state_file_max_size() {
+    size_t n = state_file_align(sizeof(state_file_header_t));
+    for (int id = 0; id < STATE_FILE_SECTIONS; id++) {
+        n += state_file_align(state_file_raw_size(id) + RLE_SLACK);
+    }
+    return n;
+}
+
+// Raw image of section `id` of the machine.
+static GB_DEVICE void state_file_copy(const state_t &s, int id, uint8_t *dst) {
+    if (id == section::MACHINE) {
+        memcpy(dst, &s, sizeof(state_t));
+        snapshot_clear_host(dst);
+    }
+    else {
+        memcpy(dst, s.mem + state_file_mem[id][0], state_file_mem[id][1]);
+    }
+}
+
+// Writes the machine into `buf`, state_file_max_size() bytes. Returns the
+// bytes used, or snap::SIZE.
+static GB_DEVICE int state_file_write(const state_t &s, void *buf, size_t size, int flags) {
+    if (size < state_file_max_size()) {
+        return snap::SIZE;
+    }
+
+    uint8_t *out = (uint8_t *)buf;
+    state_file_header_t h = {};
+    h.magic = STATE_FILE_MAGIC;
+    h.version = STATE_FILE_VERSION;
+    h.header_size = sizeof(h);
+    h.state_size = sizeof(state_t);
+    h.rom_id = snapshot_rom_id(s.mem);
+    h.num_sections = STATE_FILE_SECTIONS;
+
+    size_t pos = state_file_align(sizeof(h));
+    for (int id = 0; id < STATE_FILE_SECTIONS; id++) {
+        state_file_section_t &sec = h.sections[id];
+        uint32_t raw = state_file_raw_size(id);
+        uint8_t *dst = out + pos;
+
+        sec.offset = (uint32_t)pos;
+        sec.raw_size = raw;
+        sec.size = raw;
+        if (flags & STATE_FILE_RLE) {
+            // the raw image goes RLE_SLACK bytes in, where coding it in
+            // place never catches up with it
+            state_file_copy(s, id, dst + RLE_SLACK);
+            size_t coded = rle_encode(dst + RLE_SLACK, nullptr, raw, dst);
+            if (coded < raw) {
+                sec.size = (uint32_t)coded;
+                sec.flags = STATE_FILE_RLE;
+            }
+        }
+        // coding that didn't pay off has overwritten the image
+        if (!(sec.flags & STATE_FILE_RLE)) {
+            state_file_copy(s, id, dst);
+        }
+        size_t end = state_file_align(pos + sec.size);
+        memset(out + pos + sec.size, 0, end - pos - sec.size);
+        pos = end;
+    }
+    h.file_size = (uint32_t)pos;
+    memset(out, 0, h.sections[0].offset);
+    memcpy(out, &h, sizeof(h));
+    return (int)pos;
+}
+
+// get() over a compressed machine section, for snapshot_state_valid().
+struct state_file_rle_get_t {
+    rle_reader_t r;
+
+    GB_DEVICE void operator()(size_t offset, void *dst, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            ((uint8_t *)dst)[i] = rle_read_u8(r, offset + i);
+        }
+    }
+};
+
+// Checks a file against its header and the machine it is for; rom_id 0
+// skips the cartridge check. Compressed sections are walked to the end and
+// the machine is checked like snapshot_check() does.
+static GB_DEVICE int state_file_check(const void *buf, size_t size, uint32_t rom_id = 0) {
+    state_file_header_t h;
+    if (size < sizeof(h)) {
+        return snap::SIZE;
+    }
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != STATE_FILE_MAGIC || h.version != STATE_FILE_VERSION || h.header_size != sizeof(h) ||
+        h.state_size != sizeof(state_t) || h.num_sections != STATE_FILE_SECTIONS) {
+        return snap::VERSION;
+    }
+    if (size < h.file_size) {
+        return snap::SIZE;
+    }
+    for (int id = 0; id < STATE_FILE_SECTIONS; id++) {
+        const state_file_section_t &sec = h.sections[id];
+        if (sec.raw_size != state_file_raw_size(id) || sec.offset > h.file_size || sec.size > h.file_size - sec.offset) {
+            return snap::VERSION;
+        }
+        if (sec.flags & STATE_FILE_RLE ? !rle_valid((const uint8_t *)buf + sec.offset, sec.size, sec.raw_size)
+                                       : sec.size != sec.raw_size) {
+            return snap::VERSION;
+        }
+    }
+
+    const state_file_section_t &m = h.sections[section::MACHINE];
+    const uint8_t *in = (const uint8_t *)buf + m.offset;
+    bool valid;
+    if (m.flags & STATE_FILE_RLE) {
+        state_file_rle_get_t get;
+        rle_reader_init(get.r, in, m.size);
+        valid = snapshot_state_valid(get);
+    }
+    else {
+        snapshot_image_t get = {in};
+        valid = snapshot_state_valid(get);
+    }
+    if (!valid) {
+        return snap::VERSION;
+    }
+    if (rom_id && h.rom_id != rom_id) {
+        return snap::ROM;
+    }
+    return snap::OK;
+}
+
+// Restores a file into a machine set up for the same cartridge. On failure
+// the machine is left untouched.
+static GB_DEVICE int state_file_load(state_t &s, const void *buf, size_t size) {
+    int rc = state_file_check(buf, size, snapshot_rom_id(s.mem));
+    if (rc != snap::OK) {
+        return rc;
+    }
+
+    state_file_header_t h;
+    memcpy(&h, buf, sizeof(h));
+    snapshot_host_t host;
+    snapshot_host_save(s, host);
+    for (int id = 0; id < STATE_FILE_SECTIONS; id++) {
+        const state_file_section_t &sec = h.sections[id];
+        const uint8_t *in = (const uint8_t *)buf + sec.offset;
+        uint8_t *dst = id == section::MACHINE ? (uint8_t *)&s : host.mem + state_file_mem[id][0];
+        if (sec.flags & STATE_FILE_RLE) {
+            memset(dst, 0, sec.raw_size);
+            rle_apply(dst, in, sec.size);
+        }
+        else {
+            memcpy(dst, in, sec.raw_size);
+        }
+    }
+    snapshot_host_restore(s, host);
+    return snap::OK;
+}
+
+// Number of states in a pack, or a snap:: error.
+static GB_DEVICE int64_t state_pack_check(const void *buf, size_t size) {
+    state_pack_header_t h;
+    if (size < sizeof(h)) {
+        return snap::SIZE;
+    }
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != STATE_PACK_MAGIC || h.version != STATE_PACK_VERSION || h.header_size != sizeof(h)) {
+        return snap::VERSION;
+    }
+    if (h.index_offset > size || (size - h.index_offset) / sizeof(state_pack_entry_t) < h.count) {
+        return snap::SIZE;
+    }
+    return h.count;
+}
+
+// State i of a checked pack, or null if its entry points outside the pack.
+static GB_DEVICE const void *state_pack_get(const void *buf, size_t size, uint32_t i, size_t *state_size) {
+    state_pack_header_t h;
+    state_pack_entry_t e;
+    memcpy(&h, buf, sizeof(h));
+    memcpy(&e, (const uint8_t *)buf + h.index_offset + i * sizeof(e), sizeof(e));
+    if (e.offset > size || e.size > size - e.offset) {
+        return nullptr;
+    }
+    *state_size = e.size;
+    return (const uint8_t *)buf + e.offset;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+
+#include "state.hpp"
+#include "interrupts.hpp"
+
+// DIV and TIMA are derived from s.cycles instead of being ticked. DIV is the
+// upper byte of the 16-bit divider (s.cycles - s.div_base). TIMA counts
+// falling edges of one divider bit, so it is only brought up to date when
+// something reads or writes the timer; the overflow is the only scheduled
+// event.
+
+// divider bit clocking TIMA for TAC & 3 (4096, 262144, 65536, 16384 Hz)
+static GB_TABLE const uint8_t timer_bits[4] = {9, 3, 5, 7};
+
+static GB_DEVICE uint16_t timer_divider(state_t &s) {
+    return (uint16_t)(s.cycles - s.div_base);
+}
+
+// Falling edges of the timer bit between two points in time.
+static GB_DEVICE uint64_t timer_edges(state_t &s, uint64_t from, uint64_t to) {
+    uint8_t shift = s.timer_bit + 1;
+    return ((to - s.div_base) >> shift) - ((from - s.div_base) >> shift);
+}
+
+static GB_DEVICE void timer_sync(state_t &s) {
+    if (s.timer_enable && !s.tima_reload) {
+        s.tima += (uint8_t)timer_edges(s, s.tima_cycle, s.cycles);
+    }
+    s.tima_cycle = s.cycles;
+}
+
+// Arms the overflow event for the edge that takes TIMA from 0xff to 0x00.
+static GB_DEVICE void timer_schedule(state_t &s) {
+    if (s.tima_reload) {
+        return;
+    }
+    if (!s.timer_enable) {
+        sched_cancel(s.sched, ev::TIMER);
+        return;
+    }
+
+    uint8_t shift = s.timer_bit + 1;
+    uint64_t edge = ((s.tima_cycle - s.div_base) >> shift) + (256 - s.tima);
+    sched_set(s.sched, ev::TIMER, s.div_base + (edge << shift));
+}
+
+// TIMA reads 0x00 for four cycles after overflowing, then TMA is loaded and
+// the interrupt is requested.
+static GB_DEVICE void timer_overflow(state_t &s, uint64_t at) {
+    s.tima = 0;
+    s.tima_cycle = at;
+    s.tima_reload = true;
+    sched_set(s.sched, ev::TIMER, at + 4);
+}
+
+static GB_DEVICE void timer_event(state_t &s, uint64_t at) {
+    if (s.tima_reload) {
+        s.tima_reload = false;
+        s.tima = s.mem[TMA];
+        s.tima_cycle = at;
+        interrupt_trigger(s, Int::TIMER);
+        timer_schedule(s);
+        return;
+    }
+    timer_overflow(s, at);
+}
+
+// A write that drops the timer input from 1 to 0 clocks TIMA once.
+static GB_DEVICE void timer_glitch_tick(state_t &s) {
+    if (s.tima_reload) {
+        return;
+    }
+    s.tima += 1;
+    if (s.tima == 0) {
+        timer_overflow(s, s.cycles);
+    }
+}
+
+static GB_DEVICE bool timer_input(state_t &s) {
+    return s.timer_enable && ((timer_divider(s) >> s.timer_bit) & 1);
+}
+
+static GB_DEVICE uint8_t timer_div_read(state_t &s) {
+    return timer_divider(s) >> 8;
+}
+
+static GB_DEVICE uint8_t timer_tima_read(state_t &s) {
+    timer_sync(s);
+    return s.tima;
+}
+
+static GB_DEVICE void timer_div_write(state_t &s) {
+    timer_sync(s);
+    bool was_high = timer_input(s);
+
+    s.div_base = s.cycles;
+    if (was_high) {
+        timer_glitch_tick(s);
+    }
+    timer_schedule(s);
+}
+
+static GB_DEVICE void timer_tima_write(state_t &s, uint8_t n) {
+    timer_sync(s);
+
+    // writing during the reload window cancels the reload and the interrupt
+    s.tima_reload = false;
+    s.tima = n;
+    timer_schedule(s);
+}
+
+static GB_DEVICE void timer_tac_write(state_t &s, uint8_t n) {
+    timer_sync(s);
+    bool was_high = timer_input(s);
+
+    s.timer_bit = timer_bits[n & 3];
+    s.timer_enable = (n >> 2) & 1;
+    if (was_high && !timer_input(s)) {
+        timer_glitch_tick(s);
+    }
+    timer_schedule(s);
+}
+
+static GB_DEVICE void timer_init(state_t &s) {
+    s.div_base = s.cycles;
+    s.tima = 0;
+    s.tima_cycle = s.cycles;
+    s.tima_reload = false;
+    s.timer_bit = timer_bits[0];
+    s.timer_enable = false;
+}
@@ -0,0 +1,537 @@
+#pragma once
+
+#include <cstdint>
+#include "config.hpp"
+
+// Generated by tools/gentimings.py from tools/ops.json, do not edit.
+//
+// Per-opcode T-cycle cost with and without the branch taken, and which
+// M-cycles touch memory: bit n of a mask is M-cycle n of the instruction,
+// M-cycle 0 being the opcode fetch. CB entries include the 0xCB fetch.
+
+struct inst_timing_t {
+    uint8_t cycles;
+    uint8_t cycles_branch;
+    uint8_t reads;
+    uint8_t writes;
+    uint8_t reads_branch;
+    uint8_t writes_branch;
+};
+
+static GB_TABLE const inst_timing_t inst_timings[256] = {
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x00 NOP
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0x01 LD BC,u16
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x02 LD (BC),A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x03 INC BC
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x04 INC B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x05 DEC B
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x06 LD B,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x07 RLCA
+    {20, 20, 0x06, 0x18, 0x06, 0x18}, // 0x08 LD (u16),SP
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x09 ADD HL,BC
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x0a LD A,(BC)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x0b DEC BC
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x0c INC C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x0d DEC C
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x0e LD C,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x0f RRCA
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x10 STOP
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0x11 LD DE,u16
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x12 LD (DE),A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x13 INC DE
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x14 INC D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x15 DEC D
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x16 LD D,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x17 RLA
+    {12, 12, 0x00, 0x00, 0x02, 0x00}, // 0x18 JR i8
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x19 ADD HL,DE
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x1a LD A,(DE)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x1b DEC DE
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x1c INC E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x1d DEC E
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x1e LD E,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x1f RRA
+    { 8, 12, 0x02, 0x00, 0x02, 0x00}, // 0x20 JR NZ,i8
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0x21 LD HL,u16
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x22 LD (HL+),A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x23 INC HL
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x24 INC H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x25 DEC H
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x26 LD H,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x27 DAA
+    { 8, 12, 0x02, 0x00, 0x02, 0x00}, // 0x28 JR Z,i8
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x29 ADD HL,HL
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x2a LD A,(HL+)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x2b DEC HL
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x2c INC L
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x2d DEC L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x2e LD L,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x2f CPL
+    { 8, 12, 0x02, 0x00, 0x02, 0x00}, // 0x30 JR NC,i8
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0x31 LD SP,u16
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x32 LD (HL-),A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x33 INC SP
+    {12, 12, 0x02, 0x04, 0x02, 0x04}, // 0x34 INC (HL)
+    {12, 12, 0x02, 0x04, 0x02, 0x04}, // 0x35 DEC (HL)
+    {12, 12, 0x02, 0x04, 0x02, 0x04}, // 0x36 LD (HL),u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x37 SCF
+    { 8, 12, 0x02, 0x00, 0x02, 0x00}, // 0x38 JR C,i8
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x39 ADD HL,SP
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x3a LD A,(HL-)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x3b DEC SP
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x3c INC A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x3d DEC A
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x3e LD A,u8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x3f CCF
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x40 LD B,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x41 LD B,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x42 LD B,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x43 LD B,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x44 LD B,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x45 LD B,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x46 LD B,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x47 LD B,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x48 LD C,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x49 LD C,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x4a LD C,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x4b LD C,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x4c LD C,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x4d LD C,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x4e LD C,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x4f LD C,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x50 LD D,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x51 LD D,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x52 LD D,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x53 LD D,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x54 LD D,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x55 LD D,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x56 LD D,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x57 LD D,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x58 LD E,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x59 LD E,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x5a LD E,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x5b LD E,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x5c LD E,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x5d LD E,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x5e LD E,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x5f LD E,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x60 LD H,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x61 LD H,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x62 LD H,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x63 LD H,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x64 LD H,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x65 LD H,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x66 LD H,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x67 LD H,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x68 LD L,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x69 LD L,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x6a LD L,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x6b LD L,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x6c LD L,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x6d LD L,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x6e LD L,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x6f LD L,A
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x70 LD (HL),B
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x71 LD (HL),C
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x72 LD (HL),D
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x73 LD (HL),E
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x74 LD (HL),H
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x75 LD (HL),L
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x76 HALT
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0x77 LD (HL),A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x78 LD A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x79 LD A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x7a LD A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x7b LD A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x7c LD A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x7d LD A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x7e LD A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x7f LD A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x80 ADD A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x81 ADD A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x82 ADD A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x83 ADD A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x84 ADD A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x85 ADD A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x86 ADD A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x87 ADD A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x88 ADC A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x89 ADC A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x8a ADC A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x8b ADC A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x8c ADC A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x8d ADC A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x8e ADC A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x8f ADC A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x90 SUB A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x91 SUB A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x92 SUB A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x93 SUB A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x94 SUB A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x95 SUB A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x96 SUB A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x97 SUB A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x98 SBC A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x99 SBC A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x9a SBC A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x9b SBC A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x9c SBC A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x9d SBC A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0x9e SBC A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0x9f SBC A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa0 AND A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa1 AND A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa2 AND A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa3 AND A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa4 AND A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa5 AND A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xa6 AND A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa7 AND A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa8 XOR A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xa9 XOR A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xaa XOR A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xab XOR A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xac XOR A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xad XOR A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xae XOR A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xaf XOR A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb0 OR A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb1 OR A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb2 OR A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb3 OR A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb4 OR A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb5 OR A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xb6 OR A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb7 OR A,A
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb8 CP A,B
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xb9 CP A,C
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xba CP A,D
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xbb CP A,E
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xbc CP A,H
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xbd CP A,L
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xbe CP A,(HL)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xbf CP A,A
+    { 8, 20, 0x00, 0x00, 0x0c, 0x00}, // 0xc0 RET NZ
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0xc1 POP BC
+    {12, 16, 0x06, 0x00, 0x06, 0x00}, // 0xc2 JP NZ,u16
+    {16, 16, 0x00, 0x00, 0x06, 0x00}, // 0xc3 JP u16
+    {12, 24, 0x06, 0x00, 0x06, 0x30}, // 0xc4 CALL NZ,u16
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xc5 PUSH BC
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xc6 ADD A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xc7 RST 00h
+    { 8, 20, 0x00, 0x00, 0x0c, 0x00}, // 0xc8 RET Z
+    {16, 16, 0x00, 0x00, 0x06, 0x00}, // 0xc9 RET
+    {12, 16, 0x06, 0x00, 0x06, 0x00}, // 0xca JP Z,u16
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xcb PREFIX CB
+    {12, 24, 0x06, 0x00, 0x06, 0x30}, // 0xcc CALL Z,u16
+    {24, 24, 0x00, 0x00, 0x06, 0x30}, // 0xcd CALL u16
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xce ADC A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xcf RST 08h
+    { 8, 20, 0x00, 0x00, 0x0c, 0x00}, // 0xd0 RET NC
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0xd1 POP DE
+    {12, 16, 0x06, 0x00, 0x06, 0x00}, // 0xd2 JP NC,u16
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xd3 UNUSED
+    {12, 24, 0x06, 0x00, 0x06, 0x30}, // 0xd4 CALL NC,u16
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xd5 PUSH DE
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xd6 SUB A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xd7 RST 10h
+    { 8, 20, 0x00, 0x00, 0x0c, 0x00}, // 0xd8 RET C
+    {16, 16, 0x00, 0x00, 0x06, 0x00}, // 0xd9 RETI
+    {12, 16, 0x06, 0x00, 0x06, 0x00}, // 0xda JP C,u16
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xdb UNUSED
+    {12, 24, 0x06, 0x00, 0x06, 0x30}, // 0xdc CALL C,u16
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xdd UNUSED
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xde SBC A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xdf RST 18h
+    {12, 12, 0x02, 0x04, 0x02, 0x04}, // 0xe0 LD (FF00+u8),A
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0xe1 POP HL
+    { 8,  8, 0x00, 0x02, 0x00, 0x02}, // 0xe2 LD (FF00+C),A
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xe3 UNUSED
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xe4 UNUSED
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xe5 PUSH HL
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xe6 AND A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xe7 RST 20h
+    {16, 16, 0x02, 0x08, 0x02, 0x08}, // 0xe8 ADD SP,i8
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xe9 JP HL
+    {16, 16, 0x06, 0x08, 0x06, 0x08}, // 0xea LD (u16),A
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xeb UNUSED
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xec UNUSED
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xed UNUSED
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xee XOR A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xef RST 28h
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0xf0 LD A,(FF00+u8)
+    {12, 12, 0x06, 0x00, 0x06, 0x00}, // 0xf1 POP AF
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xf2 LD A,(FF00+C)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xf3 DI
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xf4 UNUSED
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xf5 PUSH AF
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xf6 OR A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xf7 RST 30h
+    {12, 12, 0x02, 0x00, 0x02, 0x00}, // 0xf8 LD HL,SP+i8
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf9 LD SP,HL
+    {16, 16, 0x0e, 0x00, 0x0e, 0x00}, // 0xfa LD A,(u16)
+    { 4,  4, 0x00, 0x00, 0x00, 0x00}, // 0xfb EI
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xfc UNUSED
+    { 0,  0, 0x00, 0x00, 0x00, 0x00}, // 0xfd UNUSED
+    { 8,  8, 0x02, 0x00, 0x02, 0x00}, // 0xfe CP A,u8
+    {16, 16, 0x00, 0x0c, 0x00, 0x0c}, // 0xff RST 38h
+};
+
+static GB_TABLE const inst_timing_t cb_inst_timings[256] = {
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x00 RLC B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x01 RLC C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x02 RLC D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x03 RLC E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x04 RLC H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x05 RLC L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x06 RLC (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x07 RLC A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x08 RRC B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x09 RRC C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x0a RRC D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x0b RRC E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x0c RRC H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x0d RRC L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x0e RRC (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x0f RRC A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x10 RL B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x11 RL C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x12 RL D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x13 RL E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x14 RL H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x15 RL L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x16 RL (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x17 RL A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x18 RR B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x19 RR C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x1a RR D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x1b RR E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x1c RR H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x1d RR L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x1e RR (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x1f RR A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x20 SLA B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x21 SLA C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x22 SLA D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x23 SLA E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x24 SLA H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x25 SLA L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x26 SLA (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x27 SLA A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x28 SRA B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x29 SRA C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x2a SRA D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x2b SRA E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x2c SRA H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x2d SRA L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x2e SRA (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x2f SRA A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x30 SWAP B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x31 SWAP C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x32 SWAP D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x33 SWAP E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x34 SWAP H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x35 SWAP L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x36 SWAP (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x37 SWAP A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x38 SRL B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x39 SRL C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x3a SRL D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x3b SRL E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x3c SRL H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x3d SRL L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x3e SRL (HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x3f SRL A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x40 BIT 0,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x41 BIT 0,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x42 BIT 0,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x43 BIT 0,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x44 BIT 0,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x45 BIT 0,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x46 BIT 0,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x47 BIT 0,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x48 BIT 1,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x49 BIT 1,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x4a BIT 1,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x4b BIT 1,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x4c BIT 1,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x4d BIT 1,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x4e BIT 1,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x4f BIT 1,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x50 BIT 2,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x51 BIT 2,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x52 BIT 2,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x53 BIT 2,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x54 BIT 2,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x55 BIT 2,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x56 BIT 2,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x57 BIT 2,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x58 BIT 3,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x59 BIT 3,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x5a BIT 3,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x5b BIT 3,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x5c BIT 3,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x5d BIT 3,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x5e BIT 3,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x5f BIT 3,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x60 BIT 4,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x61 BIT 4,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x62 BIT 4,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x63 BIT 4,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x64 BIT 4,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x65 BIT 4,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x66 BIT 4,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x67 BIT 4,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x68 BIT 5,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x69 BIT 5,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x6a BIT 5,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x6b BIT 5,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x6c BIT 5,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x6d BIT 5,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x6e BIT 5,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x6f BIT 5,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x70 BIT 6,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x71 BIT 6,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x72 BIT 6,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x73 BIT 6,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x74 BIT 6,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x75 BIT 6,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x76 BIT 6,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x77 BIT 6,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x78 BIT 7,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x79 BIT 7,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x7a BIT 7,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x7b BIT 7,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x7c BIT 7,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x7d BIT 7,L
+    {12, 12, 0x04, 0x00, 0x04, 0x00}, // 0x7e BIT 7,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x7f BIT 7,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x80 RES 0,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x81 RES 0,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x82 RES 0,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x83 RES 0,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x84 RES 0,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x85 RES 0,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x86 RES 0,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x87 RES 0,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x88 RES 1,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x89 RES 1,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x8a RES 1,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x8b RES 1,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x8c RES 1,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x8d RES 1,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x8e RES 1,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x8f RES 1,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x90 RES 2,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x91 RES 2,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x92 RES 2,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x93 RES 2,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x94 RES 2,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x95 RES 2,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x96 RES 2,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x97 RES 2,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x98 RES 3,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x99 RES 3,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x9a RES 3,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x9b RES 3,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x9c RES 3,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x9d RES 3,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0x9e RES 3,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0x9f RES 3,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa0 RES 4,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa1 RES 4,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa2 RES 4,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa3 RES 4,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa4 RES 4,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa5 RES 4,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xa6 RES 4,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa7 RES 4,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa8 RES 5,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xa9 RES 5,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xaa RES 5,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xab RES 5,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xac RES 5,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xad RES 5,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xae RES 5,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xaf RES 5,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb0 RES 6,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb1 RES 6,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb2 RES 6,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb3 RES 6,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb4 RES 6,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb5 RES 6,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xb6 RES 6,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb7 RES 6,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb8 RES 7,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xb9 RES 7,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xba RES 7,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xbb RES 7,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xbc RES 7,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xbd RES 7,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xbe RES 7,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xbf RES 7,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc0 SET 0,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc1 SET 0,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc2 SET 0,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc3 SET 0,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc4 SET 0,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc5 SET 0,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xc6 SET 0,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc7 SET 0,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc8 SET 1,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xc9 SET 1,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xca SET 1,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xcb SET 1,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xcc SET 1,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xcd SET 1,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xce SET 1,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xcf SET 1,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd0 SET 2,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd1 SET 2,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd2 SET 2,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd3 SET 2,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd4 SET 2,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd5 SET 2,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xd6 SET 2,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd7 SET 2,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd8 SET 3,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xd9 SET 3,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xda SET 3,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xdb SET 3,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xdc SET 3,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xdd SET 3,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xde SET 3,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xdf SET 3,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe0 SET 4,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe1 SET 4,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe2 SET 4,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe3 SET 4,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe4 SET 4,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe5 SET 4,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xe6 SET 4,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe7 SET 4,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe8 SET 5,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xe9 SET 5,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xea SET 5,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xeb SET 5,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xec SET 5,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xed SET 5,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xee SET 5,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xef SET 5,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf0 SET 6,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf1 SET 6,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf2 SET 6,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf3 SET 6,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf4 SET 6,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf5 SET 6,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xf6 SET 6,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf7 SET 6,A
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf8 SET 7,B
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xf9 SET 7,C
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xfa SET 7,D
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xfb SET 7,E
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xfc SET 7,H
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xfd SET 7,L
+    {16, 16, 0x04, 0x08, 0x04, 0x08}, // 0xfe SET 7,(HL)
+    { 8,  8, 0x00, 0x00, 0x00, 0x00}, // 0xff SET 7,A
+};
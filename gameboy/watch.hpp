@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+#include <emmintrin.h>
+#endif
+
+#include "state.hpp"
+
+// RAM watches: address ranges registered once and copied out of many
+// instances per step into a structure-of-arrays buffer, byte k of instance i
+// at out[k * n + i], so one watched value of every instance is contiguous.
+//
+// Each instance's memory is its own allocation, so a hardware gather would
+// need a scalar load per lane just for the base pointer. Instead every
+// instance copies its ranges into one row of an n x bytes staging buffer
+// (plain memcpys, run in parallel with the rest of the instance's work) and
+// watch_transpose() turns the rows into columns 16x16 bytes at a time.
+
+struct watch_range_t {
+    uint16_t addr;
+    uint16_t len;
+};
+
+// Splits ranges at 4KB pages, each of which may be banked on its own.
+// Returns the number of segments; with `segs` null only counts them. The
+// total byte count goes to `bytes`. Ranges past 0xffff are cut off.
+static GB_DEVICE uint32_t watch_split(const watch_range_t *ranges, uint32_t count, watch_range_t *segs, uint32_t *bytes) {
+    uint32_t n = 0;
+    uint32_t total = 0;
+
+    for (uint32_t r = 0; r < count; r++) {
+        uint32_t addr = ranges[r].addr;
+        uint32_t end = addr + ranges[r].len;
+        if (end > 0x10000) {
+            end = 0x10000;
+        }
+        while (addr < end) {
+            uint32_t page_end = (addr | 0xfff) + 1;
+            uint32_t len = (end < page_end ? end : page_end) - addr;
+            if (segs) {
+                segs[n] = watch_range_t{(uint16_t)addr, (uint16_t)len};
+            }
+            n++;
+            total += len;
+            addr += len;
+        }
+    }
+    if (bytes) {
+        *bytes = total;
+    }
+    return n;
+}
+
+// The watched bytes of one instance as the CPU would see them, without the
+// side effects of read_u8() on I/O registers.
+static GB_DEVICE void watch_copy(const state_t &s, const watch_range_t *segs, uint32_t nsegs, uint8_t *row) {
+    for (uint32_t i = 0; i < nsegs; i++) {
+        memcpy(row, s.page[segs[i].addr >> 12] + (segs[i].addr & 0xfff), segs[i].len);
+        row += segs[i].len;
+    }
+}
+
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+// Four rounds of interleaving row i with row i + 8 transpose 16x16 bytes.
+static void watch_transpose_block(const uint8_t *in, uint32_t in_pitch, uint8_t *out, uint32_t out_pitch) {
+    __m128i x[16], t[16];
+    for (int i = 0; i < 16; i++) {
+        x[i] = _mm_loadu_si128((const __m128i *)(in + i * in_pitch));
+    }
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 8; i++) {
+            t[2 * i] = _mm_unpacklo_epi8(x[i], x[i + 8]);
+            t[2 * i + 1] = _mm_unpackhi_epi8(x[i], x[i + 8]);
+        }
+        memcpy(x, t, sizeof(x));
+    }
+    for (int i = 0; i < 16; i++) {
+        _mm_storeu_si128((__m128i *)(out + i * out_pitch), x[i]);
+    }
+}
+#endif
+
+// out[c * rows + r] = in[r * cols + c]
+static GB_DEVICE void watch_transpose(const uint8_t *in, uint32_t rows, uint32_t cols, uint8_t *out) {
+    uint32_t r0 = 0;
+#if defined(__SSE2__) && !defined(__CUDA_ARCH__)
+    for (; r0 + 16 <= rows; r0 += 16) {
+        uint32_t c = 0;
+        for (; c + 16 <= cols; c += 16) {
+            watch_transpose_block(in + r0 * cols + c, cols, out + c * rows + r0, rows);
+        }
+        for (; c < cols; c++) {
+            for (uint32_t r = r0; r < r0 + 16; r++) {
+                out[c * rows + r] = in[r * cols + c];
+            }
+        }
+    }
+#endif
+    for (uint32_t c = 0; c < cols; c++) {
+        for (uint32_t r = r0; r < rows; r++) {
+            out[c * rows + r] = in[r * cols + c];
+        }
+    }
+}
+
+// Replaces values with their change since the previous call, modulo 256,
+// and remembers the values for the next one.
+static GB_DEVICE void watch_delta(uint8_t *values, uint8_t *prev, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uint8_t v = values[i];
+        values[i] = v - prev[i];
+        prev[i] = v;
+    }
+}
@@ -0,0 +1,256 @@
+#ifndef CUDABOY_H
+#define CUDABOY_H
+
+/* C API of the emulator core. Every instance is an opaque handle that owns
+ * its memory; nothing is shared between instances, so different instances
+ * may be driven from different threads. A single instance is not
+ * thread-safe. Functions returning int return CB_OK or a negative CB_ERR_*.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(CB_BUILD)
+#    define CB_API __declspec(dllexport)
+#  else
+#    define CB_API __declspec(dllimport)
+#  endif
+#else
+#  define CB_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CB_API_VERSION 7
+
+#define CB_SCREEN_WIDTH  160
+#define CB_SCREEN_HEIGHT 144
+
+#define CB_OBS_WIDTH  84
+#define CB_OBS_HEIGHT 84
+
+enum {
+    CB_OK           = 0,
+    CB_ERR_ARG      = -1,   /* null handle or bad argument */
+    CB_ERR_IO       = -2,   /* file could not be read or written */
+    CB_ERR_ROM      = -3,   /* not a cartridge image, or a state of another one */
+    CB_ERR_NO_ROM   = -4,   /* no ROM loaded yet */
+    CB_ERR_SIZE     = -5,   /* buffer too small, or not a state of this version */
+    CB_ERR_STOPPED  = -6    /* the CPU stopped (STOP or unimplemented opcode) */
+};
+
+/* Buttons for cb_set_input(), OR'ed together; a set bit is pressed. */
+enum {
+    CB_BUTTON_RIGHT  = 1 << 0,
+    CB_BUTTON_LEFT   = 1 << 1,
+    CB_BUTTON_UP     = 1 << 2,
+    CB_BUTTON_DOWN   = 1 << 3,
+    CB_BUTTON_A      = 1 << 4,
+    CB_BUTTON_B      = 1 << 5,
+    CB_BUTTON_SELECT = 1 << 6,
+    CB_BUTTON_START  = 1 << 7
+};
+
+/* Framebuffer formats, 160x144 pixels, tightly packed lines. */
+enum {
+    CB_FB_PACKED_2BPP = 0,  /* 4 pixels per byte, shade 0-3, leftmost in bits 7-6 */
+    CB_FB_INDEXED8    = 1,  /* one shade (0-3) per byte */
+    CB_FB_GRAY8       = 2,
+    CB_FB_RGB565      = 3,
+    CB_FB_RGBA8888    = 4   /* bytes R, G, B, A */
+};
+
+/* Regions of the address space for cb_memory(). */
+enum {
+    CB_MEM_VRAM = 0,        /* 0x8000-0x9fff, bank 0 */
+    CB_MEM_WRAM = 1,        /* 0xc000-0xdfff, bank 1 at 0xd000 on the CGB */
+    CB_MEM_OAM  = 2,        /* 0xfe00-0xfe9f */
+    CB_MEM_HRAM = 3         /* 0xff80-0xfffe */
+};
+
+typedef struct cb_instance cb_instance_t;
+
+CB_API int cb_api_version(void);
+
+CB_API cb_instance_t *cb_create(void);
+CB_API void cb_destroy(cb_instance_t *gb);
+
+/* The image is copied; the caller's buffer can be freed afterwards. Loading
+ * resets the machine to the post-boot state. */
+CB_API int cb_load_rom(cb_instance_t *gb, const uint8_t *data, size_t size);
+CB_API int cb_load_rom_file(cb_instance_t *gb, const char *path);
+CB_API int cb_reset(cb_instance_t *gb);
+
+/* Runs until the next V-Blank starts, once or n times. */
+CB_API int cb_run_frame(cb_instance_t *gb);
+CB_API int cb_run_frames(cb_instance_t *gb, uint32_t n);
+
+/* Button state from now on, CB_BUTTON_* bits. */
+CB_API void cb_set_input(cb_instance_t *gb, uint8_t buttons);
+
+/* Pointer to a framebuffer in `format` that the core writes every line
+ * into. The first call for a format sets it up, so its contents are only
+ * complete from the next frame on. Valid until cb_destroy(). */
+CB_API const void *cb_framebuffer(cb_instance_t *gb, int format);
+
+/* Same, but lines go to a caller-owned buffer of cb_framebuffer_size()
+ * bytes, which must outlive the instance or be replaced first. NULL goes
+ * back to no output in that format. */
+CB_API int cb_set_framebuffer(cb_instance_t *gb, int format, void *buf);
+CB_API size_t cb_framebuffer_size(int format);
+
+/* Direct pointer to a region of the machine's memory, valid until
+ * cb_destroy(). Writes go straight into RAM. */
+CB_API uint8_t *cb_memory(cb_instance_t *gb, int region, size_t *size);
+
+CB_API uint64_t cb_frame_count(const cb_instance_t *gb);
+CB_API uint64_t cb_cycle_count(const cb_instance_t *gb);
+
+/* Save states of the whole machine in cb_state_size() bytes of any
+ * alignment: a versioned header, then plain copies of the machine and its
+ * memory, so both directions take microseconds and never allocate. A state
+ * only loads into an instance running the same cartridge and keeps that
+ * instance's framebuffers. */
+CB_API size_t cb_state_size(void);
+CB_API int cb_save_state(cb_instance_t *gb, void *buf, size_t size);
+CB_API int cb_load_state(cb_instance_t *gb, const void *buf, size_t size);
+
+/* Rewind history. With `bytes` > 0 every frame run is recorded as a delta
+ * against the next one, a few KB each, in a ring of about that many bytes
+ * (plus three save states); the oldest frames are dropped when it is full.
+ * The ring holds at least one uncompressed delta, about cb_state_size()
+ * bytes, and smaller sizes are rounded up to that. 0 turns the history off. cb_rewind() puts the machine back `frames`
+ * frames, 0 being the last frame run, redraws the framebuffers and returns
+ * the frames it went back, fewer when the history is shorter. Loading a
+ * ROM clears the history. */
+CB_API int cb_set_rewind(cb_instance_t *gb, size_t bytes);
+CB_API int cb_rewind(cb_instance_t *gb, uint32_t frames);
+CB_API uint32_t cb_rewind_frames(const cb_instance_t *gb);
+
+/* Run-ahead, to hide the frame or two of input lag games have. After each
+ * cb_run_frames() call the instance saves itself, runs `frames` more frames
+ * on the current input with only the last one drawn into the framebuffers,
+ * and restores itself: the framebuffers show the future, emulation (memory,
+ * counters, rewind history) stays on the real frame. 0 turns it off. */
+CB_API int cb_set_run_ahead(cb_instance_t *gb, uint32_t frames);
+
+/* Save-state files, for states kept on disk: a versioned header and one
+ * section per part of the machine (machine registers, VRAM, cartridge RAM,
+ * WRAM, OAM, I/O), each at a 64-byte aligned offset, so a mapped file
+ * loads with one copy per section. CB_STATE_FILE_COMPRESS zero-run codes
+ * the sections where that is smaller; uncompressed files always have the
+ * same size and layout. cb_save_state_file() needs
+ * cb_state_file_max_size() bytes and returns the bytes written. Loading
+ * first checks every section's bounds and every machine field the core
+ * indexes or schedules with, so any bytes are safe to load and run. */
+enum {
+    CB_STATE_FILE_COMPRESS = 1 << 0
+};
+
+CB_API size_t cb_state_file_max_size(void);
+CB_API int cb_save_state_file(cb_instance_t *gb, void *buf, size_t size, int flags);
+CB_API int cb_load_state_file(cb_instance_t *gb, const void *buf, size_t size);
+
+/* Packs: many state files in one file, each aligned as above, with an index
+ * at the end. A writer appends states and writes the index on
+ * cb_pack_finish(), which also frees it. A reader maps the file read-only;
+ * cb_pack_state() points into the mapping, valid until cb_pack_close(), and
+ * is passed to cb_load_state_file() as is. Creating and opening return NULL
+ * when the file can't be written or read, or isn't a pack. */
+typedef struct cb_pack_writer cb_pack_writer_t;
+typedef struct cb_pack cb_pack_t;
+
+CB_API cb_pack_writer_t *cb_pack_create(const char *path);
+CB_API int cb_pack_add(cb_pack_writer_t *w, const void *state_file, size_t size);
+CB_API int cb_pack_finish(cb_pack_writer_t *w);
+
+CB_API cb_pack_t *cb_pack_open(const char *path);
+CB_API void cb_pack_close(cb_pack_t *pack);
+CB_API uint64_t cb_pack_count(const cb_pack_t *pack);
+CB_API const void *cb_pack_state(const cb_pack_t *pack, uint64_t i, size_t *size);
+
+/* A fixed set of instances run side by side on a pool of threads (0 = one
+ * per core), started by cb_pool_create() and kept until cb_pool_destroy().
+ * Their framebuffers in a format sit back to back in a single
+ * allocation of n * cb_framebuffer_size() bytes. */
+typedef struct cb_pool cb_pool_t;
+
+CB_API cb_pool_t *cb_pool_create(uint32_t n, uint32_t workers);
+CB_API void cb_pool_destroy(cb_pool_t *pool);
+CB_API uint32_t cb_pool_size(const cb_pool_t *pool);
+CB_API cb_instance_t *cb_pool_instance(cb_pool_t *pool, uint32_t i);
+
+/* Bits of the per-instance done flags written by cb_pool_step(). */
+enum {
+    CB_DONE_TERMINAL  = 1 << 0, /* the cb_pool_set_done_ram() condition held */
+    CB_DONE_TRUNCATED = 1 << 1, /* the episode reached its frame limit */
+    CB_DONE_STOPPED   = 1 << 2  /* the CPU stopped */
+};
+
+/* Loads the same image into every instance. */
+CB_API int cb_pool_load_rom(cb_pool_t *pool, const uint8_t *data, size_t size);
+CB_API int cb_pool_load_rom_file(cb_pool_t *pool, const char *path);
+
+/* Runs every instance n frames. Returns the first error any of them hit. */
+CB_API int cb_pool_run_frames(cb_pool_t *pool, uint32_t n);
+CB_API const void *cb_pool_framebuffer(cb_pool_t *pool, int format);
+
+/* Environment interface. cb_pool_step() sets instance i's buttons to
+ * actions[i] (or leaves them if actions is NULL), runs every instance
+ * `frames` frames, then writes its outputs: framebuffers, the watched RAM
+ * (cb_pool_ram()) and the CB_DONE_* flags (cb_pool_done(), n bytes). An
+ * instance that finished is reset at the start of the next step, to the
+ * reset state if one was set, before its action is applied, so every output
+ * describes a frame that was actually played. Output pointers stay valid
+ * until the configuration call that sized them is repeated. */
+CB_API int cb_pool_step(cb_pool_t *pool, const uint8_t *actions, uint32_t frames);
+CB_API const uint8_t *cb_pool_done(const cb_pool_t *pool);
+
+/* Terminal when (memory[addr] & mask) == value after a step; mask 0 turns
+ * the check off. Episodes longer than `frames` are truncated; 0 is no limit.
+ * The reset state is a cb_save_state() buffer, NULL for power-on. */
+CB_API int cb_pool_set_done_ram(cb_pool_t *pool, uint16_t addr, uint8_t mask, uint8_t value);
+CB_API int cb_pool_set_episode_frames(cb_pool_t *pool, uint32_t frames);
+CB_API int cb_pool_set_reset_state(cb_pool_t *pool, const void *state, size_t size);
+
+/* RAM watches. The bytes of all ranges, in order, are gathered from every
+ * instance after each step into structure-of-arrays form: watched byte k of
+ * instance i at cb_pool_ram()[k * n + i], cb_pool_ram_bytes() rows. With
+ * CB_WATCH_DELTA each byte is the change since the previous step instead,
+ * modulo 256, the first step and the first after an instance is reset
+ * counting from zero. */
+typedef struct {
+    uint16_t addr;
+    uint16_t len;
+} cb_range_t;
+
+enum {
+    CB_WATCH_DELTA = 1 << 0
+};
+
+CB_API int cb_pool_watch_ram(cb_pool_t *pool, const cb_range_t *ranges, uint32_t count, int flags);
+CB_API const uint8_t *cb_pool_ram(const cb_pool_t *pool);
+CB_API uint32_t cb_pool_ram_bytes(const cb_pool_t *pool);
+
+/* Observation stage. Each step leaves a stack of the last `stack` frames
+ * per instance, oldest first, as CB_OBS_WIDTH x CB_OBS_HEIGHT gray bytes
+ * averaged down from the full frame: cb_pool_obs() holds n x stack of them.
+ * With CB_OBS_MAX_POOL every frame is the pixel-wise max of the last two
+ * frames run. A reset instance starts with its first frame in every slot.
+ * Palettes are taken at the end of each frame. Stacks hold up to 64 frames;
+ * 0 turns the stage off. */
+enum {
+    CB_OBS_MAX_POOL = 1 << 0
+};
+
+CB_API int cb_pool_set_obs(cb_pool_t *pool, uint32_t stack, int flags);
+CB_API const uint8_t *cb_pool_obs(const cb_pool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,957 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../include/cudaboy.h"
+#include "../gameboy/LR35902.hpp"
+#include "../gameboy/grid.hpp"
+#include "../gameboy/obs.hpp"
+#include "../gameboy/rewind.hpp"
+#include "../gameboy/rom.hpp"
+#include "../gameboy/runahead.hpp"
+#include "../gameboy/snapshot.hpp"
+#include "../gameboy/state_file.hpp"
+#include "../gameboy/watch.hpp"
+
+// Implementation of the C API over the header-only core. An instance keeps
+// the machine, its 64KB address space and a copy of the ROM in one
+// allocation; framebuffers are allocated the first time a format is asked
+// for, unless the caller hands in its own.
+
+#define CB_FORMATS 5
+
+struct cb_instance {
+    state_t s;
+    uint8_t mem[0x10000];
+    uint8_t *rom;           // at least 32KB
+    uint8_t *fb[CB_FORMATS];
+    uint8_t fb_foreign;     // formats whose buffer is not ours to free
+    rewind_t rewind;
+    void *rewind_mem;       // null with the history off
+    uint32_t ahead_frames;
+    void *ahead_state;      // cb_state_size() bytes while running ahead
+};
+
+struct cb_pool {
+    uint32_t n;
+    grid_executor_t *grid;  // runs the instances
+    cb_instance_t **gb;
+    int *status;            // last result per instance
+    uint8_t *fb[CB_FORMATS];
+
+    // environment interface
+    watch_range_t *watch;   // watched ranges split at pages
+    uint32_t watch_segs;
+    uint32_t watch_bytes;
+    uint8_t *watch_rows;    // n rows of watch_bytes, filled by the lanes
+    uint8_t *ram;           // watch_bytes rows of n
+    uint8_t *ram_prev;      // values of the previous step, for deltas
+    obs_t obs_taps;
+    uint32_t obs_stack;     // frames per observation, 0 with the stage off
+    bool obs_max_pool;
+    uint8_t *obs;           // n x obs_stack x OBS_SIZE
+    uint8_t *obs_gray;      // n x 2 full frames: the one before last, last
+    uint8_t *obs_fresh;     // stacks to fill with the next frame
+    uint8_t *done;          // CB_DONE_* per instance
+    uint32_t *episode;      // frames into the current episode
+    uint32_t episode_frames;
+    uint16_t done_addr;
+    uint8_t done_mask;
+    uint8_t done_value;
+    uint8_t *reset_state;   // cb_state_size() bytes or null
+};
+
+struct cb_pack_writer {
+    FILE *f;
+    uint64_t pos;           // bytes written so far
+    state_pack_entry_t *index;
+    uint32_t count;
+    uint32_t cap;
+    bool failed;
+};
+
+struct cb_pack {
+    const uint8_t *data;
+    size_t size;
+    uint32_t count;
+    bool mapped;            // else malloc'd
+};
+
+static_assert(sizeof(cb_range_t) == sizeof(watch_range_t), "cb_range_t is passed on as watch_range_t");
+
+static int cb_snapshot_error(int rc) {
+    switch (rc)
+    {
+    case snap::OK:  return CB_OK;
+    case snap::ROM: return CB_ERR_ROM;
+    }
+    return CB_ERR_SIZE;
+}
+
+static void cb_attach_outputs(cb_instance_t *gb) {
+    lcd_output_detach_all(gb->s);
+    for (int f = 0; f < CB_FORMATS; f++) {
+        if (gb->fb[f]) {
+            lcd_output_attach(gb->s, gb->fb[f], f);
+        }
+    }
+}
+
+// Everything in state_t that points at host memory belongs to the
+// instance, not to the machine state, and is put back after a reset.
+static void cb_fix_pointers(cb_instance_t *gb) {
+    state_t &s = gb->s;
+
+    s.mem = gb->mem;
+    mem_map_update(s);
+    s.bus_hook = nullptr;
+    s.bus_ctx = nullptr;
+    s.joy_queue = nullptr;
+    s.serial = nullptr;
+    s.apu.ring = nullptr;
+    s.lcd.pipeline = nullptr;
+    cb_attach_outputs(gb);
+}
+
+// Runs an instance like cb_run_frames() and adds the observation of the
+// frame it ends on to its stack. With max-pooling the frame before is kept
+// too; when the step is a single frame that is the last one of the previous
+// step.
+static int cb_pool_run_observed(cb_pool_t *pool, uint32_t i, uint32_t frames) {
+    cb_instance_t *gb = pool->gb[i];
+    const size_t size = 160 * 144;
+    uint8_t *prev = pool->obs_gray + (size_t)i * 2 * size;
+    uint8_t *last = prev + size;
+    bool split = pool->obs_max_pool && frames >= 2;
+
+    if (pool->obs_max_pool && !split) {
+        memcpy(prev, last, size);
+    }
+    int rc = cb_run_frames(gb, split ? frames - 1 : frames);
+    if (split) {
+        obs_gray(gb->s, prev);
+        if (rc == CB_OK) {
+            rc = cb_run_frames(gb, 1);
+        }
+    }
+    if (rc != CB_OK && rc != CB_ERR_STOPPED) {
+        return rc;
+    }
+
+    obs_gray(gb->s, last);
+    const uint8_t *src = last;
+    if (pool->obs_max_pool) {
+        if (pool->obs_fresh[i] && !split) {
+            memcpy(prev, last, size);
+        }
+        obs_max(prev, last, size);
+        src = prev;
+    }
+
+    uint8_t frame[OBS_SIZE];
+    obs_resize(pool->obs_taps, src, frame);
+    obs_push(pool->obs + (size_t)i * pool->obs_stack * OBS_SIZE, pool->obs_stack, frame, pool->obs_fresh[i]);
+    pool->obs_fresh[i] = 0;
+    return rc;
+}
+
+// One instance's share of cb_pool_step(). Reads the machine's memory
+// through the page map, the way the CPU sees it, but without the side
+// effects of read_u8() on I/O registers.
+static void cb_pool_lane(cb_pool_t *pool, uint32_t i, const uint8_t *actions, uint32_t frames) {
+    cb_instance_t *gb = pool->gb[i];
+    state_t &s = gb->s;
+    int rc = CB_OK;
+
+    if (pool->done[i]) {
+        rc = pool->reset_state ? cb_load_state(gb, pool->reset_state, cb_state_size()) : cb_reset(gb);
+        pool->episode[i] = 0;
+        pool->done[i] = 0;
+        if (pool->obs_stack) {
+            pool->obs_fresh[i] = 1;
+        }
+        // deltas of a new episode count from zero, like the first step's
+        if (pool->ram_prev) {
+            for (uint32_t k = 0; k < pool->watch_bytes; k++) {
+                pool->ram_prev[(size_t)k * pool->n + i] = 0;
+            }
+        }
+    }
+    if (rc == CB_OK) {
+        if (actions) {
+            joypad_set(s, actions[i]);
+        }
+        rc = pool->obs_stack ? cb_pool_run_observed(pool, i, frames) : cb_run_frames(gb, frames);
+    }
+
+    uint8_t done = 0;
+    if (rc == CB_ERR_STOPPED) {
+        done |= CB_DONE_STOPPED;
+        rc = CB_OK;
+    }
+    pool->status[i] = rc;
+    if (rc != CB_OK) {
+        return;
+    }
+
+    watch_copy(s, pool->watch, pool->watch_segs, pool->watch_rows + (size_t)i * pool->watch_bytes);
+
+    pool->episode[i] += frames;
+    if (pool->done_mask && (s.page[pool->done_addr >> 12][pool->done_addr & 0xfff] & pool->done_mask) == pool->done_value) {
+        done |= CB_DONE_TERMINAL;
+    }
+    if (pool->episode_frames && pool->episode[i] >= pool->episode_frames) {
+        done |= CB_DONE_TRUNCATED;
+    }
+    pool->done[i] = done;
+}
+
+extern "C" {
+
+int cb_api_version(void) {
+    return CB_API_VERSION;
+}
+
+cb_instance_t *cb_create(void) {
+    return (cb_instance_t *)calloc(1, sizeof(cb_instance_t));
+}
+
+void cb_destroy(cb_instance_t *gb) {
+    if (!gb) {
+        return;
+    }
+    for (int f = 0; f < CB_FORMATS; f++) {
+        if (!(gb->fb_foreign & (1 << f))) {
+            free(gb->fb[f]);
+        }
+    }
+    free(gb->rewind_mem);
+    free(gb->ahead_state);
+    free(gb->rom);
+    free(gb);
+}
+
+int cb_reset(cb_instance_t *gb) {
+    if (!gb) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+    // start from a clean machine so every reset is the same
+    memset(&gb->s, 0, sizeof(state_t));
+    memset(gb->mem, 0, sizeof(gb->mem));
+    state_init(gb->s, gb->mem, gb->rom);
+    cb_fix_pointers(gb);
+    return CB_OK;
+}
+
+int cb_load_rom(cb_instance_t *gb, const uint8_t *data, size_t size) {
+    if (!gb || !data) {
+        return CB_ERR_ARG;
+    }
+    if (size < 0x150) {
+        return CB_ERR_ROM;
+    }
+
+    // the core copies the two fixed banks, so keep at least 32KB
+    uint8_t *rom = (uint8_t *)calloc(size < 0x8000 ? 0x8000 : size, 1);
+    if (!rom) {
+        return CB_ERR_ARG;
+    }
+    memcpy(rom, data, size);
+
+    free(gb->rom);
+    gb->rom = rom;
+    rewind_clear(gb->rewind);
+    return cb_reset(gb);
+}
+
+int cb_load_rom_file(cb_instance_t *gb, const char *path) {
+    if (!gb || !path) {
+        return CB_ERR_ARG;
+    }
+
+    uint8_t *rom;
+    if (load_rom(&rom, path, false) != 0) {
+        return CB_ERR_IO;
+    }
+    free(gb->rom);
+    gb->rom = rom;
+    rewind_clear(gb->rewind);
+    return cb_reset(gb);
+}
+
+// Runs up to the next V-Blank; false if the CPU stopped first.
+static bool cb_frame(state_t &s) {
+    uint64_t end = s.lcd.frame + 1;
+    while (s.lcd.frame < end) {
+        if (s.stop) {
+            return false;
+        }
+        step(s);
+    }
+    return true;
+}
+
+int cb_run_frames(cb_instance_t *gb, uint32_t n) {
+    if (!gb) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+
+    state_t &s = gb->s;
+    for (uint32_t i = 0; i < n; i++) {
+        if (!cb_frame(s)) {
+            return CB_ERR_STOPPED;
+        }
+        if (gb->rewind_mem) {
+            rewind_push(gb->rewind, s);
+        }
+    }
+    if (gb->ahead_frames && n) {
+        runahead(s, gb->ahead_state, gb->ahead_frames, cb_frame);
+    }
+    return CB_OK;
+}
+
+int cb_run_frame(cb_instance_t *gb) {
+    return cb_run_frames(gb, 1);
+}
+
+void cb_set_input(cb_instance_t *gb, uint8_t buttons) {
+    if (gb) {
+        joypad_set(gb->s, buttons);
+    }
+}
+
+const void *cb_framebuffer(cb_instance_t *gb, int format) {
+    if (!gb || format < 0 || format >= CB_FORMATS) {
+        return nullptr;
+    }
+    if (!gb->fb[format]) {
+        gb->fb[format] = (uint8_t *)calloc(1, cb_framebuffer_size(format));
+        if (gb->fb[format] && gb->rom) {
+            lcd_output_attach(gb->s, gb->fb[format], format);
+        }
+    }
+    return gb->fb[format];
+}
+
+int cb_set_framebuffer(cb_instance_t *gb, int format, void *buf) {
+    if (!gb || format < 0 || format >= CB_FORMATS) {
+        return CB_ERR_ARG;
+    }
+    if (!(gb->fb_foreign & (1 << format))) {
+        free(gb->fb[format]);
+    }
+    gb->fb[format] = (uint8_t *)buf;
+    // without a buffer, a later cb_framebuffer() allocates one of ours
+    if (buf) {
+        gb->fb_foreign |= 1 << format;
+    }
+    else {
+        gb->fb_foreign &= ~(1 << format);
+    }
+    if (gb->rom) {
+        cb_attach_outputs(gb);
+    }
+    return CB_OK;
+}
+
+size_t cb_framebuffer_size(int format) {
+    if (format < 0 || format >= CB_FORMATS) {
+        return 0;
+    }
+    return (size_t)CB_SCREEN_HEIGHT * lcd_output_min_pitch(format);
+}
+
+uint8_t *cb_memory(cb_instance_t *gb, int region, size_t *size) {
+    uint16_t start, len;
+    switch (region)
+    {
+    case CB_MEM_VRAM: start = 0x8000; len = 0x2000; break;
+    case CB_MEM_WRAM: start = 0xc000; len = 0x2000; break;
+    case CB_MEM_OAM:  start = 0xfe00; len = 0xa0;   break;
+    case CB_MEM_HRAM: start = 0xff80; len = 0x7f;   break;
+    default: return nullptr;
+    }
+    if (!gb) {
+        return nullptr;
+    }
+    if (size) {
+        *size = len;
+    }
+    return gb->mem + start;
+}
+
+uint64_t cb_frame_count(const cb_instance_t *gb) {
+    return gb ? gb->s.lcd.frame : 0;
+}
+
+uint64_t cb_cycle_count(const cb_instance_t *gb) {
+    return gb ? gb->s.cycles : 0;
+}
+
+size_t cb_state_size(void) {
+    return snapshot_size();
+}
+
+int cb_save_state(cb_instance_t *gb, void *buf, size_t size) {
+    if (!gb || !buf) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+    return cb_snapshot_error(snapshot_save(gb->s, buf, size));
+}
+
+int cb_load_state(cb_instance_t *gb, const void *buf, size_t size) {
+    if (!gb || !buf) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+    return cb_snapshot_error(snapshot_load(gb->s, buf, size));
+}
+
+int cb_set_rewind(cb_instance_t *gb, size_t bytes) {
+    if (!gb) {
+        return CB_ERR_ARG;
+    }
+    free(gb->rewind_mem);
+    gb->rewind_mem = nullptr;
+    rewind_clear(gb->rewind);
+    if (bytes == 0) {
+        return CB_OK;
+    }
+
+    size_t size = rewind_mem_size(bytes < REWIND_MIN_RING ? REWIND_MIN_RING : bytes);
+    void *mem = malloc(size);
+    if (!mem || !rewind_init(gb->rewind, mem, size)) {
+        free(mem);
+        return CB_ERR_SIZE;
+    }
+    gb->rewind_mem = mem;
+    return CB_OK;
+}
+
+int cb_rewind(cb_instance_t *gb, uint32_t frames) {
+    if (!gb) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+    if (!gb->rewind_mem) {
+        return 0;
+    }
+    int rc = rewind_step(gb->rewind, gb->s, frames);
+    if (rc < 0) {
+        return cb_snapshot_error(rc);
+    }
+    lcd_output_redraw(gb->s);
+    return rc;
+}
+
+uint32_t cb_rewind_frames(const cb_instance_t *gb) {
+    return gb && gb->rewind_mem ? gb->rewind.frames : 0;
+}
+
+int cb_set_run_ahead(cb_instance_t *gb, uint32_t frames) {
+    if (!gb) {
+        return CB_ERR_ARG;
+    }
+    if (frames && !gb->ahead_state && !(gb->ahead_state = malloc(snapshot_size()))) {
+        return CB_ERR_SIZE;
+    }
+    gb->ahead_frames = frames;
+    return CB_OK;
+}
+
+size_t cb_state_file_max_size(void) {
+    return state_file_max_size();
+}
+
+int cb_save_state_file(cb_instance_t *gb, void *buf, size_t size, int flags) {
+    if (!gb || !buf) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+    int rc = state_file_write(gb->s, buf, size, flags & CB_STATE_FILE_COMPRESS ? STATE_FILE_RLE : 0);
+    return rc < 0 ? cb_snapshot_error(rc) : rc;
+}
+
+int cb_load_state_file(cb_instance_t *gb, const void *buf, size_t size) {
+    if (!gb || !buf) {
+        return CB_ERR_ARG;
+    }
+    if (!gb->rom) {
+        return CB_ERR_NO_ROM;
+    }
+    return cb_snapshot_error(state_file_load(gb->s, buf, size));
+}
+
+// Writes `size` bytes and pads up to the next aligned offset.
+static void cb_pack_write(cb_pack_writer_t *w, const void *data, size_t size) {
+    static const uint8_t zero[STATE_FILE_ALIGN] = {};
+    size_t pad = state_file_align(w->pos + size) - (w->pos + size);
+    if (fwrite(data, 1, size, w->f) != size || fwrite(zero, 1, pad, w->f) != pad) {
+        w->failed = true;
+    }
+    w->pos += size + pad;
+}
+
+cb_pack_writer_t *cb_pack_create(const char *path) {
+    if (!path) {
+        return nullptr;
+    }
+    cb_pack_writer_t *w = (cb_pack_writer_t *)calloc(1, sizeof(cb_pack_writer_t));
+    if (!w || !(w->f = fopen(path, "wb"))) {
+        free(w);
+        return nullptr;
+    }
+    // the header is written over on cb_pack_finish()
+    state_pack_header_t h = {};
+    cb_pack_write(w, &h, sizeof(h));
+    return w;
+}
+
+int cb_pack_add(cb_pack_writer_t *w, const void *state_file, size_t size) {
+    if (!w || !state_file) {
+        return CB_ERR_ARG;
+    }
+    if (state_file_check(state_file, size) != snap::OK) {
+        return CB_ERR_SIZE;
+    }
+    if (w->count == w->cap) {
+        uint32_t cap = w->cap ? 2 * w->cap : 64;
+        void *index = realloc(w->index, cap * sizeof(state_pack_entry_t));
+        if (!index) {
+            return CB_ERR_SIZE;
+        }
+        w->index = (state_pack_entry_t *)index;
+        w->cap = cap;
+    }
+
+    // only what the header counts, not the rest of a max size buffer
+    state_file_header_t h;
+    memcpy(&h, state_file, sizeof(h));
+    w->index[w->count++] = {w->pos, h.file_size};
+    cb_pack_write(w, state_file, h.file_size);
+    return w->failed ? CB_ERR_IO : CB_OK;
+}
+
+int cb_pack_finish(cb_pack_writer_t *w) {
+    if (!w) {
+        return CB_ERR_ARG;
+    }
+    state_pack_header_t h = {};
+    h.magic = STATE_PACK_MAGIC;
+    h.version = STATE_PACK_VERSION;
+    h.header_size = sizeof(h);
+    h.count = w->count;
+    h.index_offset = w->pos;
+    cb_pack_write(w, w->index, w->count * sizeof(state_pack_entry_t));
+    if (fseek(w->f, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, w->f) != 1) {
+        w->failed = true;
+    }
+    if (fclose(w->f) != 0) {
+        w->failed = true;
+    }
+    bool failed = w->failed;
+    free(w->index);
+    free(w);
+    return failed ? CB_ERR_IO : CB_OK;
+}
+
+// Maps a file read-only; without mmap it is read into memory instead.
+static bool cb_pack_map(cb_pack_t *pack, const char *path) {
+#if defined(_WIN32)
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        size = ftell(f);
+    }
+    uint8_t *data = size > 0 ? (uint8_t *)malloc(size) : nullptr;
+    bool ok = data && fseek(f, 0, SEEK_SET) == 0 && fread(data, 1, size, f) == (size_t)size;
+    fclose(f);
+    if (!ok) {
+        free(data);
+        return false;
+    }
+    pack->data = data;
+    pack->size = size;
+    pack->mapped = false;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    pack->data = (const uint8_t *)data;
+    pack->size = st.st_size;
+    pack->mapped = true;
+    return true;
+#endif
+}
+
+cb_pack_t *cb_pack_open(const char *path) {
+    if (!path) {
+        return nullptr;
+    }
+    cb_pack_t *pack = (cb_pack_t *)calloc(1, sizeof(cb_pack_t));
+    if (!pack || !cb_pack_map(pack, path)) {
+        free(pack);
+        return nullptr;
+    }
+    int64_t count = state_pack_check(pack->data, pack->size);
+    if (count < 0) {
+        cb_pack_close(pack);
+        return nullptr;
+    }
+    pack->count = (uint32_t)count;
+    return pack;
+}
+
+void cb_pack_close(cb_pack_t *pack) {
+    if (!pack) {
+        return;
+    }
+#if !defined(_WIN32)
+    if (pack->mapped) {
+        munmap((void *)pack->data, pack->size);
+    }
+    else
+#endif
+    {
+        free((void *)pack->data);
+    }
+    free(pack);
+}
+
+uint64_t cb_pack_count(const cb_pack_t *pack) {
+    return pack ? pack->count : 0;
+}
+
+const void *cb_pack_state(const cb_pack_t *pack, uint64_t i, size_t *size) {
+    if (!pack || i >= pack->count) {
+        return nullptr;
+    }
+    size_t state_size;
+    const void *state = state_pack_get(pack->data, pack->size, (uint32_t)i, &state_size);
+    if (state && size) {
+        *size = state_size;
+    }
+    return state;
+}
+
+cb_pool_t *cb_pool_create(uint32_t n, uint32_t workers) {
+    if (n == 0) {
+        return nullptr;
+    }
+    cb_pool_t *pool = (cb_pool_t *)calloc(1, sizeof(cb_pool_t));
+    if (!pool) {
+        return nullptr;
+    }
+    pool->n = n;
+    // each block is one instance, so more threads than that would idle
+    unsigned threads = workers ? workers : std::thread::hardware_concurrency();
+    pool->grid = grid_executor_create(threads < n ? threads : n);
+    pool->gb = (cb_instance_t **)calloc(n, sizeof(cb_instance_t *));
+    pool->status = (int *)calloc(n, sizeof(int));
+    pool->done = (uint8_t *)calloc(n, 1);
+    pool->episode = (uint32_t *)calloc(n, sizeof(uint32_t));
+    if (!pool->gb || !pool->status || !pool->done || !pool->episode) {
+        cb_pool_destroy(pool);
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (!(pool->gb[i] = cb_create())) {
+            cb_pool_destroy(pool);
+            return nullptr;
+        }
+    }
+    return pool;
+}
+
+void cb_pool_destroy(cb_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    if (pool->gb) {
+        for (uint32_t i = 0; i < pool->n; i++) {
+            cb_destroy(pool->gb[i]);
+        }
+    }
+    for (int f = 0; f < CB_FORMATS; f++) {
+        free(pool->fb[f]);
+    }
+    free(pool->gb);
+    free(pool->status);
+    free(pool->watch);
+    free(pool->watch_rows);
+    free(pool->ram);
+    free(pool->ram_prev);
+    free(pool->obs);
+    free(pool->obs_gray);
+    free(pool->obs_fresh);
+    free(pool->done);
+    free(pool->episode);
+    free(pool->reset_state);
+    grid_executor_destroy(pool->grid);
+    free(pool);
+}
+
+uint32_t cb_pool_size(const cb_pool_t *pool) {
+    return pool ? pool->n : 0;
+}
+
+cb_instance_t *cb_pool_instance(cb_pool_t *pool, uint32_t i) {
+    return pool && i < pool->n ? pool->gb[i] : nullptr;
+}
+
+int cb_pool_load_rom(cb_pool_t *pool, const uint8_t *data, size_t size) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+    for (uint32_t i = 0; i < pool->n; i++) {
+        int rc = cb_load_rom(pool->gb[i], data, size);
+        if (rc != CB_OK) {
+            return rc;
+        }
+    }
+    return CB_OK;
+}
+
+int cb_pool_load_rom_file(cb_pool_t *pool, const char *path) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+    for (uint32_t i = 0; i < pool->n; i++) {
+        int rc = cb_load_rom_file(pool->gb[i], path);
+        if (rc != CB_OK) {
+            return rc;
+        }
+    }
+    return CB_OK;
+}
+
+int cb_pool_run_frames(cb_pool_t *pool, uint32_t n) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+
+    // one instance per block: they are far too large to share a cache
+    grid_launch(*pool->grid, grid_dim_for(pool->n, 1), [=](uint32_t block, uint32_t) {
+        pool->status[block] = cb_run_frames(pool->gb[block], n);
+    });
+
+    for (uint32_t i = 0; i < pool->n; i++) {
+        if (pool->status[i] != CB_OK) {
+            return pool->status[i];
+        }
+    }
+    return CB_OK;
+}
+
+const void *cb_pool_framebuffer(cb_pool_t *pool, int format) {
+    if (!pool || format < 0 || format >= CB_FORMATS) {
+        return nullptr;
+    }
+    if (!pool->fb[format]) {
+        size_t size = cb_framebuffer_size(format);
+        uint8_t *fb = (uint8_t *)calloc(pool->n, size);
+        if (!fb) {
+            return nullptr;
+        }
+        for (uint32_t i = 0; i < pool->n; i++) {
+            cb_set_framebuffer(pool->gb[i], format, fb + i * size);
+        }
+        pool->fb[format] = fb;
+    }
+    return pool->fb[format];
+}
+
+int cb_pool_watch_ram(cb_pool_t *pool, const cb_range_t *ranges, uint32_t count, int flags) {
+    if (!pool || (count && !ranges)) {
+        return CB_ERR_ARG;
+    }
+
+    const watch_range_t *in = (const watch_range_t *)ranges;
+    uint32_t bytes;
+    uint32_t segs = watch_split(in, count, nullptr, &bytes);
+
+    watch_range_t *watch = nullptr;
+    uint8_t *rows = nullptr, *ram = nullptr, *prev = nullptr;
+    if (bytes) {
+        watch = (watch_range_t *)malloc(segs * sizeof(watch_range_t));
+        rows = (uint8_t *)calloc(pool->n, bytes);
+        ram = (uint8_t *)calloc(pool->n, bytes);
+        if (flags & CB_WATCH_DELTA) {
+            prev = (uint8_t *)calloc(pool->n, bytes);
+        }
+        if (!watch || !rows || !ram || ((flags & CB_WATCH_DELTA) && !prev)) {
+            free(watch);
+            free(rows);
+            free(ram);
+            free(prev);
+            return CB_ERR_ARG;
+        }
+        watch_split(in, count, watch, &bytes);
+    }
+
+    free(pool->watch);
+    free(pool->watch_rows);
+    free(pool->ram);
+    free(pool->ram_prev);
+    pool->watch = watch;
+    pool->watch_segs = bytes ? segs : 0;
+    pool->watch_bytes = bytes;
+    pool->watch_rows = rows;
+    pool->ram = ram;
+    pool->ram_prev = prev;
+    return CB_OK;
+}
+
+const uint8_t *cb_pool_ram(const cb_pool_t *pool) {
+    return pool ? pool->ram : nullptr;
+}
+
+uint32_t cb_pool_ram_bytes(const cb_pool_t *pool) {
+    return pool ? pool->watch_bytes : 0;
+}
+
+int cb_pool_set_obs(cb_pool_t *pool, uint32_t stack, int flags) {
+    if (!pool || stack > 64) {
+        return CB_ERR_ARG;
+    }
+
+    uint8_t *obs = nullptr, *gray = nullptr, *fresh = nullptr;
+    if (stack) {
+        obs = (uint8_t *)calloc((size_t)pool->n * stack, OBS_SIZE);
+        gray = (uint8_t *)calloc((size_t)pool->n * 2, 160 * 144);
+        fresh = (uint8_t *)malloc(pool->n);
+        if (!obs || !gray || !fresh) {
+            free(obs);
+            free(gray);
+            free(fresh);
+            return CB_ERR_ARG;
+        }
+        memset(fresh, 1, pool->n);
+    }
+
+    free(pool->obs);
+    free(pool->obs_gray);
+    free(pool->obs_fresh);
+    obs_init(pool->obs_taps);
+    pool->obs_stack = stack;
+    pool->obs_max_pool = flags & CB_OBS_MAX_POOL;
+    pool->obs = obs;
+    pool->obs_gray = gray;
+    pool->obs_fresh = fresh;
+    return CB_OK;
+}
+
+const uint8_t *cb_pool_obs(const cb_pool_t *pool) {
+    return pool ? pool->obs : nullptr;
+}
+
+int cb_pool_set_done_ram(cb_pool_t *pool, uint16_t addr, uint8_t mask, uint8_t value) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+    pool->done_addr = addr;
+    pool->done_mask = mask;
+    pool->done_value = value & mask;
+    return CB_OK;
+}
+
+int cb_pool_set_episode_frames(cb_pool_t *pool, uint32_t frames) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+    pool->episode_frames = frames;
+    return CB_OK;
+}
+
+int cb_pool_set_reset_state(cb_pool_t *pool, const void *state, size_t size) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+    if (!state) {
+        free(pool->reset_state);
+        pool->reset_state = nullptr;
+        return CB_OK;
+    }
+
+    // a bad state fails here rather than at the first reset
+    int rc = snapshot_check(state, size);
+    if (rc != snap::OK) {
+        return cb_snapshot_error(rc);
+    }
+
+    uint8_t *copy = (uint8_t *)malloc(cb_state_size());
+    if (!copy) {
+        return CB_ERR_ARG;
+    }
+    memcpy(copy, state, cb_state_size());
+    free(pool->reset_state);
+    pool->reset_state = copy;
+    return CB_OK;
+}
+
+int cb_pool_step(cb_pool_t *pool, const uint8_t *actions, uint32_t frames) {
+    if (!pool) {
+        return CB_ERR_ARG;
+    }
+
+    grid_launch(*pool->grid, grid_dim_for(pool->n, 1), [=](uint32_t block, uint32_t) {
+        cb_pool_lane(pool, block, actions, frames);
+    });
+
+    if (pool->watch_bytes) {
+        watch_transpose(pool->watch_rows, pool->n, pool->watch_bytes, pool->ram);
+        if (pool->ram_prev) {
+            watch_delta(pool->ram, pool->ram_prev, (size_t)pool->n * pool->watch_bytes);
+        }
+    }
+
+    for (uint32_t i = 0; i < pool->n; i++) {
+        if (pool->status[i] != CB_OK) {
+            return pool->status[i];
+        }
+    }
+    return CB_OK;
+}
+
+const uint8_t *cb_pool_done(const cb_pool_t *pool) {
+    return pool ? pool->done : nullptr;
+}
+
+}
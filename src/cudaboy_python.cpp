@@ -0,0 +1,1032 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstring>
+
+#include "cudaboy.h"
+
+// Python module over the C API. Framebuffers and RAM are handed out as
+// cudaboy.View objects implementing the buffer protocol on top of emulator
+// memory, so numpy.asarray(view) and memoryview(view) see the live data
+// without copying and without this module needing NumPy to build. Stepping
+// releases the GIL. A view keeps the emulator or pool it came from alive.
+
+struct view_object {
+    PyObject_HEAD
+    PyObject *owner;
+    void *buf;
+    bool readonly;
+    const char *format;
+    Py_ssize_t itemsize;
+    int ndim;
+    Py_ssize_t shape[4];
+    Py_ssize_t strides[4];
+    int *exports;           // owner's count of live views, if it keeps one
+};
+
+struct emulator_object {
+    PyObject_HEAD
+    cb_instance_t *gb;
+    PyObject *pool;         // set when the instance belongs to a pool
+    bool *busy;             // stepping without the GIL, ours or the pool's
+    bool own_busy;
+};
+
+struct pool_object {
+    PyObject_HEAD
+    cb_pool_t *pool;
+    bool busy;
+    int ram_views;          // views of the RAM observations, which move on resize
+    int obs_views;          // same for the observation stacks
+    Py_ssize_t obs_stack;
+};
+
+struct pack_object {
+    PyObject_HEAD
+    cb_pack_t *pack;
+    int views;              // views into the mapping, which re-init unmaps
+};
+
+static PyTypeObject view_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+static PyTypeObject emulator_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+static PyTypeObject pool_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+static PyTypeObject pack_type = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+static int py_check(int rc) {
+    switch (rc)
+    {
+    case CB_OK: return 0;
+    case CB_ERR_IO: PyErr_SetString(PyExc_OSError, "cannot read or write file"); break;
+    case CB_ERR_ROM: PyErr_SetString(PyExc_ValueError, "not a cartridge image, or a state of another cartridge"); break;
+    case CB_ERR_NO_ROM: PyErr_SetString(PyExc_RuntimeError, "no ROM loaded"); break;
+    case CB_ERR_SIZE: PyErr_SetString(PyExc_ValueError, "buffer too small, or not a save state of this version"); break;
+    case CB_ERR_STOPPED: PyErr_SetString(PyExc_RuntimeError, "CPU stopped"); break;
+    default: PyErr_SetString(PyExc_ValueError, "invalid argument"); break;
+    }
+    return -1;
+}
+
+static bool py_busy(bool *busy) {
+    if (*busy) {
+        PyErr_SetString(PyExc_RuntimeError, "emulator is being stepped by another thread");
+        return true;
+    }
+    return false;
+}
+
+// ---- View ----
+
+// C-contiguous view of `ndim` dimensions of `itemsize`-byte items.
+static PyObject *view_new(PyObject *owner, const void *buf, bool readonly, const char *format,
+                          Py_ssize_t itemsize, int ndim, const Py_ssize_t *shape) {
+    if (!buf) {
+        return PyErr_NoMemory();
+    }
+    view_object *v = PyObject_New(view_object, &view_type);
+    if (!v) {
+        return nullptr;
+    }
+    Py_INCREF(owner);
+    v->owner = owner;
+    v->buf = (void *)buf;
+    v->readonly = readonly;
+    v->format = format;
+    v->itemsize = itemsize;
+    v->ndim = ndim;
+    v->exports = nullptr;
+
+    Py_ssize_t stride = itemsize;
+    for (int i = ndim - 1; i >= 0; i--) {
+        v->shape[i] = shape[i];
+        v->strides[i] = stride;
+        stride *= shape[i];
+    }
+    return (PyObject *)v;
+}
+
+static void view_dealloc(view_object *v) {
+    if (v->exports) {
+        (*v->exports)--;
+    }
+    Py_DECREF(v->owner);
+    PyObject_Free(v);
+}
+
+static int view_getbuffer(view_object *v, Py_buffer *view, int flags) {
+    if ((flags & PyBUF_WRITABLE) && v->readonly) {
+        PyErr_SetString(PyExc_BufferError, "view is read-only");
+        return -1;
+    }
+
+    Py_ssize_t len = v->itemsize;
+    for (int i = 0; i < v->ndim; i++) {
+        len *= v->shape[i];
+    }
+
+    view->buf = v->buf;
+    view->obj = (PyObject *)v;
+    Py_INCREF(v);
+    view->len = len;
+    view->readonly = v->readonly;
+    view->itemsize = v->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? (char *)v->format : nullptr;
+    view->ndim = v->ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? v->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? v->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+static PyBufferProcs view_as_buffer = {(getbufferproc)view_getbuffer, nullptr};
+
+static PyObject *view_get_shape(view_object *v, void *) {
+    PyObject *shape = PyTuple_New(v->ndim);
+    for (int i = 0; shape && i < v->ndim; i++) {
+        PyTuple_SET_ITEM(shape, i, PyLong_FromSsize_t(v->shape[i]));
+    }
+    return shape;
+}
+
+static PyGetSetDef view_getset[] = {
+    {"shape", (getter)view_get_shape, nullptr, "Shape of the data.", nullptr},
+    {nullptr},
+};
+
+// Framebuffer shape for `format`, with `n` > 0 adding a leading pool axis.
+static PyObject *frame_view(PyObject *owner, const void *buf, int format, Py_ssize_t n) {
+    Py_ssize_t shape[4];
+    int ndim = 0;
+    if (n) {
+        shape[ndim++] = n;
+    }
+    shape[ndim++] = CB_SCREEN_HEIGHT;
+
+    switch (format)
+    {
+    case CB_FB_PACKED_2BPP:
+        shape[ndim++] = CB_SCREEN_WIDTH / 4;
+        return view_new(owner, buf, true, "B", 1, ndim, shape);
+    case CB_FB_INDEXED8:
+    case CB_FB_GRAY8:
+        shape[ndim++] = CB_SCREEN_WIDTH;
+        return view_new(owner, buf, true, "B", 1, ndim, shape);
+    case CB_FB_RGB565:
+        shape[ndim++] = CB_SCREEN_WIDTH;
+        return view_new(owner, buf, true, "H", 2, ndim, shape);
+    case CB_FB_RGBA8888:
+        shape[ndim++] = CB_SCREEN_WIDTH;
+        shape[ndim++] = 4;
+        return view_new(owner, buf, true, "B", 1, ndim, shape);
+    }
+    PyErr_SetString(PyExc_ValueError, "unknown framebuffer format");
+    return nullptr;
+}
+
+// ---- Emulator ----
+
+// A str or os.PathLike is a file name, anything else must hold the image.
+static int load_rom_arg(PyObject *rom, int (*load_file)(void *, const char *),
+                        int (*load_data)(void *, const uint8_t *, size_t), void *target) {
+    int rc;
+    if (PyUnicode_Check(rom) || PyObject_HasAttrString(rom, "__fspath__")) {
+        PyObject *path;
+        if (!PyUnicode_FSConverter(rom, &path)) {
+            return -1;
+        }
+        Py_BEGIN_ALLOW_THREADS
+        rc = load_file(target, PyBytes_AS_STRING(path));
+        Py_END_ALLOW_THREADS
+        Py_DECREF(path);
+    }
+    else {
+        Py_buffer data;
+        if (PyObject_GetBuffer(rom, &data, PyBUF_SIMPLE) < 0) {
+            return -1;
+        }
+        rc = load_data(target, (const uint8_t *)data.buf, data.len);
+        PyBuffer_Release(&data);
+    }
+    return py_check(rc);
+}
+
+static int emulator_load_file(void *gb, const char *path) {
+    return cb_load_rom_file((cb_instance_t *)gb, path);
+}
+
+static int emulator_load_data(void *gb, const uint8_t *data, size_t size) {
+    return cb_load_rom((cb_instance_t *)gb, data, size);
+}
+
+static int emulator_init(emulator_object *self, PyObject *args, PyObject *kwds) {
+    static const char *keywords[] = {"rom", nullptr};
+    PyObject *rom = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O", (char **)keywords, &rom)) {
+        return -1;
+    }
+    if (self->pool) {
+        PyErr_SetString(PyExc_TypeError, "pool instances cannot be re-initialized");
+        return -1;
+    }
+    if (!self->gb && !(self->gb = cb_create())) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->busy = &self->own_busy;
+    if (rom && rom != Py_None) {
+        return load_rom_arg(rom, emulator_load_file, emulator_load_data, self->gb);
+    }
+    return 0;
+}
+
+static void emulator_dealloc(emulator_object *self) {
+    if (self->pool) {
+        Py_DECREF(self->pool);
+    }
+    else {
+        cb_destroy(self->gb);
+    }
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static bool emulator_ready(emulator_object *self) {
+    if (!self->gb) {
+        PyErr_SetString(PyExc_RuntimeError, "Emulator.__init__ was not called");
+        return false;
+    }
+    return !py_busy(self->busy);
+}
+
+static PyObject *emulator_load_rom(emulator_object *self, PyObject *rom) {
+    if (!emulator_ready(self) || load_rom_arg(rom, emulator_load_file, emulator_load_data, self->gb) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_reset(emulator_object *self, PyObject *) {
+    if (!emulator_ready(self) || py_check(cb_reset(self->gb)) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_step(emulator_object *self, PyObject *const *args, Py_ssize_t nargs) {
+    unsigned long frames = 1;
+    if (nargs > 1) {
+        PyErr_SetString(PyExc_TypeError, "step() takes at most one argument");
+        return nullptr;
+    }
+    if (nargs == 1 && (frames = PyLong_AsUnsignedLong(args[0])) == (unsigned long)-1 && PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (!emulator_ready(self)) {
+        return nullptr;
+    }
+
+    int rc;
+    *self->busy = true;
+    Py_BEGIN_ALLOW_THREADS
+    rc = cb_run_frames(self->gb, (uint32_t)frames);
+    Py_END_ALLOW_THREADS
+    *self->busy = false;
+
+    if (py_check(rc) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_set_input(emulator_object *self, PyObject *arg) {
+    unsigned long buttons = PyLong_AsUnsignedLong(arg);
+    if (buttons == (unsigned long)-1 && PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (!emulator_ready(self)) {
+        return nullptr;
+    }
+    cb_set_input(self->gb, (uint8_t)buttons);
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_frame(emulator_object *self, PyObject *args) {
+    int format = CB_FB_GRAY8;
+    if (!PyArg_ParseTuple(args, "|i", &format) || !emulator_ready(self)) {
+        return nullptr;
+    }
+    if (format < CB_FB_PACKED_2BPP || format > CB_FB_RGBA8888) {
+        PyErr_SetString(PyExc_ValueError, "unknown framebuffer format");
+        return nullptr;
+    }
+    return frame_view((PyObject *)self, cb_framebuffer(self->gb, format), format, 0);
+}
+
+// save_state(buf=None): into a new bytes object, or into any writable
+// buffer of STATE_SIZE bytes without allocating.
+static PyObject *emulator_save_state(emulator_object *self, PyObject *const *args, Py_ssize_t nargs) {
+    if (nargs > 1) {
+        PyErr_SetString(PyExc_TypeError, "save_state() takes at most one argument");
+        return nullptr;
+    }
+    if (!emulator_ready(self)) {
+        return nullptr;
+    }
+
+    if (nargs == 1 && args[0] != Py_None) {
+        Py_buffer buf;
+        if (PyObject_GetBuffer(args[0], &buf, PyBUF_SIMPLE | PyBUF_WRITABLE) < 0) {
+            return nullptr;
+        }
+        int rc = cb_save_state(self->gb, buf.buf, buf.len);
+        PyBuffer_Release(&buf);
+        if (py_check(rc) < 0) {
+            return nullptr;
+        }
+        Py_INCREF(args[0]);
+        return args[0];
+    }
+
+    PyObject *out = PyBytes_FromStringAndSize(nullptr, cb_state_size());
+    if (out && py_check(cb_save_state(self->gb, PyBytes_AS_STRING(out), cb_state_size())) < 0) {
+        Py_CLEAR(out);
+    }
+    return out;
+}
+
+static PyObject *emulator_load_state(emulator_object *self, PyObject *arg) {
+    Py_buffer data;
+    if (!emulator_ready(self) || PyObject_GetBuffer(arg, &data, PyBUF_SIMPLE) < 0) {
+        return nullptr;
+    }
+    int rc = cb_load_state(self->gb, data.buf, data.len);
+    PyBuffer_Release(&data);
+    if (py_check(rc) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// save_state_file(compress=False): state file as bytes, only as long as
+// the file is.
+static PyObject *emulator_save_state_file(emulator_object *self, PyObject *args, PyObject *kwds) {
+    static const char *keywords[] = {"compress", nullptr};
+    int compress = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p", (char **)keywords, &compress) || !emulator_ready(self)) {
+        return nullptr;
+    }
+    PyObject *out = PyBytes_FromStringAndSize(nullptr, cb_state_file_max_size());
+    if (!out) {
+        return nullptr;
+    }
+    int rc = cb_save_state_file(self->gb, PyBytes_AS_STRING(out), cb_state_file_max_size(),
+                                compress ? CB_STATE_FILE_COMPRESS : 0);
+    if (rc < 0) {
+        py_check(rc);
+        Py_DECREF(out);
+        return nullptr;
+    }
+    _PyBytes_Resize(&out, rc);
+    return out;
+}
+
+static PyObject *emulator_load_state_file(emulator_object *self, PyObject *arg) {
+    Py_buffer data;
+    if (!emulator_ready(self) || PyObject_GetBuffer(arg, &data, PyBUF_SIMPLE) < 0) {
+        return nullptr;
+    }
+    int rc = cb_load_state_file(self->gb, data.buf, data.len);
+    PyBuffer_Release(&data);
+    if (py_check(rc) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_set_rewind(emulator_object *self, PyObject *arg) {
+    size_t bytes = PyLong_AsSize_t(arg);
+    if ((bytes == (size_t)-1 && PyErr_Occurred()) || !emulator_ready(self)) {
+        return nullptr;
+    }
+    if (py_check(cb_set_rewind(self->gb, bytes)) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_rewind(emulator_object *self, PyObject *const *args, Py_ssize_t nargs) {
+    unsigned long frames = 1;
+    if (nargs > 1) {
+        PyErr_SetString(PyExc_TypeError, "rewind() takes at most one argument");
+        return nullptr;
+    }
+    if (nargs == 1 && (frames = PyLong_AsUnsignedLong(args[0])) == (unsigned long)-1 && PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (!emulator_ready(self)) {
+        return nullptr;
+    }
+    int rc = cb_rewind(self->gb, (uint32_t)frames);
+    if (rc < 0 && py_check(rc) < 0) {
+        return nullptr;
+    }
+    return PyLong_FromLong(rc);
+}
+
+static PyObject *emulator_set_run_ahead(emulator_object *self, PyObject *arg) {
+    unsigned long frames = PyLong_AsUnsignedLong(arg);
+    if ((frames == (unsigned long)-1 && PyErr_Occurred()) || !emulator_ready(self)) {
+        return nullptr;
+    }
+    if (py_check(cb_set_run_ahead(self->gb, (uint32_t)frames)) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *emulator_memory(emulator_object *self, void *region) {
+    if (!emulator_ready(self)) {
+        return nullptr;
+    }
+    size_t size = 0;
+    uint8_t *mem = cb_memory(self->gb, (int)(intptr_t)region, &size);
+    Py_ssize_t shape[1] = {(Py_ssize_t)size};
+    return view_new((PyObject *)self, mem, false, "B", 1, 1, shape);
+}
+
+static PyObject *emulator_get_frame_count(emulator_object *self, void *) {
+    return PyLong_FromUnsignedLongLong(cb_frame_count(self->gb));
+}
+
+static PyObject *emulator_get_cycles(emulator_object *self, void *) {
+    return PyLong_FromUnsignedLongLong(cb_cycle_count(self->gb));
+}
+
+static PyObject *emulator_get_rewind_frames(emulator_object *self, void *) {
+    return PyLong_FromUnsignedLong(cb_rewind_frames(self->gb));
+}
+
+static PyMethodDef emulator_methods[] = {
+    {"load_rom", (PyCFunction)emulator_load_rom, METH_O,
+     "load_rom(rom): load from a path or a bytes-like image and reset."},
+    {"reset", (PyCFunction)emulator_reset, METH_NOARGS, "Back to the post-boot state."},
+    {"step", (PyCFunction)(void (*)(void))emulator_step, METH_FASTCALL,
+     "step(frames=1): run that many frames with the GIL released."},
+    {"set_input", (PyCFunction)emulator_set_input, METH_O, "set_input(buttons): BUTTON_* bits."},
+    {"frame", (PyCFunction)emulator_frame, METH_VARARGS,
+     "frame(format=FB_GRAY8): read-only View of the live framebuffer."},
+    {"save_state", (PyCFunction)(void (*)(void))emulator_save_state, METH_FASTCALL,
+     "save_state(buf=None): machine state as bytes, or written into a STATE_SIZE buffer."},
+    {"load_state", (PyCFunction)emulator_load_state, METH_O, "load_state(state): restore save_state() output."},
+    {"save_state_file", (PyCFunction)(void (*)(void))emulator_save_state_file, METH_VARARGS | METH_KEYWORDS,
+     "save_state_file(compress=False): state in the file format, as bytes."},
+    {"load_state_file", (PyCFunction)emulator_load_state_file, METH_O,
+     "load_state_file(data): restore a state file from any buffer, such as an mmap or a Pack item."},
+    {"set_rewind", (PyCFunction)emulator_set_rewind, METH_O,
+     "set_rewind(bytes): record every frame in a history of about that size, 0 for none."},
+    {"rewind", (PyCFunction)(void (*)(void))emulator_rewind, METH_FASTCALL,
+     "rewind(frames=1): go back in the history; returns the frames gone back."},
+    {"set_run_ahead", (PyCFunction)emulator_set_run_ahead, METH_O,
+     "set_run_ahead(frames): show the frame that many frames ahead after every step, 0 for off."},
+    {nullptr},
+};
+
+static PyGetSetDef emulator_getset[] = {
+    {"vram", (getter)emulator_memory, nullptr, "Writable View of 0x8000-0x9fff.", (void *)CB_MEM_VRAM},
+    {"wram", (getter)emulator_memory, nullptr, "Writable View of 0xc000-0xdfff.", (void *)CB_MEM_WRAM},
+    {"oam", (getter)emulator_memory, nullptr, "Writable View of 0xfe00-0xfe9f.", (void *)CB_MEM_OAM},
+    {"hram", (getter)emulator_memory, nullptr, "Writable View of 0xff80-0xfffe.", (void *)CB_MEM_HRAM},
+    {"frame_count", (getter)emulator_get_frame_count, nullptr, "Frames since reset.", nullptr},
+    {"cycles", (getter)emulator_get_cycles, nullptr, "T-cycles since reset.", nullptr},
+    {"rewind_frames", (getter)emulator_get_rewind_frames, nullptr, "Frames rewind() can go back.", nullptr},
+    {nullptr},
+};
+
+// ---- Pool ----
+
+static int pool_load_file(void *pool, const char *path) {
+    return cb_pool_load_rom_file((cb_pool_t *)pool, path);
+}
+
+static int pool_load_data(void *pool, const uint8_t *data, size_t size) {
+    return cb_pool_load_rom((cb_pool_t *)pool, data, size);
+}
+
+static int pool_init(pool_object *self, PyObject *args, PyObject *kwds) {
+    static const char *keywords[] = {"n", "rom", "workers", nullptr};
+    unsigned int n, workers = 0;
+    PyObject *rom = nullptr;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|OI", (char **)keywords, &n, &rom, &workers)) {
+        return -1;
+    }
+    if (self->pool) {
+        PyErr_SetString(PyExc_TypeError, "Pool cannot be re-initialized");
+        return -1;
+    }
+    if (n == 0) {
+        PyErr_SetString(PyExc_ValueError, "a pool needs at least one instance");
+        return -1;
+    }
+    if (!(self->pool = cb_pool_create(n, workers))) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (rom && rom != Py_None) {
+        return load_rom_arg(rom, pool_load_file, pool_load_data, self->pool);
+    }
+    return 0;
+}
+
+static void pool_dealloc(pool_object *self) {
+    cb_pool_destroy(self->pool);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static bool pool_ready(pool_object *self) {
+    if (!self->pool) {
+        PyErr_SetString(PyExc_RuntimeError, "Pool.__init__ was not called");
+        return false;
+    }
+    return !py_busy(&self->busy);
+}
+
+static PyObject *pool_load_rom(pool_object *self, PyObject *rom) {
+    if (!pool_ready(self) || load_rom_arg(rom, pool_load_file, pool_load_data, self->pool) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// step(actions=None, frames=1). `actions` is any buffer of n bytes.
+static PyObject *pool_step(pool_object *self, PyObject *const *args, Py_ssize_t nargs) {
+    unsigned long frames = 1;
+    if (nargs > 2) {
+        PyErr_SetString(PyExc_TypeError, "step() takes at most two arguments");
+        return nullptr;
+    }
+    if (nargs == 2 && (frames = PyLong_AsUnsignedLong(args[1])) == (unsigned long)-1 && PyErr_Occurred()) {
+        return nullptr;
+    }
+    if (!pool_ready(self)) {
+        return nullptr;
+    }
+
+    Py_buffer actions = {};
+    if (nargs >= 1 && args[0] != Py_None) {
+        if (PyObject_GetBuffer(args[0], &actions, PyBUF_SIMPLE) < 0) {
+            return nullptr;
+        }
+        if (actions.len != (Py_ssize_t)cb_pool_size(self->pool)) {
+            PyBuffer_Release(&actions);
+            PyErr_SetString(PyExc_ValueError, "need one action byte per instance");
+            return nullptr;
+        }
+    }
+
+    int rc;
+    self->busy = true;
+    Py_BEGIN_ALLOW_THREADS
+    rc = cb_pool_step(self->pool, (const uint8_t *)actions.buf, (uint32_t)frames);
+    Py_END_ALLOW_THREADS
+    self->busy = false;
+
+    if (actions.obj) {
+        PyBuffer_Release(&actions);
+    }
+    if (py_check(rc) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// watch_ram(ranges, delta=False): addresses or (address, length) pairs.
+static PyObject *pool_watch_ram(pool_object *self, PyObject *args, PyObject *kwds) {
+    static const char *keywords[] = {"ranges", "delta", nullptr};
+    PyObject *arg;
+    int delta = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|p", (char **)keywords, &arg, &delta) || !pool_ready(self)) {
+        return nullptr;
+    }
+    if (self->ram_views) {
+        PyErr_SetString(PyExc_BufferError, "views of Pool.ram are still alive");
+        return nullptr;
+    }
+
+    PyObject *seq = PySequence_Fast(arg, "watch_ram() takes a sequence of ranges");
+    if (!seq) {
+        return nullptr;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(seq);
+    cb_range_t *ranges = (cb_range_t *)PyMem_Malloc((count ? count : 1) * sizeof(cb_range_t));
+    if (!ranges) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+        unsigned long addr, len = 1;
+        if (PyTuple_Check(item)) {
+            if (!PyArg_ParseTuple(item, "kk", &addr, &len)) {
+                addr = ~0ul;
+            }
+        }
+        else {
+            addr = PyLong_AsUnsignedLong(item);
+        }
+        if (addr > 0xffff || len > 0x10000 - addr) {
+            if (!PyErr_Occurred()) {
+                PyErr_SetString(PyExc_ValueError, "range outside the address space");
+            }
+            PyMem_Free(ranges);
+            Py_DECREF(seq);
+            return nullptr;
+        }
+        ranges[i].addr = (uint16_t)addr;
+        ranges[i].len = (uint16_t)len;
+    }
+    Py_DECREF(seq);
+
+    int rc = cb_pool_watch_ram(self->pool, ranges, (uint32_t)count, delta ? CB_WATCH_DELTA : 0);
+    PyMem_Free(ranges);
+    if (py_check(rc) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *pool_set_obs(pool_object *self, PyObject *args, PyObject *kwds) {
+    static const char *keywords[] = {"stack", "max_pool", nullptr};
+    unsigned int stack = 4;
+    int max_pool = 1;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Ip", (char **)keywords, &stack, &max_pool) || !pool_ready(self)) {
+        return nullptr;
+    }
+    if (self->obs_views) {
+        PyErr_SetString(PyExc_BufferError, "views of Pool.obs are still alive");
+        return nullptr;
+    }
+    if (py_check(cb_pool_set_obs(self->pool, stack, max_pool ? CB_OBS_MAX_POOL : 0)) < 0) {
+        return nullptr;
+    }
+    self->obs_stack = stack;
+    Py_RETURN_NONE;
+}
+
+static PyObject *pool_set_done(pool_object *self, PyObject *args) {
+    unsigned short addr;
+    unsigned char mask = 0xff, value = 0;
+    if (!PyArg_ParseTuple(args, "H|bb", &addr, &mask, &value) || !pool_ready(self)) {
+        return nullptr;
+    }
+    cb_pool_set_done_ram(self->pool, addr, mask, value);
+    Py_RETURN_NONE;
+}
+
+static PyObject *pool_set_episode_frames(pool_object *self, PyObject *arg) {
+    unsigned long frames = PyLong_AsUnsignedLong(arg);
+    if ((frames == (unsigned long)-1 && PyErr_Occurred()) || !pool_ready(self)) {
+        return nullptr;
+    }
+    cb_pool_set_episode_frames(self->pool, (uint32_t)frames);
+    Py_RETURN_NONE;
+}
+
+static PyObject *pool_set_reset_state(pool_object *self, PyObject *arg) {
+    if (!pool_ready(self)) {
+        return nullptr;
+    }
+    if (arg == Py_None) {
+        cb_pool_set_reset_state(self->pool, nullptr, 0);
+        Py_RETURN_NONE;
+    }
+
+    Py_buffer state;
+    if (PyObject_GetBuffer(arg, &state, PyBUF_SIMPLE) < 0) {
+        return nullptr;
+    }
+    int rc = cb_pool_set_reset_state(self->pool, state.buf, state.len);
+    PyBuffer_Release(&state);
+    if (py_check(rc) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *pool_get_done(pool_object *self, void *) {
+    if (!pool_ready(self)) {
+        return nullptr;
+    }
+    Py_ssize_t shape[1] = {(Py_ssize_t)cb_pool_size(self->pool)};
+    return view_new((PyObject *)self, cb_pool_done(self->pool), true, "B", 1, 1, shape);
+}
+
+static PyObject *pool_get_ram(pool_object *self, void *) {
+    if (!pool_ready(self)) {
+        return nullptr;
+    }
+    const uint8_t *ram = cb_pool_ram(self->pool);
+    if (!ram) {
+        PyErr_SetString(PyExc_RuntimeError, "nothing registered with watch_ram()");
+        return nullptr;
+    }
+    Py_ssize_t shape[2] = {cb_pool_ram_bytes(self->pool), cb_pool_size(self->pool)};
+    view_object *v = (view_object *)view_new((PyObject *)self, ram, true, "B", 1, 2, shape);
+    if (v) {
+        v->exports = &self->ram_views;
+        self->ram_views++;
+    }
+    return (PyObject *)v;
+}
+
+static PyObject *pool_frames(pool_object *self, PyObject *args) {
+    int format = CB_FB_GRAY8;
+    if (!PyArg_ParseTuple(args, "|i", &format) || !pool_ready(self)) {
+        return nullptr;
+    }
+    if (format < CB_FB_PACKED_2BPP || format > CB_FB_RGBA8888) {
+        PyErr_SetString(PyExc_ValueError, "unknown framebuffer format");
+        return nullptr;
+    }
+    return frame_view((PyObject *)self, cb_pool_framebuffer(self->pool, format), format,
+                      cb_pool_size(self->pool));
+}
+
+static Py_ssize_t pool_len(pool_object *self) {
+    return cb_pool_size(self->pool);
+}
+
+// Emulator sharing the pool's instance; the pool outlives it.
+static PyObject *pool_item(pool_object *self, Py_ssize_t i) {
+    if (!self->pool) {
+        PyErr_SetString(PyExc_RuntimeError, "Pool.__init__ was not called");
+        return nullptr;
+    }
+    if (i < 0 || i >= (Py_ssize_t)cb_pool_size(self->pool)) {
+        PyErr_SetString(PyExc_IndexError, "pool index out of range");
+        return nullptr;
+    }
+    emulator_object *e = (emulator_object *)emulator_type.tp_alloc(&emulator_type, 0);
+    if (!e) {
+        return nullptr;
+    }
+    e->gb = cb_pool_instance(self->pool, (uint32_t)i);
+    Py_INCREF(self);
+    e->pool = (PyObject *)self;
+    e->busy = &self->busy;
+    return (PyObject *)e;
+}
+
+static PyMethodDef pool_methods[] = {
+    {"load_rom", (PyCFunction)pool_load_rom, METH_O,
+     "load_rom(rom): load the same image into every instance."},
+    {"step", (PyCFunction)(void (*)(void))pool_step, METH_FASTCALL,
+     "step(actions=None, frames=1): set each instance's buttons from a buffer of n bytes,\n"
+     "run every instance that many frames with the GIL released and update frames(),\n"
+     "ram and done. Instances that were done start over first."},
+    {"watch_ram", (PyCFunction)(void (*)(void))pool_watch_ram, METH_VARARGS | METH_KEYWORDS,
+     "watch_ram(ranges, delta=False): addresses or (address, length) pairs whose bytes\n"
+     "are gathered into ram after every step, or their change since the last one."},
+    {"set_obs", (PyCFunction)(void (*)(void))pool_set_obs, METH_VARARGS | METH_KEYWORDS,
+     "set_obs(stack=4, max_pool=True): 84x84 gray frame stacks in obs after every step;\n"
+     "with max_pool each frame is the max of the last two. A stack of 0 turns it off."},
+    {"set_done", (PyCFunction)pool_set_done, METH_VARARGS,
+     "set_done(addr, mask=0xff, value=0): terminal when memory[addr] & mask == value."},
+    {"set_episode_frames", (PyCFunction)pool_set_episode_frames, METH_O,
+     "set_episode_frames(n): truncate episodes after n frames, 0 for no limit."},
+    {"set_reset_state", (PyCFunction)pool_set_reset_state, METH_O,
+     "set_reset_state(state): Emulator.save_state() output to reset to, None for power-on."},
+    {"frames", (PyCFunction)pool_frames, METH_VARARGS,
+     "frames(format=FB_GRAY8): read-only (N, 144, 160, ...) View of all framebuffers."},
+    {nullptr},
+};
+
+static PyObject *pool_get_obs(pool_object *self, void *) {
+    if (!pool_ready(self)) {
+        return nullptr;
+    }
+    const uint8_t *obs = cb_pool_obs(self->pool);
+    if (!obs) {
+        PyErr_SetString(PyExc_RuntimeError, "observation stage is off, see set_obs()");
+        return nullptr;
+    }
+    Py_ssize_t shape[4] = {cb_pool_size(self->pool), self->obs_stack, CB_OBS_HEIGHT, CB_OBS_WIDTH};
+    view_object *v = (view_object *)view_new((PyObject *)self, obs, true, "B", 1, 4, shape);
+    if (v) {
+        v->exports = &self->obs_views;
+        self->obs_views++;
+    }
+    return (PyObject *)v;
+}
+
+static PyGetSetDef pool_getset[] = {
+    {"done", (getter)pool_get_done, nullptr, "(N,) View of DONE_* flags from the last step.", nullptr},
+    {"obs", (getter)pool_get_obs, nullptr,
+     "(N, stack, 84, 84) View of the observation stacks, oldest frame first.", nullptr},
+    {"ram", (getter)pool_get_ram, nullptr, "(K, N) View of the K watched bytes of every instance after the last step.", nullptr},
+    {nullptr},
+};
+
+static PySequenceMethods pool_as_sequence = {
+    (lenfunc)pool_len,
+    nullptr,
+    nullptr,
+    (ssizeargfunc)pool_item,
+};
+
+// ---- Pack ----
+
+static int pack_init(pack_object *self, PyObject *args, PyObject *kwds) {
+    static const char *keywords[] = {"path", nullptr};
+    PyObject *path;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O&", (char **)keywords, PyUnicode_FSConverter, &path)) {
+        return -1;
+    }
+    if (self->views) {
+        PyErr_SetString(PyExc_BufferError, "views of the Pack are still alive");
+        Py_DECREF(path);
+        return -1;
+    }
+    cb_pack_close(self->pack);
+    self->pack = nullptr;
+    Py_BEGIN_ALLOW_THREADS
+    self->pack = cb_pack_open(PyBytes_AS_STRING(path));
+    Py_END_ALLOW_THREADS
+    if (!self->pack) {
+        PyErr_Format(PyExc_OSError, "cannot read pack file %s", PyBytes_AS_STRING(path));
+    }
+    Py_DECREF(path);
+    return self->pack ? 0 : -1;
+}
+
+static void pack_dealloc(pack_object *self) {
+    cb_pack_close(self->pack);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static Py_ssize_t pack_len(pack_object *self) {
+    return (Py_ssize_t)cb_pack_count(self->pack);
+}
+
+// Read-only View of state file i inside the mapping; the pack outlives it.
+static PyObject *pack_item(pack_object *self, Py_ssize_t i) {
+    if (i < 0 || i >= (Py_ssize_t)cb_pack_count(self->pack)) {
+        PyErr_SetString(PyExc_IndexError, "pack index out of range");
+        return nullptr;
+    }
+    size_t size;
+    const void *state = cb_pack_state(self->pack, (uint64_t)i, &size);
+    if (!state) {
+        PyErr_SetString(PyExc_ValueError, "pack entry out of bounds");
+        return nullptr;
+    }
+    Py_ssize_t shape[1] = {(Py_ssize_t)size};
+    view_object *v = (view_object *)view_new((PyObject *)self, state, true, "B", 1, 1, shape);
+    if (v) {
+        v->exports = &self->views;
+        self->views++;
+    }
+    return (PyObject *)v;
+}
+
+static PySequenceMethods pack_as_sequence = {
+    (lenfunc)pack_len,
+    nullptr,
+    nullptr,
+    (ssizeargfunc)pack_item,
+};
+
+// write_pack(path, states): pack an iterable of state files.
+static PyObject *module_write_pack(PyObject *, PyObject *args) {
+    PyObject *path, *states;
+    if (!PyArg_ParseTuple(args, "O&O", PyUnicode_FSConverter, &path, &states)) {
+        return nullptr;
+    }
+    PyObject *it = PyObject_GetIter(states);
+    if (!it) {
+        Py_DECREF(path);
+        return nullptr;
+    }
+    cb_pack_writer_t *w = cb_pack_create(PyBytes_AS_STRING(path));
+    if (!w) {
+        PyErr_Format(PyExc_OSError, "cannot write pack file %s", PyBytes_AS_STRING(path));
+        Py_DECREF(it);
+        Py_DECREF(path);
+        return nullptr;
+    }
+
+    int rc = CB_OK;
+    PyObject *item;
+    while (rc == CB_OK && (item = PyIter_Next(it))) {
+        Py_buffer data;
+        if (PyObject_GetBuffer(item, &data, PyBUF_SIMPLE) < 0) {
+            rc = CB_ERR_ARG;
+        }
+        else {
+            rc = cb_pack_add(w, data.buf, data.len);
+            PyBuffer_Release(&data);
+        }
+        Py_DECREF(item);
+    }
+    Py_DECREF(it);
+    Py_DECREF(path);
+
+    int finished = cb_pack_finish(w);
+    if (PyErr_Occurred() || py_check(rc != CB_OK ? rc : finished) < 0) {
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef module_methods[] = {
+    {"write_pack", module_write_pack, METH_VARARGS,
+     "write_pack(path, states): write state files (save_state_file() output) into a Pack file."},
+    {nullptr},
+};
+
+// ---- module ----
+
+static PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT,
+    "cudaboy",
+    "Game Boy emulator core with zero-copy views of frames and RAM.",
+    -1,
+    module_methods,
+};
+
+PyMODINIT_FUNC PyInit_cudaboy(void) {
+    view_type.tp_name = "cudaboy.View";
+    view_type.tp_doc = "Buffer over emulator memory; wrap with numpy.asarray() or memoryview().";
+    view_type.tp_basicsize = sizeof(view_object);
+    view_type.tp_flags = Py_TPFLAGS_DEFAULT;
+    view_type.tp_dealloc = (destructor)view_dealloc;
+    view_type.tp_as_buffer = &view_as_buffer;
+    view_type.tp_getset = view_getset;
+
+    emulator_type.tp_name = "cudaboy.Emulator";
+    emulator_type.tp_doc = "Emulator(rom=None): one Game Boy.";
+    emulator_type.tp_basicsize = sizeof(emulator_object);
+    emulator_type.tp_flags = Py_TPFLAGS_DEFAULT;
+    emulator_type.tp_new = PyType_GenericNew;
+    emulator_type.tp_init = (initproc)emulator_init;
+    emulator_type.tp_dealloc = (destructor)emulator_dealloc;
+    emulator_type.tp_methods = emulator_methods;
+    emulator_type.tp_getset = emulator_getset;
+
+    pool_type.tp_name = "cudaboy.Pool";
+    pool_type.tp_doc = "Pool(n, rom=None, workers=0): n Game Boys stepped together, a vectorized environment.";
+    pool_type.tp_basicsize = sizeof(pool_object);
+    pool_type.tp_flags = Py_TPFLAGS_DEFAULT;
+    pool_type.tp_new = PyType_GenericNew;
+    pool_type.tp_init = (initproc)pool_init;
+    pool_type.tp_dealloc = (destructor)pool_dealloc;
+    pool_type.tp_methods = pool_methods;
+    pool_type.tp_as_sequence = &pool_as_sequence;
+    pool_type.tp_getset = pool_getset;
+
+    pack_type.tp_name = "cudaboy.Pack";
+    pack_type.tp_doc = "Pack(path): the state files of a pack file, mapped read-only, as Views.";
+    pack_type.tp_basicsize = sizeof(pack_object);
+    pack_type.tp_flags = Py_TPFLAGS_DEFAULT;
+    pack_type.tp_new = PyType_GenericNew;
+    pack_type.tp_init = (initproc)pack_init;
+    pack_type.tp_dealloc = (destructor)pack_dealloc;
+    pack_type.tp_as_sequence = &pack_as_sequence;
+
+    if (PyType_Ready(&view_type) < 0 || PyType_Ready(&emulator_type) < 0 || PyType_Ready(&pool_type) < 0 ||
+        PyType_Ready(&pack_type) < 0) {
+        return nullptr;
+    }
+
+    PyObject *m = PyModule_Create(&module_def);
+    if (!m) {
+        return nullptr;
+    }
+
+    static const struct { const char *name; int value; } constants[] = {
+        {"API_VERSION", CB_API_VERSION},
+        {"BUTTON_RIGHT", CB_BUTTON_RIGHT}, {"BUTTON_LEFT", CB_BUTTON_LEFT},
+        {"BUTTON_UP", CB_BUTTON_UP}, {"BUTTON_DOWN", CB_BUTTON_DOWN},
+        {"BUTTON_A", CB_BUTTON_A}, {"BUTTON_B", CB_BUTTON_B},
+        {"BUTTON_SELECT", CB_BUTTON_SELECT}, {"BUTTON_START", CB_BUTTON_START},
+        {"FB_PACKED_2BPP", CB_FB_PACKED_2BPP}, {"FB_INDEXED8", CB_FB_INDEXED8},
+        {"FB_GRAY8", CB_FB_GRAY8}, {"FB_RGB565", CB_FB_RGB565}, {"FB_RGBA8888", CB_FB_RGBA8888},
+        {"DONE_TERMINAL", CB_DONE_TERMINAL}, {"DONE_TRUNCATED", CB_DONE_TRUNCATED},
+        {"DONE_STOPPED", CB_DONE_STOPPED},
+    };
+    for (const auto &c : constants) {
+        PyModule_AddIntConstant(m, c.name, c.value);
+    }
+    PyModule_AddIntConstant(m, "STATE_SIZE", (long)cb_state_size());
+
+    Py_INCREF(&view_type);
+    Py_INCREF(&emulator_type);
+    Py_INCREF(&pool_type);
+    Py_INCREF(&pack_type);
+    if (PyModule_AddObject(m, "View", (PyObject *)&view_type) < 0 ||
+        PyModule_AddObject(m, "Emulator", (PyObject *)&emulator_type) < 0 ||
+        PyModule_AddObject(m, "Pool", (PyObject *)&pool_type) < 0 ||
+        PyModule_AddObject(m, "Pack", (PyObject *)&pack_type) < 0) {
+        Py_DECREF(m);
+        return nullptr;
+    }
+    return m;
+}
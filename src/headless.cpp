@@ -0,0 +1,182 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../gameboy/LR35902.hpp"
+#include "../gameboy/mcycle.hpp"
+#include "../gameboy/rom.hpp"
+
+// Runs ROMs without a display or SDL and reports throughput. For node
+// benchmarks and containers; the SDL frontend is src/main.cpp.
+
+typedef std::chrono::steady_clock Clock;
+
+struct run_result_t {
+    uint64_t cycles;
+    uint64_t frames;
+    uint64_t instructions;
+    double seconds;
+};
+
+static uint64_t fnv1a(const uint8_t *data, size_t len, uint64_t h = 0xcbf29ce484222325ull) {
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+// The palette-index framebuffer of the last frame.
+static uint64_t frame_hash(state_t &s) {
+    return fnv1a(s.lcd.vram, sizeof(s.lcd.vram));
+}
+
+// WRAM (all banks in CGB mode) and HRAM.
+static uint64_t ram_hash(state_t &s) {
+    uint64_t h = fnv1a(&s.mem[0xc000], 0x2000);
+    if (s.cgb.enabled) {
+        h = fnv1a(&s.cgb.wram[0][0], sizeof(s.cgb.wram), h);
+    }
+    return fnv1a(&s.mem[0xff80], 0x7f, h);
+}
+
+// Stops after `frames` V-Blanks, or at `cycles` when frames is 0. The
+// M-cycle core runs a scanline at a time between the checks, so it may go
+// up to one line past either.
+template <typename ppu>
+static run_result_t run(state_t &s, uint64_t frames, uint64_t cycles, bool mcycle) {
+    run_result_t r = {};
+    uint64_t start_frame = s.lcd.frame;
+    uint64_t start_cycles = s.cycles;
+    uint64_t start_inst = s.num_inst;
+
+    mc_core_t core;
+    if (mcycle) {
+        mc_init<ppu>(core, s);
+    }
+
+    auto t0 = Clock::now();
+    while (!s.stop) {
+        if (frames ? s.lcd.frame - start_frame >= frames : s.cycles - start_cycles >= cycles) {
+            break;
+        }
+        if (mcycle) {
+            mc_run_until(core, s.cycles + (456 << s.clock_shift));
+        }
+        else {
+            step<ppu>(s);
+        }
+    }
+    if (mcycle) {
+        mc_destroy(core);
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    r.cycles = s.cycles - start_cycles;
+    r.frames = s.lcd.frame - start_frame;
+    r.instructions = s.num_inst - start_inst;
+    return r;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+        "usage: %s [--frames N | --cycles N] [--accurate] [--mcycle] [--serial] rom...\n"
+        "  --frames N   run N frames per ROM (default 600)\n"
+        "  --cycles N   run N CPU clocks per ROM instead\n"
+        "  --accurate   pixel FIFO PPU (DMG cartridges only)\n"
+        "  --mcycle     coroutine M-cycle core (gameboy/mcycle.hpp)\n"
+        "  --serial     copy serial output to stdout\n", name);
+}
+
+int main(int argc, const char *argv[])
+{
+    uint64_t frames = 600;
+    uint64_t cycles = 0;
+    bool accurate = false;
+    bool mcycle = false;
+    bool serial = false;
+    int roms = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtoull(argv[++i], nullptr, 0);
+            cycles = 0;
+        }
+        else if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+            cycles = strtoull(argv[++i], nullptr, 0);
+            frames = 0;
+        }
+        else if (strcmp(argv[i], "--accurate") == 0) {
+            accurate = true;
+        }
+        else if (strcmp(argv[i], "--mcycle") == 0) {
+            mcycle = true;
+        }
+        else if (strcmp(argv[i], "--serial") == 0) {
+            serial = true;
+        }
+        else if (strncmp(argv[i], "--", 2) == 0) {
+            usage(argv[0]);
+            return 2;
+        }
+        else {
+            roms++;
+        }
+    }
+    if (roms == 0 || (frames == 0 && cycles == 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) == 0) {
+            if (strcmp(argv[i], "--frames") == 0 || strcmp(argv[i], "--cycles") == 0) {
+                i++;
+            }
+            continue;
+        }
+
+        uint8_t *rom;
+        if (load_rom(&rom, argv[i], false) != 0) {
+            fprintf(stderr, "%s: not a readable ROM\n", argv[i]);
+            failed++;
+            continue;
+        }
+        state_t *s;
+        initialize_state(s, rom);
+
+        serial_device_t out;
+        if (serial) {
+            serial_file_device(out, stdout);
+            serial_attach(*s, &out);
+        }
+
+        // the FIFO renderer only draws DMG frames
+        bool fifo = accurate && !s->cgb.enabled;
+        if (accurate && !fifo) {
+            fprintf(stderr, "%s: --accurate is DMG only, using the fast PPU\n", argv[i]);
+        }
+
+        run_result_t r = fifo ? run<ppu_fifo>(*s, frames, cycles, mcycle) : run<ppu_fast>(*s, frames, cycles, mcycle);
+        if (serial) {
+            fflush(stdout);
+        }
+
+        // emulated MHz in DMG clocks, so double speed doesn't count twice
+        double mhz = (r.cycles >> s->clock_shift) / r.seconds / 1e6;
+        printf("%s: %llu frames, %llu cycles in %.3f s, %.2f MHz (%.1fx), %.1f fps, %.2f M inst/s, "
+               "frame %016llx, ram %016llx\n",
+               argv[i], (unsigned long long)r.frames, (unsigned long long)r.cycles, r.seconds,
+               mhz, mhz / 4.194304, r.frames / r.seconds, r.instructions / r.seconds / 1e6,
+               (unsigned long long)frame_hash(*s), (unsigned long long)ram_hash(*s));
+
+        if (s->fault) {
+            print_fault(*s);
+            failed++;
+        }
+        free(s->mem);
+        free(s);
+        free(rom);
+    }
+    return failed ? 1 : 0;
+}
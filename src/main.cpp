@@ -4,10 +4,49 @@
 #include "views.hpp"
 
 #include "../gameboy/LR35902.hpp"
+#include "../gameboy/mcycle.hpp"
+#include "../gameboy/rewind.hpp"
 #include "../gameboy/rom.hpp"
+#include "../gameboy/runahead.hpp"
 
 typedef std::chrono::high_resolution_clock Clock;
 
+#define GB_AUDIO_FRAMES 8192
+
+static apu_ring_t gb_audio;
+static int16_t gb_audio_buf[GB_AUDIO_FRAMES * 2];
+
+static joy_queue_t gb_input;
+
+// a few KB a frame, minutes to hours of play depending on the game
+#define GB_REWIND_BYTES (64 << 20)
+
+static rewind_t gb_rewind;
+static uint8_t gb_ahead[snapshot_size()];
+
+static uint8_t key_to_button(SDL_Keycode key) {
+    switch (key)
+    {
+        case SDLK_RIGHT:     return joy::RIGHT;
+        case SDLK_LEFT:      return joy::LEFT;
+        case SDLK_UP:        return joy::UP;
+        case SDLK_DOWN:      return joy::DOWN;
+        case SDLK_z:         return joy::A;
+        case SDLK_x:         return joy::B;
+        case SDLK_BACKSPACE: return joy::SELECT;
+        case SDLK_RETURN:    return joy::START;
+        default:             return 0;
+    }
+}
+
+static void audio_callback(void *userdata, Uint8 *stream, int len) {
+    int16_t *out = (int16_t *)stream;
+    uint32_t frames = len / 4;
+    uint32_t got = apu_ring_pop(gb_audio, out, frames);
+
+    memset(out + got * 2, 0, (frames - got) * 4);
+}
+
 
 
 int main(int argc, const char* argv[])
@@ -28,12 +67,114 @@ int main(int argc, const char* argv[])
     auto prevTime = Clock::now();
     auto prevTicks = SDL_GetTicks();
 
+    // the first argument that isn't a flag is the ROM
+    const char *rom_path = ROM_DEFAULT_PATH;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0) {
+            rom_path = argv[i];
+            break;
+        }
+    }
+
     uint8_t *rom;
-    load_rom(&rom);
+    if (load_rom(&rom, rom_path) != 0) {
+        return 1;
+    }
     state_t *gb_state;
     initialize_state(gb_state, rom);
     std::cout << "rom size " << gb_state->rom_size << "\n";
 
+    // the core converts every finished line straight into the texture format
+    static uint32_t gb_screen[GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT];
+    lcd_output_attach(*gb_state, gb_screen, fb::RGBA8888);
+    uint64_t shown_frame = 0;
+
+    bool accurate = false;
+    bool mcycle = false;
+    bool audio = false;
+    bool rewind = false;
+    uint32_t run_ahead = 0;
+    for (int i = 1; i < argc; i++) {
+        // render on a worker thread one frame behind the emulation
+        if (strcmp(argv[i], "--pipelined") == 0) {
+            lcd_pipeline_start(*gb_state);
+        }
+        // pixel FIFO PPU for games that need mid-scanline timing
+        if (strcmp(argv[i], "--accurate") == 0) {
+            accurate = true;
+        }
+        // coroutine core with M-cycle accurate memory accesses
+        if (strcmp(argv[i], "--mcycle") == 0) {
+            mcycle = true;
+        }
+        // sound output; without it the APU only keeps its registers up to date
+        if (strcmp(argv[i], "--audio") == 0) {
+            audio = true;
+        }
+        // record every frame; hold R to go back in time
+        if (strcmp(argv[i], "--rewind") == 0) {
+            rewind = true;
+        }
+        // show the frame 1 (or N) frames ahead of the emulation, which hides
+        // the input lag games have
+        if (strncmp(argv[i], "--run-ahead", 11) == 0) {
+            run_ahead = argv[i][11] == '=' ? atoi(argv[i] + 12) : 1;
+        }
+    }
+    // the FIFO renderer doesn't know CGB banks, attributes or palettes
+    if (accurate && gb_state->cgb.enabled) {
+        std::cout << "--accurate is DMG only, using the fast PPU\n";
+        accurate = false;
+    }
+    // states are loaded at V-Blank, where the M-cycle core may be halfway
+    // through an instruction and the pipelined renderer a frame behind
+    if ((rewind || run_ahead) && (mcycle || gb_state->lcd.pipeline)) {
+        std::cout << "--rewind and --run-ahead don't work with --mcycle or --pipelined\n";
+        rewind = false;
+        run_ahead = 0;
+    }
+    if (rewind && !rewind_init(gb_rewind, malloc(rewind_mem_size(GB_REWIND_BYTES)), rewind_mem_size(GB_REWIND_BYTES))) {
+        rewind = false;
+    }
+    bool rewinding = false;
+
+    // keys go through the same queue scripted input would use, stamped 0 so
+    // they apply as soon as the core picks them up
+    uint8_t buttons = 0;
+    joypad_queue_init(gb_input);
+    joypad_attach(*gb_state, &gb_input);
+
+    // test ROMs report over the serial port
+    static serial_device_t gb_serial;
+    serial_file_device(gb_serial, stdout);
+    serial_attach(*gb_state, &gb_serial);
+
+    SDL_AudioDeviceID audio_dev = 0;
+    if (audio && SDL_InitSubSystem(SDL_INIT_AUDIO) == 0) {
+        SDL_AudioSpec want, have;
+        SDL_zero(want);
+        want.freq = 48000;
+        want.format = AUDIO_S16SYS;
+        want.channels = 2;
+        want.samples = 1024;
+        want.callback = audio_callback;
+
+        audio_dev = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+        if (audio_dev) {
+            apu_ring_init(gb_audio, gb_audio_buf, GB_AUDIO_FRAMES);
+            apu_output_attach(*gb_state, &gb_audio, have.freq);
+            SDL_PauseAudioDevice(audio_dev, 0);
+        }
+    }
+
+    mc_core_t core;
+    if (accurate) {
+        mc_init<ppu_fifo>(core, *gb_state);
+    }
+    else {
+        mc_init(core, *gb_state);
+    }
+
     uint8_t prev_lcd_mode = gb_state->lcd.mode;
     bool wait_refresh = false;
     while (!quit)
@@ -46,33 +187,98 @@ int main(int argc, const char* argv[])
         //     }
         // }
         if (!gb_state->stop && !wait_refresh) {
-            step(*gb_state);
+            if (mcycle) {
+                mc_run_until(core, gb_state->cycles + 4);
+            }
+            else if (accurate) {
+                step<ppu_fifo>(*gb_state);
+            }
+            else {
+                step(*gb_state);
+            }
         }
         if (gb_state->lcd.mode == 1 && prev_lcd_mode == 0) {
             wait_refresh = true;
+            if (rewind && !rewinding) {
+                rewind_push(gb_rewind, *gb_state);
+            }
         }
         prev_lcd_mode = gb_state->lcd.mode;
 
         auto currentTicks = SDL_GetTicks();
         if (currentTicks - prevTicks >= 16) {
-            SDL_PollEvent(&event);
-
-            switch (event.type)
-            {
-                case SDL_QUIT:
-                    quit = true;
-                    break;
+            while (SDL_PollEvent(&event)) {
+                switch (event.type)
+                {
+                    case SDL_QUIT:
+                        quit = true;
+                        break;
+                    case SDL_KEYDOWN:
+                    case SDL_KEYUP: {
+                        if (rewind && event.key.keysym.sym == SDLK_r) {
+                            rewinding = event.type == SDL_KEYDOWN;
+                            // the machine took back its buttons with the state
+                            joypad_push(gb_input, 0, false, buttons);
+                            break;
+                        }
+                        uint8_t button = key_to_button(event.key.keysym.sym);
+                        if (button && !event.key.repeat) {
+                            if (event.type == SDL_KEYDOWN) {
+                                buttons |= button;
+                            }
+                            else {
+                                buttons &= ~button;
+                            }
+                            joypad_push(gb_input, 0, false, buttons);
+                        }
+                        break;
+                    }
+                }
             }
 
 
-            update_screen_view(gb_view, *gb_state);
+            if (rewinding && rewind_step(gb_rewind, *gb_state, 1) > 0) {
+                lcd_output_redraw(*gb_state);
+                update_screen_view(gb_view, gb_screen);
+                shown_frame = gb_state->lcd.frame;
+            }
+            else if (run_ahead && wait_refresh && !rewinding) {
+                // with the keys just read; the future frame is always new
+                joypad_poll(*gb_state, gb_state->cycles);
+                runahead(*gb_state, gb_ahead, run_ahead, [accurate](state_t &s) {
+                    uint64_t end = s.lcd.frame + 1;
+                    while (s.lcd.frame < end && !s.stop) {
+                        if (accurate) {
+                            step<ppu_fifo>(s);
+                        }
+                        else {
+                            step(s);
+                        }
+                    }
+                });
+                update_screen_view(gb_view, gb_screen);
+                shown_frame = gb_state->lcd.frame;
+            }
+            else if (lcd_frame_changed_since(*gb_state, shown_frame)) {
+                update_screen_view(gb_view, gb_screen);
+                shown_frame = gb_state->lcd.frame;
+            }
             update_tilemap_view(tl_view, *gb_state);
             update_bg_view(bg_view, *gb_state);
             prevTicks = currentTicks;
-            wait_refresh = false;
+            wait_refresh = rewinding;
         }
     }
 
+    print_fault(*gb_state);
+
+    if (audio_dev) {
+        SDL_CloseAudioDevice(audio_dev);
+        apu_output_detach(*gb_state);
+    }
+    mc_destroy(core);
+    lcd_pipeline_stop(*gb_state);
+
     SDL_DestroyRenderer(gb_view.renderer);
     SDL_DestroyRenderer(tl_view.renderer);
     SDL_DestroyWindow(gb_view.window);
@@ -1,6 +1,8 @@
 
 #include "views.hpp"
 
+#include <cmath>
+
 #include "../gameboy/mem.hpp"
 
 int create_view(debug_view_t &view, const char *title, unsigned width, unsigned height, unsigned scale)
@@ -12,48 +14,11 @@ int create_view(debug_view_t &view, const char *title, unsigned width, unsigned
     view.texture = SDL_CreateTexture(view.renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, width, height);
 }
 
-int update_screen_view(debug_view_t &view, state_t &s)
+int update_screen_view(debug_view_t &view, const uint32_t *pixels)
 {
-    unsigned int gb0_vram[GB_SCREEN_HEIGHT * GB_SCREEN_WIDTH * 4];
-    uint8_t i = 0;
-
-    // for (int y = 0; y < GB_SCREEN_HEIGHT; ++y)
-    // {
-    //     i++;
-    //     uint32_t color = 0x00ff00ff;
-    //     ((uint8_t *)&color)[0] = i;
-    //     uint8_t j = 0;
-    //     for (int x = 0; x < GB_SCREEN_WIDTH; ++x)
-    //     {
-    //         ((uint8_t *)&color)[2] = j;
-    //         gb0_vram[x + (y * GB_SCREEN_WIDTH)] = color;
-    //         j++;
-    //     }
-    // }
-    
-    for (int y = 0; y < GB_SCREEN_HEIGHT; ++y)
-    {
-        for (int x = 0; x < GB_SCREEN_WIDTH; ++x)
-        {
-            uint32_t color;
-            uint8_t px_col = s.lcd.vram[x + (y * GB_SCREEN_WIDTH)];
-
-            if (px_col == 0b00)
-                color = 0xff46cbaf;
-            if (px_col == 0b01)
-                color = 0xff6daa79;
-            if (px_col == 0b10)
-                color = 0xff5f6f22;
-            if (px_col == 0b11)
-                color = 0xff552908;
-
-            gb0_vram[x + (y * GB_SCREEN_WIDTH)] = color;
-        }
-    }
-
     SDL_RenderClear(view.renderer);
 
-    SDL_UpdateTexture(view.texture, NULL, gb0_vram, GB_SCREEN_WIDTH * 4);
+    SDL_UpdateTexture(view.texture, NULL, pixels, GB_SCREEN_WIDTH * 4);
     SDL_RenderCopy(view.renderer, view.texture, NULL, NULL);
 
     SDL_RenderPresent(view.renderer);
@@ -26,6 +26,6 @@ struct debug_view_t {
 
 int create_view(debug_view_t &view, const char *title, unsigned width, unsigned height, unsigned scale);
 
-int update_screen_view(debug_view_t &view, state_t &s);
+int update_screen_view(debug_view_t &view, const uint32_t *pixels);
 int update_tilemap_view(debug_view_t &view, state_t &s);
 int update_bg_view(debug_view_t &view, state_t &s);
\ No newline at end of file
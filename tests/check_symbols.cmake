@@ -0,0 +1,23 @@
+# Fails if OBJECT needs a symbol other than those in ALLOWED.
+# cmake -DNM=<nm> -DOBJECT=<file.o> -DALLOWED=<a,b,...> -P check_symbols.cmake
+
+cmake_minimum_required(VERSION 3.15.0)
+string(REPLACE "," ";" ALLOWED "${ALLOWED}")
+
+execute_process(COMMAND ${NM} -u ${OBJECT} OUTPUT_VARIABLE out RESULT_VARIABLE rc)
+if (NOT rc EQUAL 0)
+  message(FATAL_ERROR "${NM} failed on ${OBJECT}")
+endif ()
+
+string(REGEX MATCHALL "[^ \t\n]+\n" lines "${out}")
+set(bad "")
+foreach (line ${lines})
+  string(STRIP "${line}" sym)
+  if (NOT sym STREQUAL "U" AND NOT sym IN_LIST ALLOWED)
+    list(APPEND bad ${sym})
+  endif ()
+endforeach ()
+
+if (bad)
+  message(FATAL_ERROR "undefined symbols: ${bad}")
+endif ()
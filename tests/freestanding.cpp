@@ -0,0 +1,72 @@
+// Kernel entry points over everything the freestanding core offers, built
+// with GB_FREESTANDING=1 into an object that is never linked. The
+// freestanding ctest fails if it needs any symbol from outside besides
+// memcpy, memmove and memset, which a device build provides.
+
+#include "../gameboy/LR35902.hpp"
+#include "../gameboy/obs.hpp"
+#include "../gameboy/rewind.hpp"
+#include "../gameboy/runahead.hpp"
+#include "../gameboy/snapshot.hpp"
+#include "../gameboy/state_file.hpp"
+#include "../gameboy/watch.hpp"
+
+#if !GB_FREESTANDING
+#error "build with GB_FREESTANDING=1"
+#endif
+
+static void run_frame(state_t &s) {
+    uint64_t frame = s.lcd.frame + 1;
+    while (s.lcd.frame < frame && !s.stop) {
+        step(s);
+    }
+}
+
+void kernel_init(state_t *states, uint8_t *mem, uint8_t *rom, uint32_t i) {
+    state_init(states[i], mem + (size_t)i * 0x10000, rom);
+}
+
+void kernel_run(state_t *states, uint32_t i, uint64_t cycles, void *fb) {
+    lcd_output_attach(states[i], fb, fb::RGBA8888);
+    run_until(states[i], states[i].cycles + cycles);
+    run_until<ppu_fifo>(states[i], states[i].cycles + cycles);
+    lcd_output_redraw(states[i]);
+}
+
+int kernel_snapshot(state_t *states, uint8_t *buf, uint32_t i) {
+    int rc = snapshot_save(states[i], buf, snapshot_size());
+    return rc | snapshot_load(states[i], buf, snapshot_size());
+}
+
+int kernel_state_file(state_t *states, uint8_t *buf, size_t size, uint32_t i) {
+    int n = state_file_write(states[i], buf, size, STATE_FILE_RLE);
+    size_t state_size = size;
+    const void *state = state_pack_check(buf, size) > 0 ? state_pack_get(buf, size, 0, &state_size) : buf;
+    return n + state_file_load(states[i], state, state_size);
+}
+
+int kernel_rewind(state_t *states, uint8_t *mem, size_t size, uint32_t i) {
+    rewind_t r;
+    if (!rewind_init(r, mem, size)) {
+        return -1;
+    }
+    rewind_push(r, states[i]);
+    run_frame(states[i]);
+    rewind_push(r, states[i]);
+    return rewind_step(r, states[i], 1);
+}
+
+void kernel_runahead(state_t *states, uint8_t *buf, uint32_t i) {
+    runahead(states[i], buf, 2, run_frame);
+}
+
+void kernel_env(state_t *states, const watch_range_t *segs, uint32_t nsegs, uint8_t *row, uint8_t *stack, uint32_t i) {
+    watch_copy(states[i], segs, nsegs, row);
+
+    obs_t o;
+    obs_init(o);
+    uint8_t gray[160 * 144], frame[OBS_SIZE];
+    obs_gray(states[i], gray);
+    obs_resize(o, gray, frame);
+    obs_push(stack, 4, frame, false);
+}
@@ -0,0 +1,72 @@
+// grid_run() leaves every instance exactly where running them one after
+// another with run_until() does. The instances start out of phase, and the
+// count leaves idle lanes in the last block.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../gameboy/LR35902.hpp"
+#include "../gameboy/grid.hpp"
+#include "../gameboy/snapshot.hpp"
+
+#define N 37
+
+static uint8_t rom[0x8000];
+
+// ld hl, $c000; loop: inc (hl); ld a, (hl); ldh (SCY), a; inc l; jr loop
+static const uint8_t program[] = {0x21, 0x00, 0xc0, 0x34, 0x7e, 0xe0, 0x42, 0x2c, 0x18, 0xf9};
+
+static state_t *machines(uint8_t *mem) {
+    state_t *states = (state_t *)malloc(N * sizeof(state_t));
+    for (uint32_t i = 0; i < N; i++) {
+        state_init(states[i], mem + (size_t)i * 0x10000, rom);
+        run_until(states[i], 977 * i);
+    }
+    return states;
+}
+
+int main() {
+    rom[0x100] = 0xc3;      // jp $0150
+    rom[0x101] = 0x50;
+    rom[0x102] = 0x01;
+    memcpy(rom + 0x150, program, sizeof(program));
+
+    uint8_t *mem = (uint8_t *)malloc((size_t)2 * N * 0x10000);
+    state_t *grid = machines(mem);
+    state_t *seq = machines(mem + (size_t)N * 0x10000);
+
+    grid_executor_t *e = grid_executor_create(4);
+    for (int i = 0; i < 3; i++) {
+        grid_run(*e, grid, N, 70224 * 5, 8);
+    }
+    grid_executor_destroy(e);
+    for (uint32_t i = 0; i < N; i++) {
+        for (int k = 0; k < 3; k++) {
+            run_until(seq[i], seq[i].cycles + 70224 * 5);
+        }
+    }
+
+    uint8_t *a = (uint8_t *)malloc(snapshot_size());
+    uint8_t *b = (uint8_t *)malloc(snapshot_size());
+    int failed = 0;
+    for (uint32_t i = 0; i < N; i++) {
+        snapshot_save(grid[i], a, snapshot_size());
+        snapshot_save(seq[i], b, snapshot_size());
+        if (memcmp(a, b, snapshot_size()) != 0) {
+            fprintf(stderr, "instance %u differs\n", i);
+            failed = 1;
+        }
+    }
+    if (grid[N - 1].mem[0xc000] == 0) {
+        fprintf(stderr, "the program did not run\n");
+        failed = 1;
+    }
+
+    free(b);
+    free(a);
+    free(seq);
+    free(grid);
+    free(mem);
+    return failed;
+}
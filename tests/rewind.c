@@ -0,0 +1,87 @@
+/* Rewinding lands on exactly the state each frame ended in, 300 frames
+ * back, and a history smaller than one state is rounded up rather than
+ * refused. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cudaboy.h"
+
+#define FRAMES 300
+
+/* ld hl, $c000; loop: ld a, $10; ldh (P1), a; ldh a, (P1); add (hl);
+ * ld (hl), a; inc l; jr loop */
+static const uint8_t program[] = {
+    0x21, 0x00, 0xc0, 0x3e, 0x10, 0xe0, 0x00, 0xf0, 0x00, 0x86, 0x77, 0x2c, 0x18, 0xf5,
+};
+
+int main(void) {
+    static uint8_t rom[0x8000];
+    rom[0x100] = 0xc3;      /* jp $0150 */
+    rom[0x101] = 0x50;
+    rom[0x102] = 0x01;
+    memcpy(rom + 0x150, program, sizeof(program));
+
+    cb_instance_t *gb = cb_create();
+    size_t size = cb_state_size();
+    uint8_t *states = malloc((FRAMES + 1) * size);
+    uint8_t *now = malloc(size);
+    if (!gb || !states || !now || cb_load_rom(gb, rom, sizeof(rom)) != CB_OK ||
+        cb_set_rewind(gb, 64 << 20) != CB_OK) {
+        fprintf(stderr, "setup failed\n");
+        return 1;
+    }
+
+    uint32_t noise = 2463534242u;
+    for (int i = 0; i <= FRAMES; i++) {
+        noise ^= noise << 13;
+        noise ^= noise >> 17;
+        noise ^= noise << 5;
+        cb_set_input(gb, (uint8_t)noise);
+        cb_run_frames(gb, 1);
+        cb_save_state(gb, states + (size_t)i * size, size);
+    }
+
+    int failed = 0;
+    if (cb_rewind_frames(gb) < FRAMES) {
+        fprintf(stderr, "history holds %u frames\n", cb_rewind_frames(gb));
+        failed = 1;
+    }
+
+    /* all the way back at once, forward again, then back a frame at a time */
+    int back = cb_rewind(gb, FRAMES);
+    cb_save_state(gb, now, size);
+    if (back != FRAMES || memcmp(now, states, size) != 0) {
+        fprintf(stderr, "%d frames back differs\n", back);
+        failed = 1;
+    }
+    cb_set_rewind(gb, 64 << 20);
+    cb_load_state(gb, states + (size_t)FRAMES * size, size);
+    noise = 1;
+    for (int i = 0; i <= FRAMES; i++) {
+        noise = noise * 1103515245u + 12345u;
+        cb_set_input(gb, (uint8_t)(noise >> 16));
+        cb_run_frames(gb, 1);
+        cb_save_state(gb, states + (size_t)i * size, size);
+    }
+    for (int i = FRAMES - 1; i >= 0; i--) {
+        int rc = cb_rewind(gb, 1);
+        cb_save_state(gb, now, size);
+        if (rc != 1 || memcmp(now, states + (size_t)i * size, size) != 0) {
+            fprintf(stderr, "frame %d differs going back one at a time\n", i);
+            failed = 1;
+            break;
+        }
+    }
+
+    if (cb_set_rewind(gb, 2000) != CB_OK || cb_run_frames(gb, 2) != CB_OK || cb_rewind(gb, 1) != 1) {
+        fprintf(stderr, "a 2000-byte history is unusable\n");
+        failed = 1;
+    }
+
+    free(now);
+    free(states);
+    cb_destroy(gb);
+    return failed;
+}
@@ -0,0 +1,148 @@
+// Damaged states are refused before they reach the machine, and whatever
+// does load can be run. Fields the core indexes or schedules with are set
+// out of range one at a time, then random bytes of whole files are
+// flipped; every load that succeeds is followed by a few frames.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "../gameboy/LR35902.hpp"
+#include "../gameboy/joypad.hpp"
+#include "../gameboy/state_file.hpp"
+
+#define FRAME_CYCLES 70224
+
+static uint8_t rom[0x8000];
+
+static state_t *machine() {
+    state_t *s;
+    initialize_state(s, rom);
+    return s;
+}
+
+static void destroy(state_t *s) {
+    free(s->mem);
+    free(s);
+}
+
+static void run_frames(state_t &s, int frames) {
+    run_until(s, s.cycles + (uint64_t)frames * FRAME_CYCLES);
+}
+
+struct bad_field_t {
+    const char *name;
+    size_t offset;
+    size_t size;
+    uint64_t value;
+};
+
+#define BAD(field, value) {#field, offsetof(state_t, field), sizeof(((state_t *)0)->field), value}
+
+static const bad_field_t bad_fields[] = {
+    BAD(lcd.bg_tilemap_addr, 0xff00),
+    BAD(lcd.bg_tiledata_addr, 0xa000),
+    BAD(lcd.mode, 7),
+    BAD(lcd.ly, 200),
+    BAD(lcd.line_start, 0),
+    BAD(lcd.fifo.bg_head, 16),
+    BAD(lcd.fifo.sprites[3], 200),
+    BAD(lcd.fifo.num_sprites, 11),
+    BAD(apu.ch[2].pos, 32),
+    BAD(sched.at[ev::LCD], 0),
+    BAD(cycles, ~0ull),
+    BAD(clock_shift, 2),
+    BAD(cpu_stall, 0xffffffff),
+    BAD(timer_bit, 40),
+    BAD(dma_copied, 161),
+    BAD(dma_src, 0xff80),
+    BAD(cgb.vram_bank, 2),
+    BAD(cgb.wram_bank, 0xff),
+    BAD(cgb.hdma_left, 0x81),
+};
+
+int main() {
+    rom[0x100] = 0x18;      // jr -2
+    rom[0x101] = 0xfe;
+    rom[0x143] = 0x80;      // CGB, for the banked fields
+
+    state_t *s = machine();
+    run_frames(*s, 200);
+    s->lcd.line_start = s->cycles;  // far enough from 0 to be out of range
+    s->cgb.wram_bank = 3;
+    mem_map_update(*s);
+
+    size_t max = state_file_max_size();
+    uint8_t *file = (uint8_t *)malloc(max);
+    uint8_t *before = (uint8_t *)malloc(snapshot_size());
+    uint8_t *after = (uint8_t *)malloc(snapshot_size());
+    uint8_t *image = (uint8_t *)malloc(snapshot_size());
+    state_t *bad = (state_t *)malloc(sizeof(state_t));
+    int failed = 0;
+
+    // each field out of range, in plain and compressed files and in a
+    // snapshot; the target is left as it was
+    snapshot_save(*s, before, snapshot_size());
+    for (const bad_field_t &f : bad_fields) {
+        memcpy(bad, s, sizeof(state_t));
+        memcpy((uint8_t *)bad + f.offset, &f.value, f.size);
+        for (int flags = 0; flags <= STATE_FILE_RLE; flags++) {
+            int n = state_file_write(*bad, file, max, flags);
+            int rc = state_file_load(*s, file, n);
+            snapshot_save(*s, after, snapshot_size());
+            if (rc == snap::OK || memcmp(before, after, snapshot_size()) != 0) {
+                fprintf(stderr, "%s = %llx in a state file (flags %d) was not refused\n", f.name,
+                        (unsigned long long)f.value, flags);
+                failed = 1;
+            }
+        }
+        snapshot_save(*bad, image, snapshot_size());
+        if (snapshot_load(*s, image, snapshot_size()) == snap::OK) {
+            fprintf(stderr, "%s = %llx in a snapshot was not refused\n", f.name, (unsigned long long)f.value);
+            failed = 1;
+        }
+    }
+
+    // a state saved with an input queue attached runs without one
+    static joy_queue_t queue;
+    joypad_queue_init(queue);
+    joypad_attach(*s, &queue);
+    int n = state_file_write(*s, file, max, 0);
+    joypad_detach(*s);
+    if (state_file_load(*s, file, n) != snap::OK) {
+        fprintf(stderr, "state with an input poll was refused\n");
+        failed = 1;
+    }
+    run_frames(*s, 2);
+
+    // random damage; whatever loads has to run
+    uint32_t noise = 2463534242u;
+    int loaded = 0;
+    for (int i = 0; i < 4000; i++) {
+        int flags = i & 1 ? STATE_FILE_RLE : 0;
+        int size = state_file_write(*s, file, max, flags);
+        for (int k = 0; k < 1 + (i >> 1) % 8; k++) {
+            noise ^= noise << 13;
+            noise ^= noise >> 17;
+            noise ^= noise << 5;
+            // plain files get it in the machine section, where most fields are
+            uint32_t at = flags ? noise % size : state_file_align(sizeof(state_file_header_t)) + noise % sizeof(state_t);
+            file[at] ^= (uint8_t)(noise >> 24) | 1;
+        }
+        state_t *t = machine();
+        if (state_file_load(*t, file, size) == snap::OK) {
+            run_frames(*t, 2);
+            loaded++;
+        }
+        destroy(t);
+    }
+    printf("%d of 4000 damaged files loaded and ran\n", loaded);
+
+    free(bad);
+    free(image);
+    free(after);
+    free(before);
+    free(file);
+    destroy(s);
+    return failed;
+}
@@ -0,0 +1,60 @@
+import json
+import os
+
+# Generates gameboy/timings.hpp from ops.json:
+#   python3 tools/gentimings.py > gameboy/timings.hpp
+
+__location__ = os.path.realpath(
+    os.path.join(os.getcwd(), os.path.dirname(__file__)))
+
+file = open(os.path.join(__location__, 'ops.json'))
+
+data = json.load(file)
+
+
+def access_masks(timing):
+    reads = 0
+    writes = 0
+    for m, step in enumerate(timing or []):
+        if step['Type'] == 'read':
+            reads |= 1 << m
+        elif step['Type'] == 'write':
+            writes |= 1 << m
+    return reads, writes
+
+
+def print_table(name, ops):
+    print(f"static GB_TABLE const inst_timing_t {name}[256] = {{")
+    for i, op in enumerate(ops):
+        no_branch = op.get('TimingNoBranch')
+        branch = op.get('TimingBranch') or no_branch
+        r, w = access_masks(no_branch)
+        rb, wb = access_masks(branch)
+        print(f"    {{{op['TCyclesNoBranch']:2}, {op['TCyclesBranch']:2}, "
+              f"0x{r:02x}, 0x{w:02x}, 0x{rb:02x}, 0x{wb:02x}}}, // 0x{i:02x} {op['Name']}")
+    print("};")
+
+
+print("#pragma once")
+print()
+print("#include <cstdint>")
+print('#include "config.hpp"')
+print()
+print("// Generated by tools/gentimings.py from tools/ops.json, do not edit.")
+print("//")
+print("// Per-opcode T-cycle cost with and without the branch taken, and which")
+print("// M-cycles touch memory: bit n of a mask is M-cycle n of the instruction,")
+print("// M-cycle 0 being the opcode fetch. CB entries include the 0xCB fetch.")
+print()
+print("struct inst_timing_t {")
+print("    uint8_t cycles;")
+print("    uint8_t cycles_branch;")
+print("    uint8_t reads;")
+print("    uint8_t writes;")
+print("    uint8_t reads_branch;")
+print("    uint8_t writes_branch;")
+print("};")
+print()
+print_table("inst_timings", data["Unprefixed"])
+print()
+print_table("cb_inst_timings", data["CBPrefixed"])